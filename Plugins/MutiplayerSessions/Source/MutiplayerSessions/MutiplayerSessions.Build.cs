@@ -28,6 +28,7 @@ public class MutiplayerSessions : ModuleRules
 				"Core",
 				"OnlineSubsystem",
 				"OnlineSubsystemSteam",
+				"OnlineSubsystemUtils",
 				"UMG",
 				"Slate",
 				"SlateCore"
@@ -43,6 +44,8 @@ public class MutiplayerSessions : ModuleRules
 				"Engine",
 				"Slate",
 				"SlateCore",
+				"Sockets",
+				"Networking",
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
@@ -4,20 +4,25 @@
 #include "Menu.h"
 #include "Components/Button.h"
 #include "MultiplayerSessionsSubsystem.h"
+#include "MultiplayerSessionsStats.h"
 #include "OnlineSessionSettings.h"
 #include "OnlineSubsystem.h"
-#include "Interfaces/OnlineSessionInterface.h" //EOnJoinSessionCompleteResult::Type νϴµ ʿ
-void UMenu::MenuSetup(int32 NumberOfPublicConnections, FString TypeOfMatch , FString LobbyPath)
+#include "Interfaces/OnlineSessionInterface.h" //EOnJoinSessionCompleteResult::Type 인식하는데 필요
+void UMenu::MenuSetup(int32 NumberOfPublicConnections, FString TypeOfMatch , FString LobbyPath, bool bProbeLatency, bool bJoinDedicatedServers, bool bIncludeLanSessions)
 {
 	PathToLobby = FString::Printf(TEXT("%s?listen"),*LobbyPath);
+	LobbyMapPath = LobbyPath;
 	NumPublicConnections = NumberOfPublicConnections;
 	MatchType = TypeOfMatch;
+	bProbeSessionLatency = bProbeLatency;
+	bSearchDedicatedServers = bJoinDedicatedServers;
+	bSearchLanSessions = bIncludeLanSessions;
 	AddToViewport();
-	//ü 
+	//가시성 설정
 	SetVisibility(ESlateVisibility::Visible);
 	bIsFocusable = true;
 
-	//Է¸ 
+	//입력모드 
 	UWorld* World = GetWorld();
 	if (World)
 	{
@@ -40,13 +45,12 @@ void UMenu::MenuSetup(int32 NumberOfPublicConnections, FString TypeOfMatch , FSt
 	}
 
 	// Bind Callback 
+	// 생성/검색/참가 완료는 호출할때 넘기는 콜백으로 받고, 검색 중에 들어오는 배치만 바인딩
 	if (MultiplayerSessionsSubsystem)
 	{
-		MultiplayerSessionsSubsystem->MultiplayerOnCreateSessionComplete.AddDynamic(this, &ThisClass::OnCreateSession);
-		MultiplayerSessionsSubsystem->MultiplayerOnFindSessionsComplete.AddUObject(this, &ThisClass::OnFindSession);
-		MultiplayerSessionsSubsystem->MultiplayerOnJoinSessionComplete.AddUObject(this, &ThisClass::OnJoinSession);
-		MultiplayerSessionsSubsystem->MultiplayerOnDestroySessionComplete.AddDynamic(this, &ThisClass::OnDestroySession);
-		MultiplayerSessionsSubsystem->MultiplayerOnStartSessionComplete.AddDynamic(this, &ThisClass::OnStartSession);
+		//MenuSetup 을 다시 불러도 바인딩이 쌓이지 않게
+		MultiplayerSessionsSubsystem->MultiplayerOnFindSessionsBatch.RemoveAll(this);
+		MultiplayerSessionsSubsystem->MultiplayerOnFindSessionsBatch.AddUObject(this, &ThisClass::OnFindSessionsBatch);
 	}
 }
 
@@ -71,7 +75,7 @@ bool UMenu::Initialize()
 
 void UMenu::NativeDestruct()
 {
-	//   ɶ ȣǴ Լ
+	//이 레벨에서 떠나고 삭제될때 호출되는 함수
 	MenuTearDown();
 
 	Super::NativeDestruct();
@@ -94,6 +98,7 @@ void UMenu::OnCreateSession(bool bWasSuccessful)
 		UWorld* World = GetWorld();
 		if (World)
 		{
+			FMultiplayerSessionsStats::Get().BeginTimer(EMultiplayerSessionTimer::Travel);
 			World->ServerTravel(PathToLobby);
 		}
 	}
@@ -109,73 +114,111 @@ void UMenu::OnCreateSession(bool bWasSuccessful)
 				FString(TEXT("Failed to created session!"))
 			);
 		}
+		FMultiplayerSessionsStats::Get().CancelTimer(EMultiplayerSessionTimer::TimeToLobby);
 		HostButton->SetIsEnabled(true);
 	}
 }
 
-void UMenu::OnFindSession(const TArray<FOnlineSessionSearchResult>& SessionResults, bool bWasSuccessful)
+void UMenu::OnFindSession(const TArray<FOnlineSessionSearchResult>& SessionResults, bool bWasSuccessful, EMultiplayerFindSessionsOutcome Outcome)
 {
-	if (MultiplayerSessionsSubsystem == nullptr)
+	//메뉴가 직접 취소하는건 세션을 골랐을 때뿐
+	if (MultiplayerSessionsSubsystem == nullptr || bJoinRequested || Outcome == EMultiplayerFindSessionsOutcome::Cancelled)
 	{
 		return;
 	}
-	for (auto Result : SessionResults)
+	//시간 초과여도 그때까지 온 결과 중에 맞는게 있으면 바로 참가
+	if (JoinFirstMatchingSession(SessionResults))
 	{
-		FString SettingsValue;
-		Result.Session.SessionSettings.Get(FName("MatchType"), SettingsValue);
-		if (SettingsValue == MatchType)
-		{
-			MultiplayerSessionsSubsystem->JoinSession(Result);
-			return;
-		}
+		return;
 	}
 
-	if (!bWasSuccessful || SessionResults.Num() == 0)
+	FMultiplayerSessionsStats::Get().CancelTimer(EMultiplayerSessionTimer::TimeToLobby);
+	JoinButton->SetIsEnabled(true);
+}
+
+void UMenu::OnFindSessionsBatch(TArrayView<const FOnlineSessionSearchResult> NewResults)
+{
+	if (MultiplayerSessionsSubsystem == nullptr || bJoinRequested)
 	{
-		JoinButton->SetIsEnabled(true);
+		return;
 	}
+	JoinFirstMatchingSession(NewResults);
 }
 
-void UMenu::OnJoinSession(EOnJoinSessionCompleteResult::Type Result)
+bool UMenu::JoinFirstMatchingSession(TArrayView<const FOnlineSessionSearchResult> SessionResults)
 {
-	//#include "OnlineSubsystem.h"
-	IOnlineSubsystem* Subsystem = IOnlineSubsystem::Get();
-	if (Subsystem)
+	//완료된 결과는 이미 걸러지고 정렬되어 있고, 스트리밍 배치는 여기서 확인
+	for (const FOnlineSessionSearchResult& Result : SessionResults)
 	{
-		IOnlineSessionPtr SessionInterface = Subsystem->GetSessionInterface();
-		if (SessionInterface.IsValid())
+		if (MultiplayerSessionsSubsystem->PassesSearchFilter(Result))
 		{
-			FString Address;
-			SessionInterface->GetResolvedConnectString(NAME_GameSession, Address);
-
-			APlayerController* PlayerController = GetGameInstance()->GetFirstLocalPlayerController();
-			if (PlayerController)
-			{
-				PlayerController->ClientTravel(Address, ETravelType::TRAVEL_Absolute);
-			}
+			bJoinRequested = true;
+			MultiplayerSessionsSubsystem->CancelFindSession();
+			JoinSessionHandle = MultiplayerSessionsSubsystem->JoinSessionAsync(Result, [WeakThis = TWeakObjectPtr<UMenu>(this)](EOnJoinSessionCompleteResult::Type JoinResult)
+				{
+					if (UMenu* Menu = WeakThis.Get())
+					{
+						Menu->OnJoinSession(JoinResult);
+					}
+				});
+			return true;
 		}
 	}
+	return false;
+}
 
+void UMenu::OnJoinSession(EOnJoinSessionCompleteResult::Type Result)
+{
 	if (Result != EOnJoinSessionCompleteResult::Success)
 	{
+		bJoinRequested = false;
+		//검색 결과가 오래돼서 생기는 실패는 해당 세션이 캐시에서 빠졌으니 다시 찾으면 다음 세션이 나옴
+		const bool bStaleResult = Result == EOnJoinSessionCompleteResult::SessionIsFull || Result == EOnJoinSessionCompleteResult::SessionDoesNotExist;
+		if (bStaleResult && NumJoinRetries < MaxJoinRetries && MultiplayerSessionsSubsystem)
+		{
+			++NumJoinRetries;
+			StartSessionSearch();
+			return;
+		}
+		FMultiplayerSessionsStats::Get().CancelTimer(EMultiplayerSessionTimer::TimeToLobby);
 		JoinButton->SetIsEnabled(true);
+		return;
 	}
-}
 
-void UMenu::OnDestroySession(bool bWasSuccessful)
-{
-}
+	//LAN 호스트에 참가했으면 백엔드 세션이 없으니 서브시스템에서 주소를 받음
+	if (MultiplayerSessionsSubsystem)
+	{
+		FString Address;
+		const double ResolveStartSeconds = FPlatformTime::Seconds();
+		MultiplayerSessionsSubsystem->GetResolvedConnectString(Address);
+		FMultiplayerSessionsStats::Get().AddSample(EMultiplayerSessionTimer::ResolveConnectString, (FPlatformTime::Seconds() - ResolveStartSeconds) * 1000.0);
 
-void UMenu::OnStartSession(bool bWasSuccessful)
-{
+		APlayerController* PlayerController = GetGameInstance()->GetFirstLocalPlayerController();
+		if (PlayerController)
+		{
+			FMultiplayerSessionsStats::Get().BeginTimer(EMultiplayerSessionTimer::Travel);
+			PlayerController->ClientTravel(Address, ETravelType::TRAVEL_Absolute);
+		}
+	}
 }
 
 void UMenu::HostButtonClicked()
 {
 	HostButton->SetIsEnabled(false);
+	//클릭부터 로비 맵 로드 완료까지가 Time-to-lobby
+	FMultiplayerSessionsStats::Get().BeginTimer(EMultiplayerSessionTimer::TimeToLobby);
 	if (MultiplayerSessionsSubsystem)
 	{
-		MultiplayerSessionsSubsystem->CreateSession(NumPublicConnections, MatchType);
+		//세션이 만들어지는 동안 로비 맵을 미리 읽어둠
+		MultiplayerSessionsSubsystem->SetAdvertisedMapPath(LobbyMapPath);
+		MultiplayerSessionsSubsystem->PrewarmTravelMap(LobbyMapPath);
+		CreateSessionHandle = MultiplayerSessionsSubsystem->CreateSessionAsync(NumPublicConnections, MatchType, [WeakThis = TWeakObjectPtr<UMenu>(this)](bool bWasSuccessful)
+			{
+				if (UMenu* Menu = WeakThis.Get())
+				{
+					Menu->OnCreateSession(bWasSuccessful);
+				}
+			});
 		
 	}
 	
@@ -184,18 +227,46 @@ void UMenu::HostButtonClicked()
 void UMenu::JoinButtonClicked()
 {
 	JoinButton->SetIsEnabled(false);
+	bJoinRequested = false;
+	NumJoinRetries = 0;
+	FMultiplayerSessionsStats::Get().BeginTimer(EMultiplayerSessionTimer::TimeToLobby);
 	if (MultiplayerSessionsSubsystem)
 	{
-		MultiplayerSessionsSubsystem->FindSession(10000);
-
+		StartSessionSearch();
 	}
 }
 
+void UMenu::StartSessionSearch()
+{
+	FMultiplayerSessionSearchParams SearchParams;
+	SearchParams.MatchType = MatchType;
+	SearchParams.bProbeLatency = bProbeSessionLatency;
+	SearchParams.bSearchDedicatedServers = bSearchDedicatedServers;
+	SearchParams.bIncludeLan = bSearchLanSessions;
+	//핑을 재서 고를때는 전체 후보가 필요하니 스트리밍으로 먼저 들어가지 않음
+	FindSessionsHandle = MultiplayerSessionsSubsystem->FindSessionsAsync(SearchParams, [WeakThis = TWeakObjectPtr<UMenu>(this)](const TArray<FOnlineSessionSearchResult>& SessionResults, bool bWasSuccessful, EMultiplayerFindSessionsOutcome Outcome)
+		{
+			if (UMenu* Menu = WeakThis.Get())
+			{
+				Menu->OnFindSession(SessionResults, bWasSuccessful, Outcome);
+			}
+		}, !bProbeSessionLatency);
+}
+
 void UMenu::MenuTearDown()
 {
-	// MenuSetup  ǲ  ʱȭ
+	// MenuSetup에서 설정한 인풋을 막은것을 초기화
+
+	//메뉴가 없어진 뒤에 끝나는 호출은 알릴 곳이 없으니 정리
+	if (MultiplayerSessionsSubsystem)
+	{
+		MultiplayerSessionsSubsystem->MultiplayerOnFindSessionsBatch.RemoveAll(this);
+		MultiplayerSessionsSubsystem->CancelSessionOp(CreateSessionHandle);
+		MultiplayerSessionsSubsystem->CancelSessionOp(FindSessionsHandle);
+		MultiplayerSessionsSubsystem->CancelSessionOp(JoinSessionHandle);
+	}
 
-	//UI ȭ鿡 ϴ Լ
+	//UI위젯을 화면에서 제거하는 함수
 	RemoveFromParent();
 
 	UWorld* World = GetWorld();
@@ -204,7 +275,7 @@ void UMenu::MenuTearDown()
 		APlayerController* PlayerController = World->GetFirstPlayerController();
 		if (PlayerController)
 		{
-			// FInputModeUIOnly µ ⼭ GameOnly
+			//위에서는 FInputModeUIOnly 였는데 여기서는 GameOnly
 			FInputModeGameOnly InputModeData;
 			PlayerController->SetInputMode(InputModeData);
 			PlayerController->SetShowMouseCursor(false);
@@ -0,0 +1,628 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MultiplayerFakeOnlineSession.h"
+#include "MultiplayerSessionNames.h"
+#include "MultiplayerSessionsSubsystem.h"
+#include "MutiplayerSessions.h"
+#include "OnlineSubsystemTypes.h"
+#include "Online/OnlineSessionNames.h"
+
+namespace MultiplayerFakeSession
+{
+	static const FName NetIdType(TEXT("MultiplayerFake"));
+
+	class FSessionInfo : public FOnlineSessionInfo
+	{
+	public:
+		FSessionInfo(const FString& InSessionId, const FString& InHostAddress)
+			: SessionId(FUniqueNetIdString::Create(InSessionId, NetIdType))
+			, HostAddress(InHostAddress)
+		{
+		}
+
+		virtual const uint8* GetBytes() const override { return nullptr; }
+		virtual int32 GetSize() const override { return sizeof(FSessionInfo); }
+		virtual bool IsValid() const override { return true; }
+		virtual const FUniqueNetId& GetSessionId() const override { return *SessionId; }
+		virtual FString ToString() const override { return SessionId->ToString(); }
+		virtual FString ToDebugString() const override { return FString::Printf(TEXT("%s @ %s"), *SessionId->ToString(), *HostAddress); }
+
+		FUniqueNetIdRef SessionId;
+		FString HostAddress;
+		// 참가한 세션이면 나갈때 광고중인 세션의 빈자리를 돌려줌
+		FString JoinedAdvertisedId;
+	};
+
+	static const FSessionInfo* GetInfo(const FOnlineSession& Session)
+	{
+		return static_cast<const FSessionInfo*>(Session.SessionInfo.Get());
+	}
+}
+
+FMultiplayerFakeOnlineSession::FMultiplayerFakeOnlineSession(const FMultiplayerFakeSessionConfig& InConfig)
+	: Config(InConfig)
+	, Random(InConfig.Seed)
+	, FakeLocalUserId(FUniqueNetIdString::Create(TEXT("FakeLocalUser"), MultiplayerFakeSession::NetIdType))
+{
+	PopulateAdvertisedSessions();
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FMultiplayerFakeOnlineSession::Tick));
+}
+
+FMultiplayerFakeOnlineSession::~FMultiplayerFakeOnlineSession()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+}
+
+void FMultiplayerFakeOnlineSession::PopulateAdvertisedSessions()
+{
+	AdvertisedSessions.Reset(Config.NumAdvertisedSessions);
+	for (int32 SessionIndex = 0; SessionIndex < Config.NumAdvertisedSessions; ++SessionIndex)
+	{
+		FOnlineSessionSearchResult& Result = AdvertisedSessions.AddDefaulted_GetRef();
+		FOnlineSessionSettings& Settings = Result.Session.SessionSettings;
+		Settings.NumPublicConnections = Config.MaxPublicConnections;
+		Settings.bShouldAdvertise = true;
+		Settings.bUsesPresence = true;
+		Settings.BuildUniqueId = UMultiplayerSessionsSubsystem::GetLocalBuildUniqueId();
+		if (Config.MatchTypes.Num() > 0)
+		{
+			Settings.Set(SETTING_MATCHTYPE, Config.MatchTypes[SessionIndex % Config.MatchTypes.Num()], EOnlineDataAdvertisementType::ViaOnlineServiceAndPing);
+		}
+
+		Result.Session.OwningUserId = FUniqueNetIdString::Create(FString::Printf(TEXT("FakeHost%d"), SessionIndex), MultiplayerFakeSession::NetIdType);
+		Result.Session.OwningUserName = FString::Printf(TEXT("FakeHost%d"), SessionIndex);
+		Result.Session.NumOpenPublicConnections = Random.FRand() < Config.FullSessionRate ? 0 : Random.RandRange(1, Config.MaxPublicConnections);
+		Result.Session.SessionInfo = MakeShared<MultiplayerFakeSession::FSessionInfo>(
+			FString::Printf(TEXT("FakeSession%d"), SessionIndex),
+			FString::Printf(TEXT("10.%d.%d.%d:7777"), (SessionIndex >> 16) & 0xFF, (SessionIndex >> 8) & 0xFF, SessionIndex & 0xFF)
+		);
+		Result.PingInMs = Random.RandRange(10, 250);
+	}
+}
+
+FOnlineSessionSearchResult* FMultiplayerFakeOnlineSession::FindAdvertisedSession(const FString& SessionId)
+{
+	return AdvertisedSessions.FindByPredicate([&SessionId](const FOnlineSessionSearchResult& Result)
+		{
+			return Result.GetSessionIdStr() == SessionId;
+		});
+}
+
+bool FMultiplayerFakeOnlineSession::RollFailure()
+{
+	return Config.FailureRate > 0.f && Random.FRand() < Config.FailureRate;
+}
+
+void FMultiplayerFakeOnlineSession::QueueCompletion(TFunction<void()>&& Completion)
+{
+	PendingCompletions.Add({ FPlatformTime::Seconds() + Config.LatencySeconds, MoveTemp(Completion) });
+}
+
+bool FMultiplayerFakeOnlineSession::Tick(float DeltaTime)
+{
+	const double Now = FPlatformTime::Seconds();
+	TArray<FPendingCompletion> DueCompletions;
+	for (int32 Index = 0; Index < PendingCompletions.Num();)
+	{
+		if (PendingCompletions[Index].DueSeconds <= Now)
+		{
+			DueCompletions.Add(MoveTemp(PendingCompletions[Index]));
+			PendingCompletions.RemoveAt(Index);
+		}
+		else
+		{
+			++Index;
+		}
+	}
+	for (FPendingCompletion& Due : DueCompletions)
+	{
+		Due.Completion();
+	}
+	return true;
+}
+
+void FMultiplayerFakeOnlineSession::Flush()
+{
+	//완료 콜백에서 다음 작업이 바로 시작될 수 있으니 더 이상 남은게 없을때까지 반복
+	while (PendingCompletions.Num() > 0)
+	{
+		TArray<FPendingCompletion> DueCompletions = MoveTemp(PendingCompletions);
+		PendingCompletions.Reset();
+		for (FPendingCompletion& Due : DueCompletions)
+		{
+			Due.Completion();
+		}
+	}
+}
+
+FUniqueNetIdPtr FMultiplayerFakeOnlineSession::CreateSessionIdFromString(const FString& SessionIdStr)
+{
+	return FUniqueNetIdString::Create(SessionIdStr, MultiplayerFakeSession::NetIdType);
+}
+
+FNamedOnlineSession* FMultiplayerFakeOnlineSession::GetNamedSession(FName SessionName)
+{
+	for (const TUniquePtr<FNamedOnlineSession>& Session : NamedSessions)
+	{
+		if (Session->SessionName == SessionName)
+		{
+			return Session.Get();
+		}
+	}
+	return nullptr;
+}
+
+void FMultiplayerFakeOnlineSession::RemoveNamedSession(FName SessionName)
+{
+	NamedSessions.RemoveAll([SessionName](const TUniquePtr<FNamedOnlineSession>& Session) { return Session->SessionName == SessionName; });
+}
+
+bool FMultiplayerFakeOnlineSession::HasPresenceSession()
+{
+	return NamedSessions.ContainsByPredicate([](const TUniquePtr<FNamedOnlineSession>& Session) { return Session->SessionSettings.bUsesPresence; });
+}
+
+EOnlineSessionState::Type FMultiplayerFakeOnlineSession::GetSessionState(FName SessionName) const
+{
+	for (const TUniquePtr<FNamedOnlineSession>& Session : NamedSessions)
+	{
+		if (Session->SessionName == SessionName)
+		{
+			return Session->SessionState;
+		}
+	}
+	return EOnlineSessionState::NoSession;
+}
+
+FNamedOnlineSession* FMultiplayerFakeOnlineSession::AddNamedSession(FName SessionName, const FOnlineSessionSettings& SessionSettings)
+{
+	return NamedSessions.Add_GetRef(MakeUnique<FNamedOnlineSession>(SessionName, SessionSettings)).Get();
+}
+
+FNamedOnlineSession* FMultiplayerFakeOnlineSession::AddNamedSession(FName SessionName, const FOnlineSession& Session)
+{
+	return NamedSessions.Add_GetRef(MakeUnique<FNamedOnlineSession>(SessionName, Session)).Get();
+}
+
+bool FMultiplayerFakeOnlineSession::CreateSession(int32 HostingPlayerNum, FName SessionName, const FOnlineSessionSettings& NewSessionSettings)
+{
+	return CreateSession(*FakeLocalUserId, SessionName, NewSessionSettings);
+}
+
+bool FMultiplayerFakeOnlineSession::CreateSession(const FUniqueNetId& HostingPlayerId, FName SessionName, const FOnlineSessionSettings& NewSessionSettings)
+{
+	if (GetNamedSession(SessionName) != nullptr)
+	{
+		return false;
+	}
+
+	FNamedOnlineSession* Session = AddNamedSession(SessionName, NewSessionSettings);
+	Session->SessionState = EOnlineSessionState::Creating;
+	Session->bHosting = true;
+	Session->OwningUserId = HostingPlayerId.AsShared();
+	Session->NumOpenPublicConnections = NewSessionSettings.NumPublicConnections;
+	Session->SessionInfo = MakeShared<MultiplayerFakeSession::FSessionInfo>(FString::Printf(TEXT("FakeHostedSession%u"), Random.GetUnsignedInt()), TEXT("127.0.0.1:7777"));
+
+	const bool bFail = RollFailure();
+	QueueCompletion([this, SessionName, bFail]()
+		{
+			if (bFail)
+			{
+				RemoveNamedSession(SessionName);
+			}
+			else if (FNamedOnlineSession* Created = GetNamedSession(SessionName))
+			{
+				Created->SessionState = EOnlineSessionState::Pending;
+			}
+			TriggerOnCreateSessionCompleteDelegates(SessionName, !bFail);
+		});
+	return true;
+}
+
+bool FMultiplayerFakeOnlineSession::StartSession(FName SessionName)
+{
+	FNamedOnlineSession* Session = GetNamedSession(SessionName);
+	if (Session == nullptr)
+	{
+		return false;
+	}
+	Session->SessionState = EOnlineSessionState::Starting;
+
+	const bool bFail = RollFailure();
+	QueueCompletion([this, SessionName, bFail]()
+		{
+			if (FNamedOnlineSession* Started = GetNamedSession(SessionName))
+			{
+				Started->SessionState = bFail ? EOnlineSessionState::Pending : EOnlineSessionState::InProgress;
+			}
+			TriggerOnStartSessionCompleteDelegates(SessionName, !bFail);
+		});
+	return true;
+}
+
+bool FMultiplayerFakeOnlineSession::UpdateSession(FName SessionName, FOnlineSessionSettings& UpdatedSessionSettings, bool bShouldRefreshOnlineData)
+{
+	FNamedOnlineSession* Session = GetNamedSession(SessionName);
+	if (Session == nullptr)
+	{
+		return false;
+	}
+	Session->SessionSettings = UpdatedSessionSettings;
+	QueueCompletion([this, SessionName]()
+		{
+			TriggerOnUpdateSessionCompleteDelegates(SessionName, true);
+		});
+	return true;
+}
+
+bool FMultiplayerFakeOnlineSession::EndSession(FName SessionName)
+{
+	FNamedOnlineSession* Session = GetNamedSession(SessionName);
+	if (Session == nullptr)
+	{
+		return false;
+	}
+	Session->SessionState = EOnlineSessionState::Ended;
+	QueueCompletion([this, SessionName]()
+		{
+			TriggerOnEndSessionCompleteDelegates(SessionName, true);
+		});
+	return true;
+}
+
+bool FMultiplayerFakeOnlineSession::DestroySession(FName SessionName, const FOnDestroySessionCompleteDelegate& CompletionDelegate)
+{
+	FNamedOnlineSession* Session = GetNamedSession(SessionName);
+	if (Session == nullptr)
+	{
+		return false;
+	}
+	Session->SessionState = EOnlineSessionState::Destroying;
+
+	const bool bFail = RollFailure();
+	QueueCompletion([this, SessionName, CompletionDelegate, bFail]()
+		{
+			if (!bFail)
+			{
+				if (const FNamedOnlineSession* Destroyed = GetNamedSession(SessionName))
+				{
+					const MultiplayerFakeSession::FSessionInfo* Info = MultiplayerFakeSession::GetInfo(*Destroyed);
+					if (Info && !Info->JoinedAdvertisedId.IsEmpty())
+					{
+						if (FOnlineSessionSearchResult* Advertised = FindAdvertisedSession(Info->JoinedAdvertisedId))
+						{
+							++Advertised->Session.NumOpenPublicConnections;
+						}
+					}
+				}
+				RemoveNamedSession(SessionName);
+			}
+			else if (FNamedOnlineSession* Remaining = GetNamedSession(SessionName))
+			{
+				Remaining->SessionState = EOnlineSessionState::Pending;
+			}
+			CompletionDelegate.ExecuteIfBound(SessionName, !bFail);
+			TriggerOnDestroySessionCompleteDelegates(SessionName, !bFail);
+		});
+	return true;
+}
+
+bool FMultiplayerFakeOnlineSession::IsPlayerInSession(FName SessionName, const FUniqueNetId& UniqueId)
+{
+	const FNamedOnlineSession* Session = GetNamedSession(SessionName);
+	return Session && Session->RegisteredPlayers.ContainsByPredicate([&UniqueId](const FUniqueNetIdRef& Player) { return *Player == UniqueId; });
+}
+
+bool FMultiplayerFakeOnlineSession::StartMatchmaking(const TArray<FUniqueNetIdRef>& LocalPlayers, FName SessionName, const FOnlineSessionSettings& NewSessionSettings, TSharedRef<FOnlineSessionSearch>& SearchSettings)
+{
+	return false;
+}
+
+bool FMultiplayerFakeOnlineSession::CancelMatchmaking(int32 SearchingPlayerNum, FName SessionName)
+{
+	return false;
+}
+
+bool FMultiplayerFakeOnlineSession::CancelMatchmaking(const FUniqueNetId& SearchingPlayerId, FName SessionName)
+{
+	return false;
+}
+
+bool FMultiplayerFakeOnlineSession::FindSessions(int32 SearchingPlayerNum, const TSharedRef<FOnlineSessionSearch>& SearchSettings)
+{
+	return FindSessions(*FakeLocalUserId, SearchSettings);
+}
+
+bool FMultiplayerFakeOnlineSession::FindSessions(const FUniqueNetId& SearchingPlayerId, const TSharedRef<FOnlineSessionSearch>& SearchSettings)
+{
+	if (ActiveSearch.IsValid())
+	{
+		return false;
+	}
+
+	ActiveSearch = SearchSettings;
+	SearchSettings->SearchState = EOnlineAsyncTaskState::InProgress;
+	SearchSettings->SearchResults.Reset();
+
+	const bool bFail = RollFailure();
+	QueueCompletion([this, SearchSettings, bFail]()
+		{
+			//취소된 검색의 완료는 버림
+			if (ActiveSearch != SearchSettings)
+			{
+				return;
+			}
+			ActiveSearch.Reset();
+
+			if (bFail)
+			{
+				SearchSettings->SearchState = EOnlineAsyncTaskState::Failed;
+				TriggerOnFindSessionsCompleteDelegates(false);
+				return;
+			}
+
+			//백엔드 쿼리처럼 MatchType, 최소 빈자리 조건을 여기서 걸러냄
+			FString MatchType;
+			const FOnlineSessionSearchParam* MatchTypeParam = SearchSettings->QuerySettings.SearchParams.Find(SETTING_MATCHTYPE);
+			if (MatchTypeParam)
+			{
+				MatchTypeParam->Data.GetValue(MatchType);
+			}
+			int32 MinSlots = 0;
+			const FOnlineSessionSearchParam* MinSlotsParam = SearchSettings->QuerySettings.SearchParams.Find(SEARCH_MINSLOTSAVAILABLE);
+			if (MinSlotsParam)
+			{
+				MinSlotsParam->Data.GetValue(MinSlots);
+			}
+
+			const int32 MaxResults = SearchSettings->MaxSearchResults > 0 ? SearchSettings->MaxSearchResults : MAX_int32;
+			for (const FOnlineSessionSearchResult& Advertised : AdvertisedSessions)
+			{
+				if (SearchSettings->SearchResults.Num() >= MaxResults)
+				{
+					break;
+				}
+				if (Advertised.Session.NumOpenPublicConnections < MinSlots)
+				{
+					continue;
+				}
+				FString AdvertisedMatchType;
+				if (MatchTypeParam && (!Advertised.Session.SessionSettings.Get(SETTING_MATCHTYPE, AdvertisedMatchType) || AdvertisedMatchType != MatchType))
+				{
+					continue;
+				}
+				SearchSettings->SearchResults.Add(Advertised);
+			}
+			SearchSettings->SearchState = EOnlineAsyncTaskState::Done;
+			TriggerOnFindSessionsCompleteDelegates(true);
+		});
+	return true;
+}
+
+bool FMultiplayerFakeOnlineSession::FindSessionById(const FUniqueNetId& SearchingUserId, const FUniqueNetId& SessionId, const FUniqueNetId& FriendId, const FOnSingleSessionResultCompleteDelegate& CompletionDelegate)
+{
+	const FString SessionIdStr = SessionId.ToString();
+	QueueCompletion([this, SessionIdStr, CompletionDelegate]()
+		{
+			const FOnlineSessionSearchResult* Found = FindAdvertisedSession(SessionIdStr);
+			CompletionDelegate.ExecuteIfBound(0, Found != nullptr, Found ? *Found : FOnlineSessionSearchResult());
+		});
+	return true;
+}
+
+bool FMultiplayerFakeOnlineSession::CancelFindSessions()
+{
+	if (!ActiveSearch.IsValid())
+	{
+		return false;
+	}
+	ActiveSearch->SearchState = EOnlineAsyncTaskState::Failed;
+	ActiveSearch.Reset();
+
+	QueueCompletion([this]()
+		{
+			TriggerOnCancelFindSessionsCompleteDelegates(true);
+		});
+	return true;
+}
+
+bool FMultiplayerFakeOnlineSession::PingSearchResults(const FOnlineSessionSearchResult& SearchResult)
+{
+	return false;
+}
+
+bool FMultiplayerFakeOnlineSession::JoinSession(int32 LocalUserNum, FName SessionName, const FOnlineSessionSearchResult& DesiredSession)
+{
+	return JoinSession(*FakeLocalUserId, SessionName, DesiredSession);
+}
+
+bool FMultiplayerFakeOnlineSession::JoinSession(const FUniqueNetId& LocalUserId, FName SessionName, const FOnlineSessionSearchResult& DesiredSession)
+{
+	if (GetNamedSession(SessionName) != nullptr || !DesiredSession.IsValid())
+	{
+		return false;
+	}
+
+	const FString SessionId = DesiredSession.GetSessionIdStr();
+	const bool bFail = RollFailure();
+	QueueCompletion([this, SessionName, SessionId, bFail]()
+		{
+			FOnlineSessionSearchResult* Advertised = FindAdvertisedSession(SessionId);
+			EOnJoinSessionCompleteResult::Type Result = EOnJoinSessionCompleteResult::Success;
+			if (bFail)
+			{
+				Result = EOnJoinSessionCompleteResult::UnknownError;
+			}
+			else if (Advertised == nullptr)
+			{
+				Result = EOnJoinSessionCompleteResult::SessionDoesNotExist;
+			}
+			else if (Advertised->Session.NumOpenPublicConnections <= 0)
+			{
+				Result = EOnJoinSessionCompleteResult::SessionIsFull;
+			}
+
+			if (Result == EOnJoinSessionCompleteResult::Success)
+			{
+				--Advertised->Session.NumOpenPublicConnections;
+
+				FNamedOnlineSession* Joined = AddNamedSession(SessionName, Advertised->Session);
+				Joined->SessionState = EOnlineSessionState::Pending;
+				Joined->bHosting = false;
+				const MultiplayerFakeSession::FSessionInfo* AdvertisedInfo = MultiplayerFakeSession::GetInfo(Advertised->Session);
+				TSharedRef<MultiplayerFakeSession::FSessionInfo> JoinedInfo = MakeShared<MultiplayerFakeSession::FSessionInfo>(SessionId, AdvertisedInfo ? AdvertisedInfo->HostAddress : FString());
+				JoinedInfo->JoinedAdvertisedId = SessionId;
+				Joined->SessionInfo = JoinedInfo;
+			}
+			TriggerOnJoinSessionCompleteDelegates(SessionName, Result);
+		});
+	return true;
+}
+
+bool FMultiplayerFakeOnlineSession::FindFriendSession(int32 LocalUserNum, const FUniqueNetId& Friend)
+{
+	return false;
+}
+
+bool FMultiplayerFakeOnlineSession::FindFriendSession(const FUniqueNetId& LocalUserId, const FUniqueNetId& Friend)
+{
+	return false;
+}
+
+bool FMultiplayerFakeOnlineSession::FindFriendSession(const FUniqueNetId& LocalUserId, const TArray<FUniqueNetIdRef>& FriendList)
+{
+	return false;
+}
+
+bool FMultiplayerFakeOnlineSession::SendSessionInviteToFriend(int32 LocalUserNum, FName SessionName, const FUniqueNetId& Friend)
+{
+	return false;
+}
+
+bool FMultiplayerFakeOnlineSession::SendSessionInviteToFriend(const FUniqueNetId& LocalUserId, FName SessionName, const FUniqueNetId& Friend)
+{
+	return false;
+}
+
+bool FMultiplayerFakeOnlineSession::SendSessionInviteToFriends(int32 LocalUserNum, FName SessionName, const TArray<FUniqueNetIdRef>& Friends)
+{
+	return false;
+}
+
+bool FMultiplayerFakeOnlineSession::SendSessionInviteToFriends(const FUniqueNetId& LocalUserId, FName SessionName, const TArray<FUniqueNetIdRef>& Friends)
+{
+	return false;
+}
+
+bool FMultiplayerFakeOnlineSession::GetResolvedConnectString(FName SessionName, FString& ConnectInfo, FName PortType)
+{
+	const FNamedOnlineSession* Session = GetNamedSession(SessionName);
+	const MultiplayerFakeSession::FSessionInfo* Info = Session ? MultiplayerFakeSession::GetInfo(*Session) : nullptr;
+	if (Info == nullptr)
+	{
+		return false;
+	}
+	ConnectInfo = Info->HostAddress;
+	return true;
+}
+
+bool FMultiplayerFakeOnlineSession::GetResolvedConnectString(const FOnlineSessionSearchResult& SearchResult, FName PortType, FString& ConnectInfo)
+{
+	const MultiplayerFakeSession::FSessionInfo* Info = SearchResult.IsValid() ? MultiplayerFakeSession::GetInfo(SearchResult.Session) : nullptr;
+	if (Info == nullptr)
+	{
+		return false;
+	}
+	ConnectInfo = Info->HostAddress;
+	return true;
+}
+
+FOnlineSessionSettings* FMultiplayerFakeOnlineSession::GetSessionSettings(FName SessionName)
+{
+	FNamedOnlineSession* Session = GetNamedSession(SessionName);
+	return Session ? &Session->SessionSettings : nullptr;
+}
+
+bool FMultiplayerFakeOnlineSession::RegisterPlayer(FName SessionName, const FUniqueNetId& PlayerId, bool bWasInvited)
+{
+	return RegisterPlayers(SessionName, { PlayerId.AsShared() }, bWasInvited);
+}
+
+bool FMultiplayerFakeOnlineSession::RegisterPlayers(FName SessionName, const TArray<FUniqueNetIdRef>& Players, bool bWasInvited)
+{
+	FNamedOnlineSession* Session = GetNamedSession(SessionName);
+	if (Session == nullptr)
+	{
+		return false;
+	}
+	for (const FUniqueNetIdRef& Player : Players)
+	{
+		if (!IsPlayerInSession(SessionName, *Player))
+		{
+			Session->RegisteredPlayers.Add(Player);
+		}
+	}
+	QueueCompletion([this, SessionName, Players]()
+		{
+			TriggerOnRegisterPlayersCompleteDelegates(SessionName, Players, true);
+		});
+	return true;
+}
+
+bool FMultiplayerFakeOnlineSession::UnregisterPlayer(FName SessionName, const FUniqueNetId& PlayerId)
+{
+	return UnregisterPlayers(SessionName, { PlayerId.AsShared() });
+}
+
+bool FMultiplayerFakeOnlineSession::UnregisterPlayers(FName SessionName, const TArray<FUniqueNetIdRef>& Players)
+{
+	FNamedOnlineSession* Session = GetNamedSession(SessionName);
+	if (Session == nullptr)
+	{
+		return false;
+	}
+	for (const FUniqueNetIdRef& Player : Players)
+	{
+		Session->RegisteredPlayers.RemoveAll([&Player](const FUniqueNetIdRef& Registered) { return *Registered == *Player; });
+	}
+	QueueCompletion([this, SessionName, Players]()
+		{
+			TriggerOnUnregisterPlayersCompleteDelegates(SessionName, Players, true);
+		});
+	return true;
+}
+
+void FMultiplayerFakeOnlineSession::RegisterLocalPlayer(const FUniqueNetId& PlayerId, FName SessionName, const FOnRegisterLocalPlayerCompleteDelegate& Delegate)
+{
+	Delegate.ExecuteIfBound(PlayerId, EOnJoinSessionCompleteResult::Success);
+}
+
+void FMultiplayerFakeOnlineSession::UnregisterLocalPlayer(const FUniqueNetId& PlayerId, FName SessionName, const FOnUnregisterLocalPlayerCompleteDelegate& Delegate)
+{
+	Delegate.ExecuteIfBound(PlayerId, true);
+}
+
+void FMultiplayerFakeOnlineSession::RemovePlayerFromSession(int32 LocalUserNum, FName SessionName, const FUniqueNetId& TargetPlayerId)
+{
+	UnregisterPlayer(SessionName, TargetPlayerId);
+}
+
+int32 FMultiplayerFakeOnlineSession::GetNumSessions()
+{
+	return NamedSessions.Num();
+}
+
+void FMultiplayerFakeOnlineSession::DumpSessionState()
+{
+	UE_LOG(LogMultiplayerSessions, Display, TEXT("Fake session backend: %d advertised, %d named, %d pending completions"), AdvertisedSessions.Num(), NamedSessions.Num(), PendingCompletions.Num());
+	for (const TUniquePtr<FNamedOnlineSession>& Session : NamedSessions)
+	{
+		UE_LOG(LogMultiplayerSessions, Display, TEXT("  %s: %s, %d open slots, %d registered"),
+			*Session->SessionName.ToString(),
+			EOnlineSessionState::ToString(Session->SessionState),
+			Session->NumOpenPublicConnections,
+			Session->RegisteredPlayers.Num()
+		);
+	}
+}
@@ -0,0 +1,452 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MultiplayerLanDiscovery.h"
+#include "MultiplayerSessionNames.h"
+#include "MultiplayerSessionsSubsystem.h"
+#include "MutiplayerSessions.h"
+#include "Async/Async.h"
+#include "Common/UdpSocketBuilder.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/RunnableThread.h"
+#include "Interfaces/IPv4/IPv4Address.h"
+#include "IPAddress.h"
+#include "Online/OnlineSessionNames.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+
+namespace MultiplayerLanDiscovery
+{
+	static constexpr uint32 PacketMagic = 0x444C504D; // "MPLD"
+	static constexpr uint8 PacketVersion = 1;
+	static constexpr uint8 ProbeType = 1;
+	static constexpr uint8 ReplyType = 2;
+	// 한 패킷에 들어가는 문자열 길이 제한, 이상한 패킷으로 큰 할당을 하지 않게
+	static constexpr int32 MaxPacketSize = 1024;
+
+	struct FPacketHeader
+	{
+		uint32 Magic{ PacketMagic };
+		uint8 Version{ PacketVersion };
+		uint8 Type{ 0 };
+		uint16 Sequence{ 0 };
+		uint32 Nonce{ 0 };
+
+		friend FArchive& operator<<(FArchive& Ar, FPacketHeader& Header)
+		{
+			return Ar << Header.Magic << Header.Version << Header.Type << Header.Sequence << Header.Nonce;
+		}
+
+		bool IsValid(uint8 ExpectedType) const
+		{
+			return Magic == PacketMagic && Version == PacketVersion && Type == ExpectedType;
+		}
+	};
+
+	static void SerializeAdvertisement(FArchive& Ar, FMultiplayerLanAdvertisement& Advertisement)
+	{
+		Ar << Advertisement.BuildUniqueId << Advertisement.MatchType << Advertisement.HostKey << Advertisement.OwningUserName << Advertisement.MapPath;
+		Ar << Advertisement.NumPublicConnections << Advertisement.OpenSlots << Advertisement.GamePort << Advertisement.QosPort << Advertisement.BeaconPort;
+	}
+
+	static bool Matches(const FString& WantedMatchType, int32 WantedBuildUniqueId, const FString& MatchType, int32 BuildUniqueId)
+	{
+		return (WantedMatchType.IsEmpty() || WantedMatchType == MatchType)
+			&& (WantedBuildUniqueId == 0 || WantedBuildUniqueId == BuildUniqueId);
+	}
+}
+
+/** Session info of a host found by LAN discovery; there is no backend session, only the address to travel to */
+class FMultiplayerLanSessionInfo : public FOnlineSessionInfo
+{
+public:
+	FMultiplayerLanSessionInfo(const FString& InHostAddress, const FString& InHostKey)
+		: HostAddress(InHostAddress)
+		, SessionId(FUniqueNetIdString::Create(InHostKey.IsEmpty() ? InHostAddress : InHostKey, FName(TEXT("LAN"))))
+	{
+	}
+
+	virtual const uint8* GetBytes() const override { return nullptr; }
+	virtual int32 GetSize() const override { return 0; }
+	virtual bool IsValid() const override { return !HostAddress.IsEmpty(); }
+	virtual const FUniqueNetId& GetSessionId() const override { return *SessionId; }
+	virtual FString ToString() const override { return HostAddress; }
+	virtual FString ToDebugString() const override { return FString::Printf(TEXT("LAN %s (%s)"), *HostAddress, *SessionId->ToString()); }
+
+	FString HostAddress;
+	FUniqueNetIdRef SessionId;
+};
+
+FMultiplayerLanDiscoveryResponder::~FMultiplayerLanDiscoveryResponder()
+{
+	Shutdown();
+}
+
+bool FMultiplayerLanDiscoveryResponder::Start(int32 BasePort, int32 PortRange)
+{
+	if (IsRunning())
+	{
+		return true;
+	}
+
+	//같은 PC 에 호스트가 여럿이면 각자 범위 안의 빈 포트를 잡음, 그래서 Reusable 은 쓰지 않음
+	for (int32 Port = BasePort; Port < BasePort + FMath::Max(PortRange, 1) && Socket == nullptr; ++Port)
+	{
+		Socket = FUdpSocketBuilder(TEXT("MultiplayerLanDiscoveryResponder"))
+			.AsNonBlocking()
+			.WithBroadcast()
+			.BoundToAddress(FIPv4Address::Any)
+			.BoundToPort(Port)
+			.Build();
+		BoundPort = Socket ? Port : 0;
+	}
+	if (Socket == nullptr)
+	{
+		UE_LOG(LogMultiplayerSessions, Warning, TEXT("LAN discovery responder found no free port in %d-%d"), BasePort, BasePort + PortRange - 1);
+		return false;
+	}
+
+	bStopping = false;
+	Thread = FRunnableThread::Create(this, TEXT("MultiplayerLanDiscoveryResponder"), 0, TPri_AboveNormal);
+	return Thread != nullptr;
+}
+
+void FMultiplayerLanDiscoveryResponder::Shutdown()
+{
+	if (Thread)
+	{
+		Thread->Kill(true);
+		delete Thread;
+		Thread = nullptr;
+	}
+	if (Socket)
+	{
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Socket);
+		Socket = nullptr;
+	}
+	BoundPort = 0;
+}
+
+void FMultiplayerLanDiscoveryResponder::SetAdvertisement(const FMultiplayerLanAdvertisement& Advertisement)
+{
+	//응답마다 직렬화하지 않도록 바뀔때 한번만 만들어 둠
+	TArray<uint8> Payload;
+	FMemoryWriter Writer(Payload);
+	FMultiplayerLanAdvertisement Copy = Advertisement;
+	MultiplayerLanDiscovery::SerializeAdvertisement(Writer, Copy);
+
+	FScopeLock Lock(&AdvertisementLock);
+	AdvertisementPayload = MoveTemp(Payload);
+	MatchType = Advertisement.MatchType;
+	BuildUniqueId = Advertisement.BuildUniqueId;
+}
+
+uint32 FMultiplayerLanDiscoveryResponder::Run()
+{
+	using namespace MultiplayerLanDiscovery;
+
+	ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	TSharedRef<FInternetAddr> FromAddress = SocketSubsystem->CreateInternetAddr();
+	TArray<uint8> Received;
+	Received.SetNumUninitialized(MaxPacketSize);
+	TArray<uint8> Reply;
+	Reply.Reserve(MaxPacketSize);
+
+	while (!bStopping)
+	{
+		if (!Socket->Wait(ESocketWaitConditions::WaitForRead, FTimespan::FromMilliseconds(50)))
+		{
+			continue;
+		}
+
+		int32 BytesRead = 0;
+		while (Socket->RecvFrom(Received.GetData(), Received.Num(), BytesRead, *FromAddress))
+		{
+			FMemoryReader Reader(Received);
+			Reader.SetLimitSize(BytesRead);
+			Reader.ArMaxSerializeSize = MaxPacketSize;
+			FPacketHeader Header;
+			int32 WantedBuildUniqueId = 0;
+			FString WantedMatchType;
+			Reader << Header << WantedBuildUniqueId << WantedMatchType;
+			if (Reader.IsError() || !Header.IsValid(ProbeType))
+			{
+				continue;
+			}
+
+			Reply.Reset();
+			{
+				FScopeLock Lock(&AdvertisementLock);
+				//광고할 세션이 아직 없거나 찾는 매치가 아니면 대답하지 않음
+				if (AdvertisementPayload.Num() == 0 || !Matches(WantedMatchType, WantedBuildUniqueId, MatchType, BuildUniqueId))
+				{
+					continue;
+				}
+				FMemoryWriter Writer(Reply);
+				Header.Type = ReplyType;
+				Writer << Header;
+				Reply.Append(AdvertisementPayload);
+			}
+
+			int32 BytesSent = 0;
+			Socket->SendTo(Reply.GetData(), Reply.Num(), BytesSent, *FromAddress);
+		}
+	}
+	return 0;
+}
+
+void FMultiplayerLanDiscoveryResponder::Stop()
+{
+	bStopping = true;
+}
+
+void FMultiplayerLanDiscovery::DiscoverAsync(const FMultiplayerLanDiscoveryParams& Params, TSharedPtr<FThreadSafeBool, ESPMode::ThreadSafe> CancelFlag, TFunction<void(TArray<FMultiplayerLanHost>&&)> OnComplete)
+{
+	Async(EAsyncExecution::ThreadPool, [Params, CancelFlag, OnComplete = MoveTemp(OnComplete)]() mutable
+		{
+			TArray<FMultiplayerLanHost> Hosts = Discover(Params, CancelFlag.Get());
+			AsyncTask(ENamedThreads::GameThread, [Hosts = MoveTemp(Hosts), OnComplete = MoveTemp(OnComplete)]() mutable
+				{
+					OnComplete(MoveTemp(Hosts));
+				});
+		});
+}
+
+TArray<FMultiplayerLanHost> FMultiplayerLanDiscovery::Discover(const FMultiplayerLanDiscoveryParams& Params, const FThreadSafeBool* CancelFlag)
+{
+	using namespace MultiplayerLanDiscovery;
+
+	TArray<FMultiplayerLanHost> Hosts;
+	ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	if (SocketSubsystem == nullptr || Params.PortRange <= 0 || Params.MaxResults <= 0)
+	{
+		return Hosts;
+	}
+
+	FSocket* Socket = FUdpSocketBuilder(TEXT("MultiplayerLanDiscovery")).AsNonBlocking().WithBroadcast().Build();
+	if (Socket == nullptr)
+	{
+		return Hosts;
+	}
+
+	//범위 안의 모든 포트에 브로드캐스트, 같은 PC 의 호스트는 루프백으로도 보냄
+	TArray<TSharedRef<FInternetAddr>> Targets;
+	for (int32 Port = Params.BasePort; Port < Params.BasePort + Params.PortRange; ++Port)
+	{
+		TSharedRef<FInternetAddr> BroadcastAddress = SocketSubsystem->CreateInternetAddr();
+		BroadcastAddress->SetBroadcastAddress();
+		BroadcastAddress->SetPort(Port);
+		Targets.Add(BroadcastAddress);
+		if (Params.bProbeLoopback)
+		{
+			TSharedRef<FInternetAddr> LoopbackAddress = SocketSubsystem->CreateInternetAddr();
+			LoopbackAddress->SetLoopbackAddress();
+			LoopbackAddress->SetPort(Port);
+			Targets.Add(LoopbackAddress);
+		}
+	}
+
+	const uint32 Nonce = FMath::Rand();
+	const double StartTime = FPlatformTime::Seconds();
+	const double Deadline = StartTime + FMath::Max(Params.TimeoutSeconds, 0.f);
+	const double ProbeInterval = FMath::Max(Params.ProbeIntervalSeconds, 0.001f);
+	double NextProbeTime = StartTime;
+	double ReturnTime = Deadline;
+	// 라운드마다 보낸 시간, 응답의 Sequence 로 핑을 잼
+	TArray<double> RoundSendTimes;
+	TSet<FString> SeenHostKeys;
+
+	TArray<uint8> Probe;
+	TArray<uint8> Received;
+	Received.SetNumUninitialized(MaxPacketSize);
+	TSharedRef<FInternetAddr> FromAddress = SocketSubsystem->CreateInternetAddr();
+
+	for (double Now = StartTime; Now < ReturnTime; Now = FPlatformTime::Seconds())
+	{
+		if (CancelFlag && *CancelFlag)
+		{
+			break;
+		}
+
+		if (Now >= NextProbeTime && RoundSendTimes.Num() <= MAX_uint16)
+		{
+			FPacketHeader Header;
+			Header.Type = ProbeType;
+			Header.Sequence = static_cast<uint16>(RoundSendTimes.Num());
+			Header.Nonce = Nonce;
+			int32 WantedBuildUniqueId = Params.BuildUniqueId;
+			FString WantedMatchType = Params.MatchType;
+			Probe.Reset();
+			FMemoryWriter Writer(Probe);
+			Writer << Header << WantedBuildUniqueId << WantedMatchType;
+
+			RoundSendTimes.Add(Now);
+			for (const TSharedRef<FInternetAddr>& Target : Targets)
+			{
+				int32 BytesSent = 0;
+				Socket->SendTo(Probe.GetData(), Probe.Num(), BytesSent, *Target);
+			}
+			NextProbeTime = Now + ProbeInterval;
+		}
+
+		//취소 확인이 늦지 않게 한번에 50ms 이상 기다리지 않음
+		const double WaitUntil = FMath::Min3(NextProbeTime, ReturnTime, Now + 0.05);
+		const double WaitSeconds = FMath::Max(WaitUntil - FPlatformTime::Seconds(), 0.0);
+		if (!Socket->Wait(ESocketWaitConditions::WaitForRead, FTimespan::FromSeconds(WaitSeconds)))
+		{
+			continue;
+		}
+
+		int32 BytesRead = 0;
+		while (Socket->RecvFrom(Received.GetData(), Received.Num(), BytesRead, *FromAddress))
+		{
+			const double ReceiveTime = FPlatformTime::Seconds();
+			FMemoryReader Reader(Received);
+			Reader.SetLimitSize(BytesRead);
+			Reader.ArMaxSerializeSize = MaxPacketSize;
+			FPacketHeader Header;
+			FMultiplayerLanHost Host;
+			Reader << Header;
+			SerializeAdvertisement(Reader, Host.Advertisement);
+			if (Reader.IsError() || !Header.IsValid(ReplyType) || Header.Nonce != Nonce || !RoundSendTimes.IsValidIndex(Header.Sequence)
+				|| !Matches(Params.MatchType, Params.BuildUniqueId, Host.Advertisement.MatchType, Host.Advertisement.BuildUniqueId))
+			{
+				continue;
+			}
+			//브로드캐스트와 루프백, 여러 라운드에 같은 호스트가 여러번 대답함
+			TSharedRef<FInternetAddr> HostAddress = FromAddress->Clone();
+			HostAddress->SetPort(Host.Advertisement.GamePort);
+			Host.Address = HostAddress->ToString(true);
+			bool bAlreadySeen = false;
+			SeenHostKeys.Add(Host.Advertisement.HostKey.IsEmpty() ? Host.Address : Host.Advertisement.HostKey, &bAlreadySeen);
+			if (bAlreadySeen)
+			{
+				continue;
+			}
+
+			Host.PingMs = static_cast<float>((ReceiveTime - RoundSendTimes[Header.Sequence]) * 1000.0);
+			Hosts.Add(MoveTemp(Host));
+			if (Hosts.Num() == 1)
+			{
+				//첫 호스트가 오면 비슷한 시간에 오는 나머지만 잠깐 더 기다림
+				ReturnTime = FMath::Min(Deadline, ReceiveTime + FMath::Max(Params.FirstResponseGraceSeconds, 0.f));
+			}
+			if (Hosts.Num() >= Params.MaxResults)
+			{
+				ReturnTime = ReceiveTime;
+				break;
+			}
+		}
+	}
+	SocketSubsystem->DestroySocket(Socket);
+
+	Hosts.Sort([](const FMultiplayerLanHost& A, const FMultiplayerLanHost& B) { return A.PingMs < B.PingMs; });
+	return Hosts;
+}
+
+FOnlineSessionSearchResult FMultiplayerLanDiscovery::MakeSearchResult(const FMultiplayerLanHost& Host)
+{
+	const FMultiplayerLanAdvertisement& Advertisement = Host.Advertisement;
+
+	FOnlineSessionSearchResult Result;
+	Result.PingInMs = FMath::RoundToInt(Host.PingMs);
+	Result.Session.OwningUserName = Advertisement.OwningUserName;
+	Result.Session.NumOpenPublicConnections = Advertisement.OpenSlots;
+	Result.Session.SessionInfo = MakeShared<FMultiplayerLanSessionInfo>(Host.Address, Advertisement.HostKey);
+
+	//호스트가 만든 세션 설정에서 검색, 참가에 쓰는 값만 다시 채움
+	FOnlineSessionSettings& Settings = Result.Session.SessionSettings;
+	Settings.bIsLANMatch = true;
+	Settings.bShouldAdvertise = true;
+	Settings.bAllowJoinInProgress = true;
+	Settings.NumPublicConnections = Advertisement.NumPublicConnections;
+	Settings.BuildUniqueId = Advertisement.BuildUniqueId;
+	Settings.Set(SETTING_MATCHTYPE, Advertisement.MatchType, EOnlineDataAdvertisementType::ViaOnlineServiceAndPing);
+	Settings.Set(SETTING_OPENSLOTS, Advertisement.OpenSlots, EOnlineDataAdvertisementType::ViaOnlineServiceAndPing);
+	Settings.Set(SETTING_HOSTKEY, Advertisement.HostKey, EOnlineDataAdvertisementType::ViaOnlineService);
+	//참가할때 백엔드 대신 주소로 바로 가기 위한 표시, 광고되지 않는 로컬 값
+	Settings.Set(SETTING_LANRESULT, true, EOnlineDataAdvertisementType::DontAdvertise);
+	if (Advertisement.QosPort > 0)
+	{
+		Settings.Set(SETTING_QOSPORT, Advertisement.QosPort, EOnlineDataAdvertisementType::ViaOnlineService);
+	}
+	if (Advertisement.BeaconPort > 0)
+	{
+		Settings.Set(SETTING_BEACONPORT, Advertisement.BeaconPort, EOnlineDataAdvertisementType::ViaOnlineService);
+	}
+	if (!Advertisement.MapPath.IsEmpty())
+	{
+		Settings.Set(SETTING_MAPNAME, Advertisement.MapPath, EOnlineDataAdvertisementType::ViaOnlineService);
+	}
+	return Result;
+}
+
+FString FMultiplayerLanDiscovery::GetHostAddress(const FOnlineSessionSearchResult& SearchResult)
+{
+	//백엔드 결과의 SessionInfo 는 다른 타입이라 MakeSearchResult 가 남긴 표시가 있을때만 캐스팅
+	bool bIsLanResult = false;
+	if (!SearchResult.Session.SessionInfo.IsValid() || !SearchResult.Session.SessionSettings.Get(SETTING_LANRESULT, bIsLanResult) || !bIsLanResult)
+	{
+		return FString();
+	}
+	return static_cast<const FMultiplayerLanSessionInfo&>(*SearchResult.Session.SessionInfo).HostAddress;
+}
+
+#if !UE_BUILD_SHIPPING
+
+// 루프백에서 호스트 여러개를 띄우고 첫 응답까지 걸리는 시간을 잼
+static FAutoConsoleCommand MultiplayerLanDiscoveryBenchCommand(
+	TEXT("MultiplayerSessions.LanDiscoveryBench"),
+	TEXT("Discovers local LAN responders on loopback. Args: [NumHosts=4] [ProbeIntervalMs=50] [GraceMs=5] [BasePort=17797]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			const int32 NumHosts = Args.IsValidIndex(0) ? FCString::Atoi(*Args[0]) : 4;
+			const float ProbeIntervalMs = Args.IsValidIndex(1) ? FCString::Atof(*Args[1]) : 50.f;
+			const float GraceMs = Args.IsValidIndex(2) ? FCString::Atof(*Args[2]) : 5.f;
+			const int32 BasePort = Args.IsValidIndex(3) ? FCString::Atoi(*Args[3]) : 17797;
+
+			TArray<TUniquePtr<FMultiplayerLanDiscoveryResponder>> Responders;
+			for (int32 HostIndex = 0; HostIndex < NumHosts; ++HostIndex)
+			{
+				TUniquePtr<FMultiplayerLanDiscoveryResponder> Responder = MakeUnique<FMultiplayerLanDiscoveryResponder>();
+				if (!Responder->Start(BasePort, NumHosts))
+				{
+					continue;
+				}
+				FMultiplayerLanAdvertisement Advertisement;
+				Advertisement.MatchType = TEXT("FreeForAll");
+				Advertisement.HostKey = FString::Printf(TEXT("Bench%d"), HostIndex);
+				Advertisement.OwningUserName = Advertisement.HostKey;
+				Advertisement.BuildUniqueId = UMultiplayerSessionsSubsystem::GetLocalBuildUniqueId();
+				Advertisement.NumPublicConnections = 4;
+				Advertisement.OpenSlots = 4 - HostIndex % 4;
+				Advertisement.GamePort = 7777 + HostIndex;
+				Responder->SetAdvertisement(Advertisement);
+				Responders.Add(MoveTemp(Responder));
+			}
+
+			FMultiplayerLanDiscoveryParams Params;
+			Params.BasePort = BasePort;
+			Params.PortRange = NumHosts;
+			Params.ProbeIntervalSeconds = ProbeIntervalMs / 1000.f;
+			Params.FirstResponseGraceSeconds = GraceMs / 1000.f;
+			Params.MatchType = TEXT("FreeForAll");
+			Params.BuildUniqueId = UMultiplayerSessionsSubsystem::GetLocalBuildUniqueId();
+			Params.bProbeLoopback = true;
+
+			const double StartTime = FPlatformTime::Seconds();
+			const TArray<FMultiplayerLanHost> Hosts = FMultiplayerLanDiscovery::Discover(Params);
+			const double ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+			for (const FMultiplayerLanHost& Host : Hosts)
+			{
+				UE_LOG(LogMultiplayerSessions, Display, TEXT("%s %s slots %d/%d ping %.3f ms"),
+					*Host.Advertisement.HostKey, *Host.Address, Host.Advertisement.OpenSlots, Host.Advertisement.NumPublicConnections, Host.PingMs);
+			}
+			UE_LOG(LogMultiplayerSessions, Display, TEXT("Found %d/%d LAN hosts in %.2f ms"), Hosts.Num(), Responders.Num(), ElapsedMs);
+		})
+);
+
+#endif
@@ -0,0 +1,176 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MultiplayerReservationBeacon.h"
+#include "MultiplayerSessionsSubsystem.h"
+#include "MutiplayerSessions.h"
+#include "Engine/World.h"
+#include "Engine/NetConnection.h"
+#include "TimerManager.h"
+
+bool AMultiplayerReservationBeaconClient::RequestReservation(const FString& ConnectInfo, const FUniqueNetIdRepl& PlayerId, float ResponseTimeoutSeconds)
+{
+	FURL URL(nullptr, *ConnectInfo, TRAVEL_Absolute);
+	if (!URL.Valid)
+	{
+		return false;
+	}
+
+	PendingPlayerId = PlayerId;
+	if (!InitClient(URL))
+	{
+		return false;
+	}
+	//연결은 됐는데 호스트가 답을 안 주는 경우까지 막음
+	GetWorldTimerManager().SetTimer(ResponseTimeoutHandle, this, &ThisClass::OnResponseTimeout, FMath::Max(ResponseTimeoutSeconds, 0.1f), false);
+	return true;
+}
+
+void AMultiplayerReservationBeaconClient::OnConnected()
+{
+	ServerRequestReservation(PendingPlayerId);
+}
+
+void AMultiplayerReservationBeaconClient::OnFailure()
+{
+	UE_LOG(LogMultiplayerSessions, Warning, TEXT("Reservation beacon connection failed"));
+	CompleteReservation(EMultiplayerReservationResult::Failed);
+	Super::OnFailure();
+}
+
+void AMultiplayerReservationBeaconClient::ServerRequestReservation_Implementation(const FUniqueNetIdRepl& PlayerId)
+{
+	AMultiplayerReservationBeaconHostObject* HostObject = Cast<AMultiplayerReservationBeaconHostObject>(GetBeaconOwner());
+	//연결 하나에 예약 하나, 다른 사람 자리를 대신 잡는것도 막기 위해 로그인한 아이디만 받음
+	const UNetConnection* Connection = GetNetConnection();
+	if (HostObject == nullptr || bReservationRequested || Connection == nullptr || !Connection->PlayerId.IsValid() || Connection->PlayerId != PlayerId)
+	{
+		UE_LOG(LogMultiplayerSessions, Warning, TEXT("Refused a reservation request for %s"), *PlayerId.ToDebugString());
+		ClientReservationResponse(EMultiplayerReservationResult::Failed);
+		return;
+	}
+	bReservationRequested = true;
+	HostObject->ProcessReservationRequest(this, Connection->PlayerId);
+}
+
+void AMultiplayerReservationBeaconClient::ClientReservationResponse_Implementation(EMultiplayerReservationResult Result)
+{
+	CompleteReservation(Result);
+}
+
+void AMultiplayerReservationBeaconClient::OnResponseTimeout()
+{
+	UE_LOG(LogMultiplayerSessions, Warning, TEXT("Reservation beacon timed out waiting for the host"));
+	CompleteReservation(EMultiplayerReservationResult::Failed);
+}
+
+void AMultiplayerReservationBeaconClient::CompleteReservation(EMultiplayerReservationResult Result)
+{
+	//서버 쪽 액터나 이미 끝난 요청은 델리게이트가 없음
+	if (!OnReservationComplete.IsBound())
+	{
+		return;
+	}
+	GetWorldTimerManager().ClearTimer(ResponseTimeoutHandle);
+
+	FMultiplayerOnReservationComplete Completion = MoveTemp(OnReservationComplete);
+	OnReservationComplete.Unbind();
+	//답을 받았으면 비콘 연결은 더 필요 없음, RPC 처리 도중이니 다음 틱에 정리
+	GetWorldTimerManager().SetTimerForNextTick(FTimerDelegate::CreateWeakLambda(this, [this]()
+	{
+		DestroyBeacon();
+	}));
+	Completion.ExecuteIfBound(Result);
+}
+
+AMultiplayerReservationBeaconHostObject::AMultiplayerReservationBeaconHostObject(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	ClientBeaconActorClass = AMultiplayerReservationBeaconClient::StaticClass();
+	BeaconTypeName = ClientBeaconActorClass->GetName();
+
+	//만료 확인만 하면 되니 1초에 한번
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.TickInterval = 1.f;
+}
+
+void AMultiplayerReservationBeaconHostObject::Init(UMultiplayerSessionsSubsystem* InSessionsSubsystem, float InReservationTimeoutSeconds)
+{
+	SessionsSubsystem = InSessionsSubsystem;
+	ReservationTimeoutSeconds = InReservationTimeoutSeconds;
+}
+
+void AMultiplayerReservationBeaconHostObject::ProcessReservationRequest(AMultiplayerReservationBeaconClient* Client, const FUniqueNetIdRepl& PlayerId)
+{
+	UMultiplayerSessionsSubsystem* Subsystem = SessionsSubsystem.Get();
+	if (Client == nullptr || Subsystem == nullptr || !PlayerId.IsValid())
+	{
+		if (Client)
+		{
+			Client->ClientReservationResponse(EMultiplayerReservationResult::Failed);
+		}
+		return;
+	}
+
+	const double ExpireSeconds = FPlatformTime::Seconds() + ReservationTimeoutSeconds;
+	//같은 플레이어가 다시 요청하면 자리를 새로 잡지 않고 시간만 연장
+	FReservation* Existing = Reservations.FindByPredicate([&PlayerId](const FReservation& Reservation) { return Reservation.PlayerId == PlayerId; });
+	if (Existing)
+	{
+		Existing->ExpireSeconds = ExpireSeconds;
+		Client->ClientReservationResponse(EMultiplayerReservationResult::Accepted);
+		return;
+	}
+
+	if (Subsystem->GetHostOpenSlots() <= 0)
+	{
+		Client->ClientReservationResponse(EMultiplayerReservationResult::SessionFull);
+		return;
+	}
+
+	Reservations.Add({ PlayerId, ExpireSeconds });
+	Subsystem->AddReservedSlots(1);
+	Client->ClientReservationResponse(EMultiplayerReservationResult::Accepted);
+}
+
+bool AMultiplayerReservationBeaconHostObject::HasReservation(const FUniqueNetIdRepl& PlayerId) const
+{
+	return Reservations.ContainsByPredicate([&PlayerId](const FReservation& Reservation) { return Reservation.PlayerId == PlayerId; });
+}
+
+void AMultiplayerReservationBeaconHostObject::ConsumeReservation(const FUniqueNetIdRepl& PlayerId)
+{
+	const int32 NumRemoved = Reservations.RemoveAll([&PlayerId](const FReservation& Reservation) { return Reservation.PlayerId == PlayerId; });
+	if (NumRemoved > 0 && SessionsSubsystem.IsValid())
+	{
+		SessionsSubsystem->AddReservedSlots(-NumRemoved);
+	}
+}
+
+void AMultiplayerReservationBeaconHostObject::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	const double NowSeconds = FPlatformTime::Seconds();
+	const int32 NumExpired = Reservations.RemoveAll([NowSeconds](const FReservation& Reservation) { return Reservation.ExpireSeconds <= NowSeconds; });
+	if (NumExpired > 0)
+	{
+		UE_LOG(LogMultiplayerSessions, Log, TEXT("%d slot reservation(s) expired before the player arrived"), NumExpired);
+		if (SessionsSubsystem.IsValid())
+		{
+			SessionsSubsystem->AddReservedSlots(-NumExpired);
+		}
+	}
+}
+
+void AMultiplayerReservationBeaconHostObject::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	//맵 이동 등으로 사라지면 잡아둔 자리도 같이 돌려줌
+	if (Reservations.Num() > 0 && SessionsSubsystem.IsValid())
+	{
+		SessionsSubsystem->AddReservedSlots(-Reservations.Num());
+	}
+	Reservations.Reset();
+
+	Super::EndPlay(EndPlayReason);
+}
@@ -0,0 +1,153 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MultiplayerSessionIndex.h"
+#include "MultiplayerSessionNames.h"
+#include "OnlineSessionSettings.h"
+#include "Algo/Sort.h"
+
+void FMultiplayerSessionIndex::Build(const TArray<FOnlineSessionSearchResult>& SearchResults)
+{
+	Reset();
+
+	// Touch each heavy result exactly once, then sort the small rows instead of the results
+	struct FRow
+	{
+		uint32 MatchTypeHash;
+		FString MatchType;
+		int32 PingMs;
+		int32 OpenSlots;
+		int32 BuildId;
+		int32 ResultIndex;
+	};
+
+	const int32 NumResults = SearchResults.Num();
+	TArray<FRow> Rows;
+	Rows.Reserve(NumResults);
+	for (int32 ResultIndex = 0; ResultIndex < NumResults; ++ResultIndex)
+	{
+		const FOnlineSessionSearchResult& Result = SearchResults[ResultIndex];
+
+		FString MatchType;
+		Result.Session.SessionSettings.Get(SETTING_MATCHTYPE, MatchType);
+
+		const uint32 MatchTypeHash = HashMatchType(MatchType);
+		Rows.Add({
+			MatchTypeHash,
+			MoveTemp(MatchType),
+			Result.PingInMs,
+			GetOpenSlots(Result),
+			Result.Session.SessionSettings.BuildUniqueId,
+			ResultIndex
+		});
+	}
+
+	//핑이 낮은 순, 같으면 빈 슬롯이 많은 순
+	Algo::Sort(Rows, [](const FRow& A, const FRow& B)
+		{
+			if (A.PingMs != B.PingMs)
+			{
+				return A.PingMs < B.PingMs;
+			}
+			return A.OpenSlots > B.OpenSlots;
+		});
+
+	MatchTypeHashes.Reserve(NumResults);
+	MatchTypes.Reserve(NumResults);
+	PingsMs.Reserve(NumResults);
+	OpenSlots.Reserve(NumResults);
+	BuildIds.Reserve(NumResults);
+	ResultIndices.Reserve(NumResults);
+	for (FRow& Row : Rows)
+	{
+		MatchTypeHashes.Add(Row.MatchTypeHash);
+		MatchTypes.Add(MoveTemp(Row.MatchType));
+		PingsMs.Add(Row.PingMs);
+		OpenSlots.Add(Row.OpenSlots);
+		BuildIds.Add(Row.BuildId);
+		ResultIndices.Add(Row.ResultIndex);
+	}
+}
+
+void FMultiplayerSessionIndex::Reset()
+{
+	MatchTypeHashes.Reset();
+	MatchTypes.Reset();
+	PingsMs.Reset();
+	OpenSlots.Reset();
+	BuildIds.Reset();
+	ResultIndices.Reset();
+}
+
+void FMultiplayerSessionIndex::Empty()
+{
+	MatchTypeHashes.Empty();
+	MatchTypes.Empty();
+	PingsMs.Empty();
+	OpenSlots.Empty();
+	BuildIds.Empty();
+	ResultIndices.Empty();
+}
+
+SIZE_T FMultiplayerSessionIndex::GetAllocatedSize() const
+{
+	return MatchTypeHashes.GetAllocatedSize() + MatchTypes.GetAllocatedSize() + PingsMs.GetAllocatedSize() + OpenSlots.GetAllocatedSize()
+		+ BuildIds.GetAllocatedSize() + ResultIndices.GetAllocatedSize();
+}
+
+int32 FMultiplayerSessionIndex::SelectTopK(const FFilter& Filter, int32 K, TArray<int32>& OutResultIndices) const
+{
+	int32 NumSelected = 0;
+	for (int32 Row = 0; Row < ResultIndices.Num() && NumSelected < K; ++Row)
+	{
+		if (PassesFilter(Row, Filter))
+		{
+			OutResultIndices.Add(ResultIndices[Row]);
+			++NumSelected;
+		}
+	}
+	return NumSelected;
+}
+
+int32 FMultiplayerSessionIndex::GetOpenSlots(const FOnlineSessionSearchResult& SearchResult)
+{
+	//호스트가 직접 세서 올린 값이 있으면 예약된 자리까지 빠진 값이라 더 정확함
+	int32 AdvertisedOpenSlots = 0;
+	if (SearchResult.Session.SessionSettings.Get(SETTING_OPENSLOTS, AdvertisedOpenSlots))
+	{
+		return FMath::Min(AdvertisedOpenSlots, SearchResult.Session.NumOpenPublicConnections);
+	}
+	return SearchResult.Session.NumOpenPublicConnections;
+}
+
+uint32 FMultiplayerSessionIndex::HashMatchType(const FString& MatchType)
+{
+	// FString 비교가 대소문자를 무시하니 해시도 똑같이 맞춤
+	return GetTypeHash(MatchType);
+}
+
+bool FMultiplayerSessionIndex::PassesFilter(int32 Row, const FFilter& Filter) const
+{
+	if (!Filter.bAnyMatchType)
+	{
+		//해시가 같아도 충돌일수 있으니 문자열로 한번 더 확인
+		if (MatchTypeHashes[Row] != Filter.MatchTypeHash || !MatchTypes[Row].Equals(Filter.MatchType, ESearchCase::IgnoreCase))
+		{
+			return false;
+		}
+	}
+	if (OpenSlots[Row] < Filter.MinOpenSlots)
+	{
+		return false;
+	}
+	// Backends that can't measure ping report MAX_QUERY_PING, don't throw those away
+	if (Filter.MaxPingMs > 0 && PingsMs[Row] < MAX_QUERY_PING && PingsMs[Row] > Filter.MaxPingMs)
+	{
+		return false;
+	}
+	if (Filter.BuildId != 0 && BuildIds[Row] != Filter.BuildId)
+	{
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,190 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MultiplayerSessionsAsyncActions.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+
+void UMultiplayerSessionAsyncActionBase::Cancel()
+{
+	if (UMultiplayerSessionsSubsystem* Subsystem = SessionsSubsystem.Get())
+	{
+		Subsystem->CancelSessionOp(Handle);
+	}
+	SetReadyToDestroy();
+}
+
+UMultiplayerSessionsSubsystem* UMultiplayerSessionAsyncActionBase::GetSessionsSubsystem(const UObject* WorldContextObject)
+{
+	UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull) : nullptr;
+	UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+	return GameInstance ? GameInstance->GetSubsystem<UMultiplayerSessionsSubsystem>() : nullptr;
+}
+
+UMultiplayerSessionOpAsyncAction* UMultiplayerSessionOpAsyncAction::CreateMultiplayerSession(UObject* WorldContextObject, int32 NumPublicConnections, FString MatchType)
+{
+	UMultiplayerSessionOpAsyncAction* Action = MakeAction(WorldContextObject, EMultiplayerSessionOp::Create);
+	Action->NumPublicConnections = NumPublicConnections;
+	Action->MatchType = MatchType;
+	return Action;
+}
+
+UMultiplayerSessionOpAsyncAction* UMultiplayerSessionOpAsyncAction::DestroyMultiplayerSession(UObject* WorldContextObject)
+{
+	return MakeAction(WorldContextObject, EMultiplayerSessionOp::Destroy);
+}
+
+UMultiplayerSessionOpAsyncAction* UMultiplayerSessionOpAsyncAction::StartMultiplayerSession(UObject* WorldContextObject)
+{
+	return MakeAction(WorldContextObject, EMultiplayerSessionOp::Start);
+}
+
+UMultiplayerSessionOpAsyncAction* UMultiplayerSessionOpAsyncAction::MakeAction(UObject* WorldContextObject, EMultiplayerSessionOp InOp)
+{
+	UMultiplayerSessionOpAsyncAction* Action = NewObject<UMultiplayerSessionOpAsyncAction>();
+	Action->SessionsSubsystem = GetSessionsSubsystem(WorldContextObject);
+	Action->Op = InOp;
+	//핀이 불릴때까지 GC 되지 않게 게임 인스턴스에 등록
+	Action->RegisterWithGameInstance(WorldContextObject);
+	return Action;
+}
+
+void UMultiplayerSessionOpAsyncAction::Activate()
+{
+	UMultiplayerSessionsSubsystem* Subsystem = SessionsSubsystem.Get();
+	if (Subsystem == nullptr)
+	{
+		OnComplete(false);
+		return;
+	}
+
+	auto Continuation = [WeakThis = TWeakObjectPtr<UMultiplayerSessionOpAsyncAction>(this)](bool bWasSuccessful)
+	{
+		if (UMultiplayerSessionOpAsyncAction* Action = WeakThis.Get())
+		{
+			Action->OnComplete(bWasSuccessful);
+		}
+	};
+	switch (Op)
+	{
+	case EMultiplayerSessionOp::Create:
+		Handle = Subsystem->CreateSessionAsync(NumPublicConnections, MatchType, MoveTemp(Continuation));
+		break;
+	case EMultiplayerSessionOp::Destroy:
+		Handle = Subsystem->DestroySessionAsync(MoveTemp(Continuation));
+		break;
+	case EMultiplayerSessionOp::Start:
+		Handle = Subsystem->StartSessionAsync(MoveTemp(Continuation));
+		break;
+	default:
+		OnComplete(false);
+		break;
+	}
+}
+
+void UMultiplayerSessionOpAsyncAction::OnComplete(bool bWasSuccessful)
+{
+	Handle.Reset();
+	if (bWasSuccessful)
+	{
+		OnSuccess.Broadcast();
+	}
+	else
+	{
+		OnFailure.Broadcast();
+	}
+	SetReadyToDestroy();
+}
+
+UFindMultiplayerSessionsAsyncAction* UFindMultiplayerSessionsAsyncAction::FindMultiplayerSessions(UObject* WorldContextObject, const FMultiplayerSessionSearchParams& SearchParams, float TimeoutSeconds)
+{
+	UFindMultiplayerSessionsAsyncAction* Action = NewObject<UFindMultiplayerSessionsAsyncAction>();
+	Action->SessionsSubsystem = GetSessionsSubsystem(WorldContextObject);
+	Action->SearchParams = SearchParams;
+	Action->TimeoutSeconds = TimeoutSeconds;
+	Action->RegisterWithGameInstance(WorldContextObject);
+	return Action;
+}
+
+void UFindMultiplayerSessionsAsyncAction::Activate()
+{
+	UMultiplayerSessionsSubsystem* Subsystem = SessionsSubsystem.Get();
+	if (Subsystem == nullptr)
+	{
+		OnComplete(TArray<FOnlineSessionSearchResult>(), false, EMultiplayerFindSessionsOutcome::Failed);
+		return;
+	}
+
+	Handle = Subsystem->FindSessionsAsync(SearchParams, [WeakThis = TWeakObjectPtr<UFindMultiplayerSessionsAsyncAction>(this)](const TArray<FOnlineSessionSearchResult>& SessionResults, bool bWasSuccessful, EMultiplayerFindSessionsOutcome Outcome)
+		{
+			if (UFindMultiplayerSessionsAsyncAction* Action = WeakThis.Get())
+			{
+				Action->OnComplete(SessionResults, bWasSuccessful, Outcome);
+			}
+		}, false, TimeoutSeconds);
+}
+
+void UFindMultiplayerSessionsAsyncAction::OnComplete(const TArray<FOnlineSessionSearchResult>& SessionResults, bool bWasSuccessful, EMultiplayerFindSessionsOutcome Outcome)
+{
+	Handle.Reset();
+	//블루프린트로 넘길때만 감싸서 복사
+	TArray<FBlueprintSessionResult> Results;
+	Results.Reserve(SessionResults.Num());
+	for (const FOnlineSessionSearchResult& SessionResult : SessionResults)
+	{
+		Results.AddDefaulted_GetRef().OnlineResult = SessionResult;
+	}
+
+	if (bWasSuccessful)
+	{
+		OnSuccess.Broadcast(Results, Outcome);
+	}
+	else
+	{
+		OnFailure.Broadcast(Results, Outcome);
+	}
+	SetReadyToDestroy();
+}
+
+UJoinMultiplayerSessionAsyncAction* UJoinMultiplayerSessionAsyncAction::JoinMultiplayerSession(UObject* WorldContextObject, const FBlueprintSessionResult& SearchResult)
+{
+	UJoinMultiplayerSessionAsyncAction* Action = NewObject<UJoinMultiplayerSessionAsyncAction>();
+	Action->SessionsSubsystem = GetSessionsSubsystem(WorldContextObject);
+	Action->SearchResult = SearchResult;
+	Action->RegisterWithGameInstance(WorldContextObject);
+	return Action;
+}
+
+void UJoinMultiplayerSessionAsyncAction::Activate()
+{
+	UMultiplayerSessionsSubsystem* Subsystem = SessionsSubsystem.Get();
+	if (Subsystem == nullptr)
+	{
+		OnComplete(EOnJoinSessionCompleteResult::UnknownError);
+		return;
+	}
+
+	Handle = Subsystem->JoinSessionAsync(SearchResult.OnlineResult, [WeakThis = TWeakObjectPtr<UJoinMultiplayerSessionAsyncAction>(this)](EOnJoinSessionCompleteResult::Type Result)
+		{
+			if (UJoinMultiplayerSessionAsyncAction* Action = WeakThis.Get())
+			{
+				Action->OnComplete(Result);
+			}
+		});
+}
+
+void UJoinMultiplayerSessionAsyncAction::OnComplete(EOnJoinSessionCompleteResult::Type Result)
+{
+	Handle.Reset();
+	FString ConnectString;
+	UMultiplayerSessionsSubsystem* Subsystem = SessionsSubsystem.Get();
+	if (Result == EOnJoinSessionCompleteResult::Success && Subsystem && Subsystem->GetResolvedConnectString(ConnectString))
+	{
+		OnSuccess.Broadcast(ConnectString);
+	}
+	else
+	{
+		OnFailure.Broadcast(FString());
+	}
+	SetReadyToDestroy();
+}
@@ -0,0 +1,239 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MultiplayerFakeOnlineSession.h"
+#include "MultiplayerSessionsSubsystem.h"
+#include "MutiplayerSessions.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "Engine/Engine.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/MemoryBase.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/ScopeExit.h"
+
+#if !UE_BUILD_SHIPPING
+
+namespace MultiplayerSessionsBenchmark
+{
+	struct FOpSamples
+	{
+		const TCHAR* Name;
+		// 이 값을 넘으면 테스트 실패
+		double MaxP95Micros{ 0.0 };
+		double MaxAllocationsPerOp{ 0.0 };
+		TArray<double> Micros;
+		int64 NumAllocations{ 0 };
+		int32 NumFailures{ 0 };
+
+		double GetPercentile(double Percentile) const
+		{
+			if (Micros.Num() == 0)
+			{
+				return 0.0;
+			}
+			const int32 Rank = FMath::Clamp(FMath::CeilToInt(Percentile * Micros.Num()) - 1, 0, Micros.Num() - 1);
+			return Micros[Rank];
+		}
+	};
+
+	// 스탯 빌드의 할당 호출 수, 다른 스레드의 할당도 섞이니 상한은 넉넉하게 둠
+	static uint64 GetNumAllocationCalls()
+	{
+#if UE_STATS
+		return FMalloc::TotalMallocCalls + FMalloc::TotalReallocCalls;
+#else
+		return 0;
+#endif
+	}
+
+	static void RunBenchmark(UMultiplayerSessionsSubsystem& Subsystem, int32 NumCycles, const FMultiplayerFakeSessionConfig& Config, TArrayView<FOpSamples> Samples)
+	{
+		//완료를 바로 Flush 하므로 백엔드 지연은 빼고 서브시스템 자체의 비용만 잰다
+		TSharedRef<FMultiplayerFakeOnlineSession> FakeSession = MakeShared<FMultiplayerFakeOnlineSession>(Config);
+		Subsystem.SetSessionInterfaceOverride(FakeSession);
+
+		check(Samples.Num() == 4);
+		FOpSamples& CreateSamples = Samples[0];
+		FOpSamples& FindSamples = Samples[1];
+		FOpSamples& JoinSamples = Samples[2];
+		FOpSamples& DestroySamples = Samples[3];
+
+		auto Measure = [&Subsystem, &FakeSession](FOpSamples& OpSamples, EMultiplayerSessionOp Op, TFunctionRef<void()> Call)
+		{
+			const uint64 AllocationsBefore = GetNumAllocationCalls();
+			const double StartSeconds = FPlatformTime::Seconds();
+			Call();
+			FakeSession->Flush();
+			const double ElapsedSeconds = FPlatformTime::Seconds() - StartSeconds;
+
+			OpSamples.Micros.Add(ElapsedSeconds * 1000000.0);
+			OpSamples.NumAllocations += static_cast<int64>(GetNumAllocationCalls() - AllocationsBefore);
+			const bool bSucceeded = Subsystem.GetSessionOpStatus(Op) == EMultiplayerSessionOpStatus::Succeeded;
+			if (!bSucceeded)
+			{
+				++OpSamples.NumFailures;
+			}
+			return bSucceeded;
+		};
+
+		FMultiplayerSessionSearchParams SearchParams;
+		SearchParams.MatchType = Config.MatchTypes.Num() > 0 ? Config.MatchTypes[0] : FString();
+
+		for (int32 Cycle = 0; Cycle < NumCycles; ++Cycle)
+		{
+			// 호스트: 생성 후 파괴
+			if (Measure(CreateSamples, EMultiplayerSessionOp::Create, [&]() { Subsystem.CreateSession(Config.MaxPublicConnections, SearchParams.MatchType); }))
+			{
+				Measure(DestroySamples, EMultiplayerSessionOp::Destroy, [&]() { Subsystem.DestroySession(); });
+			}
+
+			// 클라이언트: 검색, 참가, 나가기. 캐시에서 바로 나오지 않게 매번 비움
+			Subsystem.ClearSearchCache();
+			Measure(FindSamples, EMultiplayerSessionOp::Find, [&]() { Subsystem.FindFilteredSessions(SearchParams); });
+			const FOnlineSessionSearchResult* BestResult = Subsystem.GetRankedSearchResult(0);
+			if (BestResult == nullptr)
+			{
+				continue;
+			}
+			const FOnlineSessionSearchResult JoinTarget = *BestResult;
+			if (Measure(JoinSamples, EMultiplayerSessionOp::Join, [&]() { Subsystem.JoinSession(JoinTarget); }))
+			{
+				Measure(DestroySamples, EMultiplayerSessionOp::Destroy, [&]() { Subsystem.DestroySession(); });
+			}
+		}
+
+		Subsystem.SetSessionInterfaceOverride(nullptr);
+
+		UE_LOG(LogMultiplayerSessions, Display, TEXT("Session benchmark: %d cycles, %d advertised sessions, failure rate %.2f, full rate %.2f"),
+			NumCycles, Config.NumAdvertisedSessions, Config.FailureRate, Config.FullSessionRate);
+		UE_LOG(LogMultiplayerSessions, Display, TEXT("%-8s %7s %7s %11s %10s %10s %10s %10s"), TEXT("Op"), TEXT("Count"), TEXT("Failed"), TEXT("Ops/sec"), TEXT("p50 us"), TEXT("p95 us"), TEXT("p99 us"), TEXT("Allocs/op"));
+		for (FOpSamples& OpSamples : Samples)
+		{
+			double TotalMicros = 0.0;
+			for (double Micros : OpSamples.Micros)
+			{
+				TotalMicros += Micros;
+			}
+			OpSamples.Micros.Sort();
+
+			const int32 NumOps = OpSamples.Micros.Num();
+			UE_LOG(LogMultiplayerSessions, Display, TEXT("%-8s %7d %7d %11.0f %10.1f %10.1f %10.1f %10.1f"),
+				OpSamples.Name,
+				NumOps,
+				OpSamples.NumFailures,
+				TotalMicros > 0.0 ? NumOps / (TotalMicros / 1000000.0) : 0.0,
+				OpSamples.GetPercentile(0.50),
+				OpSamples.GetPercentile(0.95),
+				OpSamples.GetPercentile(0.99),
+				GetAllocationsPerOp(OpSamples)
+			);
+		}
+	}
+
+	static double GetAllocationsPerOp(const FOpSamples& OpSamples)
+	{
+		return OpSamples.Micros.Num() > 0 ? static_cast<double>(OpSamples.NumAllocations) / OpSamples.Micros.Num() : 0.0;
+	}
+
+	static UMultiplayerSessionsSubsystem* GetSubsystem(UWorld* World)
+	{
+		UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+		return GameInstance ? GameInstance->GetSubsystem<UMultiplayerSessionsSubsystem>() : nullptr;
+	}
+
+	static FMultiplayerFakeSessionConfig ParseConfig(const TArray<FString>& Args, int32 FirstArg)
+	{
+		FMultiplayerFakeSessionConfig Config;
+		if (Args.IsValidIndex(FirstArg))
+		{
+			Config.NumAdvertisedSessions = FCString::Atoi(*Args[FirstArg]);
+		}
+		if (Args.IsValidIndex(FirstArg + 1))
+		{
+			Config.FailureRate = FCString::Atof(*Args[FirstArg + 1]);
+		}
+		if (Args.IsValidIndex(FirstArg + 2))
+		{
+			Config.FullSessionRate = FCString::Atof(*Args[FirstArg + 2]);
+		}
+		return Config;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMultiplayerSessionsBenchmarkTest, "MultiplayerSessions.Benchmark",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+bool FMultiplayerSessionsBenchmarkTest::RunTest(const FString& Parameters)
+{
+	using namespace MultiplayerSessionsBenchmark;
+
+	//실행중인 게임에 영향이 없게 테스트 전용 게임 인스턴스를 띄움
+	UGameInstance* GameInstance = NewObject<UGameInstance>(GEngine);
+	GameInstance->InitializeStandalone();
+	UWorld* World = GameInstance->GetWorld();
+	ON_SCOPE_EXIT
+	{
+		GameInstance->Shutdown();
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+	};
+	UMultiplayerSessionsSubsystem* Subsystem = GetSubsystem(World);
+	if (!TestNotNull(TEXT("Sessions subsystem"), Subsystem))
+	{
+		return false;
+	}
+
+	//실패와 꽉 찬 세션이 없어야 모든 단계가 성공해야 한다고 볼 수 있음
+	FMultiplayerFakeSessionConfig Config;
+	Config.NumAdvertisedSessions = 2000;
+	Config.FailureRate = 0.f;
+	Config.FullSessionRate = 0.f;
+	Config.LatencySeconds = 0.f;
+
+	FOpSamples Samples[] = {
+		{ TEXT("Create"), 500.0, 200.0 },
+		{ TEXT("Find"), 20000.0, 20000.0 },
+		{ TEXT("Join"), 500.0, 200.0 },
+		{ TEXT("Destroy"), 500.0, 200.0 } };
+	RunBenchmark(*Subsystem, 200, Config, Samples);
+
+	for (const FOpSamples& OpSamples : Samples)
+	{
+		TestEqual(FString::Printf(TEXT("%s failures"), OpSamples.Name), OpSamples.NumFailures, 0);
+		TestTrue(FString::Printf(TEXT("%s ran"), OpSamples.Name), OpSamples.Micros.Num() > 0);
+		//정렬된 샘플에서 읽음
+		const double P95Micros = OpSamples.GetPercentile(0.95);
+		TestTrue(FString::Printf(TEXT("%s p95 %.1f us <= %.1f us"), OpSamples.Name, P95Micros, OpSamples.MaxP95Micros), P95Micros <= OpSamples.MaxP95Micros);
+#if UE_STATS
+		const double AllocationsPerOp = GetAllocationsPerOp(OpSamples);
+		TestTrue(FString::Printf(TEXT("%s allocations/op %.1f <= %.1f"), OpSamples.Name, AllocationsPerOp, OpSamples.MaxAllocationsPerOp), AllocationsPerOp <= OpSamples.MaxAllocationsPerOp);
+#endif
+	}
+	return true;
+}
+
+static FAutoConsoleCommandWithWorldAndArgs MultiplayerSessionsFakeBackendCommand(
+	TEXT("MultiplayerSessions.FakeBackend"),
+	TEXT("Routes the session subsystem to the in-process fake backend so the menu works without Steam. ")
+	TEXT("Args: 0 to restore, or [LatencyMs=50] [NumSessions=2000] [FailureRate=0] [FullRate=0.1]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			UMultiplayerSessionsSubsystem* Subsystem = MultiplayerSessionsBenchmark::GetSubsystem(World);
+			if (Subsystem == nullptr)
+			{
+				return;
+			}
+			if (Args.IsValidIndex(0) && Args[0] == TEXT("0"))
+			{
+				Subsystem->SetSessionInterfaceOverride(nullptr);
+				return;
+			}
+
+			FMultiplayerFakeSessionConfig Config = MultiplayerSessionsBenchmark::ParseConfig(Args, 1);
+			Config.LatencySeconds = Args.IsValidIndex(0) ? FCString::Atof(*Args[0]) / 1000.f : 0.05f;
+			Subsystem->SetSessionInterfaceOverride(MakeShared<FMultiplayerFakeOnlineSession>(Config));
+		})
+);
+
+#endif
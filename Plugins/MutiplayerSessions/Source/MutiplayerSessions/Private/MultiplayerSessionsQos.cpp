@@ -0,0 +1,295 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MultiplayerSessionsQos.h"
+#include "MutiplayerSessions.h"
+#include "Async/Async.h"
+#include "Common/UdpSocketBuilder.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/RunnableThread.h"
+#include "Interfaces/IPv4/IPv4Address.h"
+#include "IPAddress.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+
+namespace MultiplayerQos
+{
+	static constexpr uint32 PacketMagic = 0x5351504D; // "MPQS"
+
+	struct FProbePacket
+	{
+		uint32 Magic;
+		uint16 HostIndex;
+		uint16 Sequence;
+		uint32 Nonce;
+	};
+
+	// 라운드 사이 간격, 모든 호스트에는 한 라운드에 동시에 보냄
+	static constexpr double ProbeRoundIntervalSeconds = 0.01;
+}
+
+FMultiplayerQosResponder::~FMultiplayerQosResponder()
+{
+	Shutdown();
+}
+
+bool FMultiplayerQosResponder::Start(int32 Port)
+{
+	if (IsRunning())
+	{
+		return true;
+	}
+
+	//AsReusable 이면 같은 머신의 두 서버가 한 포트에 붙어서 패킷을 나눠 받으니 쓰지 않음
+	auto BindSocket = [](int32 BindPort)
+		{
+			return FUdpSocketBuilder(TEXT("MultiplayerQosResponder"))
+				.AsNonBlocking()
+				.BoundToAddress(FIPv4Address::Any)
+				.BoundToPort(BindPort)
+				.Build();
+		};
+	Socket = BindSocket(Port);
+	if (Socket == nullptr && Port != 0)
+	{
+		UE_LOG(LogMultiplayerSessions, Log, TEXT("QoS responder could not bind port %d, letting the OS pick one"), Port);
+		Socket = BindSocket(0);
+	}
+	if (Socket == nullptr)
+	{
+		UE_LOG(LogMultiplayerSessions, Warning, TEXT("QoS responder could not bind a port"));
+		return false;
+	}
+	BoundPort = Socket->GetPortNo();
+
+	bStopping = false;
+	Thread = FRunnableThread::Create(this, TEXT("MultiplayerQosResponder"), 0, TPri_AboveNormal);
+	return Thread != nullptr;
+}
+
+void FMultiplayerQosResponder::Shutdown()
+{
+	if (Thread)
+	{
+		Thread->Kill(true);
+		delete Thread;
+		Thread = nullptr;
+	}
+	if (Socket)
+	{
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Socket);
+		Socket = nullptr;
+	}
+	BoundPort = 0;
+}
+
+uint32 FMultiplayerQosResponder::Run()
+{
+	ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	TSharedRef<FInternetAddr> FromAddress = SocketSubsystem->CreateInternetAddr();
+	MultiplayerQos::FProbePacket Packet;
+
+	while (!bStopping)
+	{
+		if (!Socket->Wait(ESocketWaitConditions::WaitForRead, FTimespan::FromMilliseconds(50)))
+		{
+			continue;
+		}
+
+		int32 BytesRead = 0;
+		while (Socket->RecvFrom(reinterpret_cast<uint8*>(&Packet), sizeof(Packet), BytesRead, *FromAddress))
+		{
+			if (BytesRead == sizeof(Packet) && Packet.Magic == MultiplayerQos::PacketMagic)
+			{
+				int32 BytesSent = 0;
+				Socket->SendTo(reinterpret_cast<const uint8*>(&Packet), sizeof(Packet), BytesSent, *FromAddress);
+			}
+		}
+	}
+	return 0;
+}
+
+void FMultiplayerQosResponder::Stop()
+{
+	bStopping = true;
+}
+
+void FMultiplayerQosProbe::ProbeAsync(TArray<FString> HostAddresses, int32 ProbesPerHost, float TimeoutSeconds, TFunction<void(TArray<FMultiplayerQosResult>&&)> OnComplete)
+{
+	Async(EAsyncExecution::ThreadPool, [HostAddresses = MoveTemp(HostAddresses), ProbesPerHost, TimeoutSeconds, OnComplete = MoveTemp(OnComplete)]() mutable
+		{
+			TArray<FMultiplayerQosResult> Results = Probe(HostAddresses, ProbesPerHost, TimeoutSeconds);
+			AsyncTask(ENamedThreads::GameThread, [Results = MoveTemp(Results), OnComplete = MoveTemp(OnComplete)]() mutable
+				{
+					OnComplete(MoveTemp(Results));
+				});
+		});
+}
+
+TArray<FMultiplayerQosResult> FMultiplayerQosProbe::Probe(const TArray<FString>& HostAddresses, int32 ProbesPerHost, float TimeoutSeconds)
+{
+	const int32 NumHosts = HostAddresses.Num();
+	TArray<FMultiplayerQosResult> Results;
+	Results.SetNum(NumHosts);
+	for (int32 HostIndex = 0; HostIndex < NumHosts; ++HostIndex)
+	{
+		Results[HostIndex].Address = HostAddresses[HostIndex];
+	}
+
+	ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	if (SocketSubsystem == nullptr || NumHosts == 0 || ProbesPerHost <= 0)
+	{
+		return Results;
+	}
+
+	TArray<TSharedPtr<FInternetAddr>> Addresses;
+	Addresses.SetNum(NumHosts);
+	for (int32 HostIndex = 0; HostIndex < NumHosts; ++HostIndex)
+	{
+		Addresses[HostIndex] = SocketSubsystem->GetAddressFromString(HostAddresses[HostIndex]);
+	}
+
+	FSocket* Socket = FUdpSocketBuilder(TEXT("MultiplayerQosProbe")).AsNonBlocking().Build();
+	if (Socket == nullptr)
+	{
+		return Results;
+	}
+
+	// 보낸 시간과 측정된 RTT, -1 은 아직 응답이 없음
+	const int32 NumSamples = NumHosts * ProbesPerHost;
+	TArray<double> SendTimes;
+	SendTimes.SetNumZeroed(NumSamples);
+	TArray<double> RttSeconds;
+	RttSeconds.Init(-1.0, NumSamples);
+
+	const uint32 Nonce = FMath::Rand();
+	const double StartTime = FPlatformTime::Seconds();
+	const double Deadline = StartTime + TimeoutSeconds;
+	double NextRoundTime = StartTime;
+	int32 NextSequence = 0;
+	int32 NumExpected = 0;
+	int32 NumReceived = 0;
+
+	TSharedRef<FInternetAddr> FromAddress = SocketSubsystem->CreateInternetAddr();
+	MultiplayerQos::FProbePacket Packet;
+
+	for (double Now = StartTime; Now < Deadline; Now = FPlatformTime::Seconds())
+	{
+		if (NextSequence < ProbesPerHost && Now >= NextRoundTime)
+		{
+			for (int32 HostIndex = 0; HostIndex < NumHosts; ++HostIndex)
+			{
+				if (!Addresses[HostIndex].IsValid())
+				{
+					continue;
+				}
+				Packet = { MultiplayerQos::PacketMagic, static_cast<uint16>(HostIndex), static_cast<uint16>(NextSequence), Nonce };
+				int32 BytesSent = 0;
+				SendTimes[HostIndex * ProbesPerHost + NextSequence] = FPlatformTime::Seconds();
+				if (Socket->SendTo(reinterpret_cast<const uint8*>(&Packet), sizeof(Packet), BytesSent, *Addresses[HostIndex]))
+				{
+					++Results[HostIndex].NumSent;
+					++NumExpected;
+				}
+			}
+			++NextSequence;
+			NextRoundTime += MultiplayerQos::ProbeRoundIntervalSeconds;
+		}
+
+		if (NextSequence >= ProbesPerHost && NumReceived >= NumExpected)
+		{
+			break;
+		}
+
+		const double WaitUntil = NextSequence < ProbesPerHost ? FMath::Min(NextRoundTime, Deadline) : Deadline;
+		const double WaitSeconds = FMath::Max(WaitUntil - FPlatformTime::Seconds(), 0.0);
+		if (!Socket->Wait(ESocketWaitConditions::WaitForRead, FTimespan::FromSeconds(WaitSeconds)))
+		{
+			continue;
+		}
+
+		int32 BytesRead = 0;
+		while (Socket->RecvFrom(reinterpret_cast<uint8*>(&Packet), sizeof(Packet), BytesRead, *FromAddress))
+		{
+			const double ReceiveTime = FPlatformTime::Seconds();
+			if (BytesRead != sizeof(Packet) || Packet.Magic != MultiplayerQos::PacketMagic || Packet.Nonce != Nonce
+				|| Packet.HostIndex >= NumHosts || Packet.Sequence >= ProbesPerHost)
+			{
+				continue;
+			}
+			const int32 SampleIndex = Packet.HostIndex * ProbesPerHost + Packet.Sequence;
+			if (RttSeconds[SampleIndex] < 0.0)
+			{
+				RttSeconds[SampleIndex] = ReceiveTime - SendTimes[SampleIndex];
+				++NumReceived;
+			}
+		}
+	}
+	SocketSubsystem->DestroySocket(Socket);
+
+	for (int32 HostIndex = 0; HostIndex < NumHosts; ++HostIndex)
+	{
+		FMultiplayerQosResult& Result = Results[HostIndex];
+		double RttSum = 0.0;
+		double JitterSum = 0.0;
+		double PreviousRtt = -1.0;
+		int32 NumJitterSamples = 0;
+		for (int32 Sequence = 0; Sequence < ProbesPerHost; ++Sequence)
+		{
+			const double Rtt = RttSeconds[HostIndex * ProbesPerHost + Sequence];
+			if (Rtt < 0.0)
+			{
+				continue;
+			}
+			RttSum += Rtt;
+			++Result.NumReceived;
+			if (PreviousRtt >= 0.0)
+			{
+				JitterSum += FMath::Abs(Rtt - PreviousRtt);
+				++NumJitterSamples;
+			}
+			PreviousRtt = Rtt;
+		}
+		if (Result.NumReceived > 0)
+		{
+			Result.RttMs = static_cast<float>(RttSum / Result.NumReceived * 1000.0);
+			Result.JitterMs = NumJitterSamples > 0 ? static_cast<float>(JitterSum / NumJitterSamples * 1000.0) : 0.f;
+		}
+	}
+	return Results;
+}
+
+// 스팀 없이 루프백에서 응답기 여러개를 띄워서 측정
+static FAutoConsoleCommand MultiplayerQosBenchCommand(
+	TEXT("MultiplayerSessions.QosBench"),
+	TEXT("Probes local QoS responders on loopback. Args: [NumHosts=8] [ProbesPerHost=5] [BasePort=17787]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			const int32 NumHosts = Args.IsValidIndex(0) ? FCString::Atoi(*Args[0]) : 8;
+			const int32 ProbesPerHost = Args.IsValidIndex(1) ? FCString::Atoi(*Args[1]) : 5;
+			const int32 BasePort = Args.IsValidIndex(2) ? FCString::Atoi(*Args[2]) : 17787;
+
+			TArray<TUniquePtr<FMultiplayerQosResponder>> Responders;
+			TArray<FString> Addresses;
+			for (int32 HostIndex = 0; HostIndex < NumHosts; ++HostIndex)
+			{
+				TUniquePtr<FMultiplayerQosResponder> Responder = MakeUnique<FMultiplayerQosResponder>();
+				if (Responder->Start(BasePort + HostIndex))
+				{
+					Addresses.Add(FString::Printf(TEXT("127.0.0.1:%d"), Responder->GetPort()));
+					Responders.Add(MoveTemp(Responder));
+				}
+			}
+
+			const double StartTime = FPlatformTime::Seconds();
+			const TArray<FMultiplayerQosResult> Results = FMultiplayerQosProbe::Probe(Addresses, ProbesPerHost, 1.f);
+			const double ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+			for (const FMultiplayerQosResult& Result : Results)
+			{
+				UE_LOG(LogMultiplayerSessions, Display, TEXT("%s rtt %.3f ms jitter %.3f ms (%d/%d)"),
+					*Result.Address, Result.RttMs, Result.JitterMs, Result.NumReceived, Result.NumSent);
+			}
+			UE_LOG(LogMultiplayerSessions, Display, TEXT("Probed %d hosts x %d probes in %.2f ms"), Results.Num(), ProbesPerHost, ElapsedMs);
+		})
+);
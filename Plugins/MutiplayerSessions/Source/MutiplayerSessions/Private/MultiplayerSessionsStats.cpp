@@ -0,0 +1,306 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MultiplayerSessionsStats.h"
+#include "MutiplayerSessions.h"
+#include "HAL/IConsoleManager.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "ProfilingDebugging/MiscTrace.h"
+#include "UObject/UObjectGlobals.h"
+
+CSV_DEFINE_CATEGORY(MultiplayerSessions, true);
+
+DEFINE_STAT(STAT_MultiplayerSearchResultsMemory);
+DEFINE_STAT(STAT_MultiplayerStoredSearchResults);
+
+void FMultiplayerLatencyHistogram::AddSample(double Milliseconds)
+{
+	Milliseconds = FMath::Max(Milliseconds, 0.0);
+	++Buckets[GetBucketIndex(Milliseconds)];
+	MinMs = NumSamples > 0 ? FMath::Min(MinMs, Milliseconds) : Milliseconds;
+	MaxMs = NumSamples > 0 ? FMath::Max(MaxMs, Milliseconds) : Milliseconds;
+	SumMs += Milliseconds;
+	++NumSamples;
+}
+
+void FMultiplayerLatencyHistogram::Reset()
+{
+	*this = FMultiplayerLatencyHistogram();
+}
+
+double FMultiplayerLatencyHistogram::GetPercentile(double Percentile) const
+{
+	if (NumSamples == 0)
+	{
+		return 0.0;
+	}
+
+	const uint32 Rank = FMath::Max<uint32>(1, FMath::CeilToInt(FMath::Clamp(Percentile, 0.0, 1.0) * NumSamples));
+	uint32 Seen = 0;
+	for (int32 BucketIndex = 0; BucketIndex < NumBuckets; ++BucketIndex)
+	{
+		Seen += Buckets[BucketIndex];
+		if (Seen >= Rank)
+		{
+			//버킷 경계가 실제 최대값보다 크게 나오지 않게
+			return FMath::Min(GetBucketUpperBound(BucketIndex), MaxMs);
+		}
+	}
+	return MaxMs;
+}
+
+int32 FMultiplayerLatencyHistogram::GetBucketIndex(double Milliseconds)
+{
+	if (Milliseconds <= FirstBucketMs)
+	{
+		return 0;
+	}
+	const int32 BucketIndex = FMath::CeilToInt(FMath::Loge(Milliseconds / FirstBucketMs) / FMath::Loge(BucketGrowth));
+	return FMath::Clamp(BucketIndex, 0, NumBuckets - 1);
+}
+
+double FMultiplayerLatencyHistogram::GetBucketUpperBound(int32 BucketIndex)
+{
+	return FirstBucketMs * FMath::Pow(BucketGrowth, static_cast<double>(BucketIndex));
+}
+
+FMultiplayerSessionsStats::FMultiplayerSessionsStats()
+{
+	//단계가 늘어도 초기값을 따로 맞출 필요 없게 여기서 채움
+	for (double& PhaseSeconds : StartupPhaseSeconds)
+	{
+		PhaseSeconds = -1.0;
+	}
+}
+
+FMultiplayerSessionsStats& FMultiplayerSessionsStats::Get()
+{
+	static FMultiplayerSessionsStats Stats;
+	return Stats;
+}
+
+void FMultiplayerSessionsStats::Startup()
+{
+	//맵 로드가 끝나는 시점이 이동(Travel)의 끝
+	PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddRaw(this, &FMultiplayerSessionsStats::OnPostLoadMap);
+	//코어 티커가 처음 돌때가 첫 프레임, 시작 맵 로드는 그 전에 끝남
+	FirstFrameTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FMultiplayerSessionsStats::OnFirstFrame));
+}
+
+void FMultiplayerSessionsStats::Shutdown()
+{
+	FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+	PostLoadMapHandle.Reset();
+	FTSTicker::GetCoreTicker().RemoveTicker(FirstFrameTickerHandle);
+	FirstFrameTickerHandle.Reset();
+}
+
+void FMultiplayerSessionsStats::BeginTimer(EMultiplayerSessionTimer Timer)
+{
+	FTimerSlot& Slot = Slots[static_cast<int32>(Timer)];
+	if (Slot.bRunning)
+	{
+		TRACE_END_REGION(GetTimerName(Timer));
+	}
+	Slot.bRunning = true;
+	Slot.StartSeconds = FPlatformTime::Seconds();
+	TRACE_BEGIN_REGION(GetTimerName(Timer));
+}
+
+void FMultiplayerSessionsStats::EndTimer(EMultiplayerSessionTimer Timer, bool bWasSuccessful)
+{
+	FTimerSlot& Slot = Slots[static_cast<int32>(Timer)];
+	if (!Slot.bRunning)
+	{
+		return;
+	}
+	Slot.bRunning = false;
+	TRACE_END_REGION(GetTimerName(Timer));
+
+	if (!bWasSuccessful)
+	{
+		++Slot.NumFailures;
+		return;
+	}
+	AddSample(Timer, (FPlatformTime::Seconds() - Slot.StartSeconds) * 1000.0);
+}
+
+void FMultiplayerSessionsStats::CancelTimer(EMultiplayerSessionTimer Timer)
+{
+	FTimerSlot& Slot = Slots[static_cast<int32>(Timer)];
+	if (Slot.bRunning)
+	{
+		Slot.bRunning = false;
+		TRACE_END_REGION(GetTimerName(Timer));
+	}
+}
+
+bool FMultiplayerSessionsStats::IsTimerRunning(EMultiplayerSessionTimer Timer) const
+{
+	return Slots[static_cast<int32>(Timer)].bRunning;
+}
+
+void FMultiplayerSessionsStats::AddSample(EMultiplayerSessionTimer Timer, double Milliseconds)
+{
+	Slots[static_cast<int32>(Timer)].Histogram.AddSample(Milliseconds);
+
+#if CSV_PROFILER
+	static const FName CsvStatNames[] =
+	{
+		TEXT("CreateSessionMs"),
+		TEXT("FindSessionsMs"),
+		TEXT("JoinSessionMs"),
+		TEXT("DestroySessionMs"),
+		TEXT("StartSessionMs"),
+		TEXT("UpdateSessionMs"),
+		TEXT("ResolveConnectStringMs"),
+		TEXT("MapPrewarmMs"),
+		TEXT("TravelMs"),
+		TEXT("TimeToLobbyMs"),
+		TEXT("OnlineInitMs"),
+	};
+	static_assert(UE_ARRAY_COUNT(CsvStatNames) == static_cast<int32>(EMultiplayerSessionTimer::MAX), "CSV stat names out of sync with EMultiplayerSessionTimer");
+	FCsvProfiler::RecordCustomStat(CsvStatNames[static_cast<int32>(Timer)], CSV_CATEGORY_INDEX(MultiplayerSessions), Milliseconds, ECsvCustomStatOp::Set);
+#endif
+
+	UE_LOG(LogMultiplayerSessions, Verbose, TEXT("%s took %.2f ms"), GetTimerName(Timer), Milliseconds);
+}
+
+void FMultiplayerSessionsStats::MarkStartupPhase(EMultiplayerStartupPhase Phase)
+{
+	double& PhaseSeconds = StartupPhaseSeconds[static_cast<int32>(Phase)];
+	if (PhaseSeconds >= 0.0)
+	{
+		return;
+	}
+	PhaseSeconds = FPlatformTime::Seconds() - GStartTime;
+
+	TRACE_BOOKMARK(TEXT("%s"), GetStartupPhaseName(Phase));
+	CSV_EVENT(MultiplayerSessions, TEXT("%s"), GetStartupPhaseName(Phase));
+	UE_LOG(LogMultiplayerSessions, Log, TEXT("%s reached %.3f s after process start"), GetStartupPhaseName(Phase), PhaseSeconds);
+}
+
+double FMultiplayerSessionsStats::GetStartupPhaseSeconds(EMultiplayerStartupPhase Phase) const
+{
+	return StartupPhaseSeconds[static_cast<int32>(Phase)];
+}
+
+void FMultiplayerSessionsStats::SetSearchMemory(int32 NumStoredResults, SIZE_T AllocatedBytes)
+{
+	NumStoredSearchResults = NumStoredResults;
+	SearchMemoryBytes = AllocatedBytes;
+	PeakSearchMemoryBytes = FMath::Max(PeakSearchMemoryBytes, AllocatedBytes);
+
+	SET_MEMORY_STAT(STAT_MultiplayerSearchResultsMemory, AllocatedBytes);
+	SET_DWORD_STAT(STAT_MultiplayerStoredSearchResults, NumStoredResults);
+	CSV_CUSTOM_STAT(MultiplayerSessions, SearchResultsKB, static_cast<float>(AllocatedBytes / 1024.0), ECsvCustomStatOp::Set);
+}
+
+const FMultiplayerLatencyHistogram& FMultiplayerSessionsStats::GetHistogram(EMultiplayerSessionTimer Timer) const
+{
+	return Slots[static_cast<int32>(Timer)].Histogram;
+}
+
+void FMultiplayerSessionsStats::DumpToLog() const
+{
+	UE_LOG(LogMultiplayerSessions, Display, TEXT("%-22s %7s %7s %10s %10s %10s %10s %10s"), TEXT("Phase"), TEXT("Count"), TEXT("Failed"), TEXT("p50 ms"), TEXT("p95 ms"), TEXT("p99 ms"), TEXT("Max ms"), TEXT("Mean ms"));
+	for (int32 TimerIndex = 0; TimerIndex < static_cast<int32>(EMultiplayerSessionTimer::MAX); ++TimerIndex)
+	{
+		const FTimerSlot& Slot = Slots[TimerIndex];
+		const FMultiplayerLatencyHistogram& Histogram = Slot.Histogram;
+		UE_LOG(LogMultiplayerSessions, Display, TEXT("%-22s %7d %7d %10.2f %10.2f %10.2f %10.2f %10.2f"),
+			GetTimerName(static_cast<EMultiplayerSessionTimer>(TimerIndex)),
+			Histogram.Num(),
+			Slot.NumFailures,
+			Histogram.GetPercentile(0.50),
+			Histogram.GetPercentile(0.95),
+			Histogram.GetPercentile(0.99),
+			Histogram.GetMax(),
+			Histogram.GetMean()
+		);
+	}
+	UE_LOG(LogMultiplayerSessions, Display, TEXT("Search results: %d stored, %.1f KB resident, %.1f KB peak"),
+		NumStoredSearchResults, SearchMemoryBytes / 1024.0, PeakSearchMemoryBytes / 1024.0);
+	for (int32 PhaseIndex = 0; PhaseIndex < NumStartupPhases; ++PhaseIndex)
+	{
+		const double PhaseSeconds = StartupPhaseSeconds[PhaseIndex];
+		if (PhaseSeconds >= 0.0)
+		{
+			UE_LOG(LogMultiplayerSessions, Display, TEXT("%-22s %10.3f s"), GetStartupPhaseName(static_cast<EMultiplayerStartupPhase>(PhaseIndex)), PhaseSeconds);
+		}
+		else
+		{
+			UE_LOG(LogMultiplayerSessions, Display, TEXT("%-22s %10s"), GetStartupPhaseName(static_cast<EMultiplayerStartupPhase>(PhaseIndex)), TEXT("-"));
+		}
+	}
+}
+
+void FMultiplayerSessionsStats::Reset()
+{
+	for (FTimerSlot& Slot : Slots)
+	{
+		Slot.Histogram.Reset();
+		Slot.NumFailures = 0;
+	}
+}
+
+const TCHAR* FMultiplayerSessionsStats::GetTimerName(EMultiplayerSessionTimer Timer)
+{
+	switch (Timer)
+	{
+	case EMultiplayerSessionTimer::CreateSession:			return TEXT("MPS.CreateSession");
+	case EMultiplayerSessionTimer::FindSessions:			return TEXT("MPS.FindSessions");
+	case EMultiplayerSessionTimer::JoinSession:				return TEXT("MPS.JoinSession");
+	case EMultiplayerSessionTimer::DestroySession:			return TEXT("MPS.DestroySession");
+	case EMultiplayerSessionTimer::StartSession:			return TEXT("MPS.StartSession");
+	case EMultiplayerSessionTimer::UpdateSession:			return TEXT("MPS.UpdateSession");
+	case EMultiplayerSessionTimer::ResolveConnectString:	return TEXT("MPS.ResolveConnectString");
+	case EMultiplayerSessionTimer::MapPrewarm:				return TEXT("MPS.MapPrewarm");
+	case EMultiplayerSessionTimer::Travel:					return TEXT("MPS.Travel");
+	case EMultiplayerSessionTimer::TimeToLobby:				return TEXT("MPS.TimeToLobby");
+	case EMultiplayerSessionTimer::OnlineInit:				return TEXT("MPS.OnlineInit");
+	default:												return TEXT("MPS.Unknown");
+	}
+}
+
+const TCHAR* FMultiplayerSessionsStats::GetStartupPhaseName(EMultiplayerStartupPhase Phase)
+{
+	switch (Phase)
+	{
+	case EMultiplayerStartupPhase::ModuleStartup:			return TEXT("MPS.Boot.ModuleStartup");
+	case EMultiplayerStartupPhase::SubsystemInitialize:		return TEXT("MPS.Boot.SubsystemInitialize");
+	case EMultiplayerStartupPhase::StartupMapLoaded:		return TEXT("MPS.Boot.StartupMapLoaded");
+	case EMultiplayerStartupPhase::FirstFrame:				return TEXT("MPS.Boot.FirstFrame");
+	case EMultiplayerStartupPhase::OnlineReady:				return TEXT("MPS.Boot.OnlineReady");
+	default:												return TEXT("MPS.Boot.Unknown");
+	}
+}
+
+void FMultiplayerSessionsStats::OnPostLoadMap(UWorld* LoadedWorld)
+{
+	EndTimer(EMultiplayerSessionTimer::Travel, LoadedWorld != nullptr);
+	EndTimer(EMultiplayerSessionTimer::TimeToLobby, LoadedWorld != nullptr);
+	MarkStartupPhase(EMultiplayerStartupPhase::StartupMapLoaded);
+}
+
+bool FMultiplayerSessionsStats::OnFirstFrame(float DeltaTime)
+{
+	FirstFrameTickerHandle.Reset();
+	MarkStartupPhase(EMultiplayerStartupPhase::FirstFrame);
+	return false;
+}
+
+static FAutoConsoleCommand GMultiplayerSessionsLatencyStatsCommand(
+	TEXT("MultiplayerSessions.LatencyStats"),
+	TEXT("Prints p50/p95/p99 latency of every session phase and when each boot phase was reached. Pass 'reset' to clear the histograms."),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			FMultiplayerSessionsStats& Stats = FMultiplayerSessionsStats::Get();
+			if (Args.Num() > 0 && Args[0].Equals(TEXT("reset"), ESearchCase::IgnoreCase))
+			{
+				Stats.Reset();
+				return;
+			}
+			Stats.DumpToLog();
+		})
+);
@@ -2,9 +2,23 @@
 
 
 #include "MultiplayerSessionsSubsystem.h"
+#include "MultiplayerSessionNames.h"
+#include "MutiplayerSessions.h"
 #include "OnlineSubsystem.h"
 #include "OnlineSessionSettings.h"
 #include "Online/OnlineSessionNames.h"
+#include "IPAddress.h"
+#include "SocketSubsystem.h"
+#include "Algo/StableSort.h"
+#include "Misc/PackageName.h"
+#include "Misc/CommandLine.h"
+#include "Misc/NetworkVersion.h"
+#include "Engine/World.h"
+#include "UObject/UObjectGlobals.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "OnlineBeaconHost.h"
 
 
 UMultiplayerSessionsSubsystem::UMultiplayerSessionsSubsystem() :
@@ -12,189 +26,2267 @@ UMultiplayerSessionsSubsystem::UMultiplayerSessionsSubsystem() :
 	FindSessionCompletedDelegate(FOnFindSessionsCompleteDelegate::CreateUObject(this, &ThisClass::OnFindSessionComplete)),
 	JoinSessionCompletedDelegate(FOnJoinSessionCompleteDelegate::CreateUObject(this, &ThisClass::OnJoinSessionComplete)),
 	DestroySessionCompletedDelegate(FOnDestroySessionCompleteDelegate::CreateUObject(this, &ThisClass::OnDestroySessionComplete)),
-	StartSessionCompletedDelegate(FOnStartSessionCompleteDelegate::CreateUObject(this,&ThisClass::OnStartSessionComplete))
+	StartSessionCompletedDelegate(FOnStartSessionCompleteDelegate::CreateUObject(this,&ThisClass::OnStartSessionComplete)),
+	CancelFindSessionsCompletedDelegate(FOnCancelFindSessionsCompleteDelegate::CreateUObject(this, &ThisClass::OnCancelFindSessionsComplete)),
+	UpdateSessionCompletedDelegate(FOnUpdateSessionCompleteDelegate::CreateUObject(this, &ThisClass::OnUpdateSessionComplete))
 
 {
+	//CDO 도 이 생성자를 거치니 온라인 서브시스템(스팀)은 여기서 띄우지 않음, EnsureSessionInterface 에서 필요할때 띄움
+}
+
+void UMultiplayerSessionsSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	FMultiplayerSessionsStats::Get().MarkStartupPhase(EMultiplayerStartupPhase::SubsystemInitialize);
+
+	PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &ThisClass::OnPostLoadMap);
+	GameModePreLoginHandle = FGameModeEvents::GameModePreLoginEvent.AddUObject(this, &ThisClass::OnGameModePreLogin);
+	GameModePostLoginHandle = FGameModeEvents::GameModePostLoginEvent.AddUObject(this, &ThisClass::OnGameModePostLogin);
+	GameModeLogoutHandle = FGameModeEvents::GameModeLogoutEvent.AddUObject(this, &ThisClass::OnGameModeLogout);
+
+	ApplyCommandLinePorts();
+	if (IsRunningDedicatedServer() && bRegisterDedicatedSession)
+	{
+		//아직 월드도 넷 드라이버도 없음, 세션은 OnPostLoadMap 에서 등록하고 온라인만 먼저 띄움
+		EnsureSessionInterface();
+	}
+	else if (OnlineInitDelaySeconds >= 0.f)
+	{
+		//메뉴가 뜬 뒤에 미리 띄워서 첫 버튼 클릭이 초기화를 기다리지 않게 함
+		DeferredOnlineInitTickerHandle = FTSTicker::GetCoreTicker().AddTicker(
+			FTickerDelegate::CreateUObject(this, &ThisClass::OnDeferredOnlineInit),
+			OnlineInitDelaySeconds
+		);
+	}
+}
+
+bool UMultiplayerSessionsSubsystem::OnDeferredOnlineInit(float DeltaTime)
+{
+	DeferredOnlineInitTickerHandle.Reset();
+	EnsureSessionInterface();
+	return false;
+}
+
+void UMultiplayerSessionsSubsystem::ApplyCommandLinePorts()
+{
+	const TCHAR* CommandLine = FCommandLine::Get();
+	FParse::Value(CommandLine, TEXT("QosPort="), QosPort);
+	FParse::Value(CommandLine, TEXT("LanDiscoveryPort="), LanDiscoveryPort);
+	FParse::Value(CommandLine, TEXT("BeaconPort="), BeaconPort);
+}
+
+void UMultiplayerSessionsSubsystem::RegisterDedicatedSession(UWorld* LoadedWorld)
+{
+	if (bDedicatedSessionRegistered || !bRegisterDedicatedSession || !IsRunningDedicatedServer())
+	{
+		return;
+	}
+	//리슨에 실패한 서버는 광고해도 아무도 들어올수 없음
+	if (LoadedWorld == nullptr || LoadedWorld->GetNetDriver() == nullptr)
+	{
+		UE_LOG(LogMultiplayerSessions, Warning, TEXT("Dedicated server is not listening, the session is not registered"));
+		return;
+	}
+	//서버 트래블로 맵이 바뀌어도 세션은 그대로 씀
+	bDedicatedSessionRegistered = true;
+	CreateDedicatedSession(DedicatedSessionPublicConnections, DedicatedSessionMatchType);
+}
+
+bool UMultiplayerSessionsSubsystem::EnsureSessionInterface()
+{
+	if (bOnlineInitialized || bUsingSessionInterfaceOverride)
+	{
+		return SessionInterface.IsValid();
+	}
+	bOnlineInitialized = true;
+	FTSTicker::GetCoreTicker().RemoveTicker(DeferredOnlineInitTickerHandle);
+	DeferredOnlineInitTickerHandle.Reset();
+
 	//#include "OnlineSubsystem.h"
+	FMultiplayerSessionsStats& Stats = FMultiplayerSessionsStats::Get();
+	Stats.BeginTimer(EMultiplayerSessionTimer::OnlineInit);
 	IOnlineSubsystem* Subsystem = IOnlineSubsystem::Get();
 	if (Subsystem)
 	{
 		SessionInterface = Subsystem->GetSessionInterface();
+		OnlineSubsystemName = Subsystem->GetSubsystemName();
+	}
+	Stats.EndTimer(EMultiplayerSessionTimer::OnlineInit, SessionInterface.IsValid());
+	Stats.MarkStartupPhase(EMultiplayerStartupPhase::OnlineReady);
+	if (!SessionInterface.IsValid())
+	{
+		UE_LOG(LogMultiplayerSessions, Warning, TEXT("No online session interface, session calls will fail"));
+	}
+	return SessionInterface.IsValid();
+}
+
+bool UMultiplayerSessionsSubsystem::IsNullSubsystemActive() const
+{
+	//바꿔 끼운 인터페이스는 기본 서브시스템과 상관없음
+	return !bUsingSessionInterfaceOverride && OnlineSubsystemName == FName("NULL");
+}
+
+void UMultiplayerSessionsSubsystem::Deinitialize()
+{
+	StopStreamingSearch();
+	StopSearchDeadline();
+	CancelLanSearch();
+	FTSTicker::GetCoreTicker().RemoveTicker(DeferredOnlineInitTickerHandle);
+	DeferredOnlineInitTickerHandle.Reset();
+	PendingSessionOps.Reset();
+	//게임 인스턴스와 같이 사라지는 호출자들이니 부르지 않고 버림
+	ActiveContinuationIds.Reset();
+	CompletedContinuations.Reset();
+	SessionOpContinuations.Reset();
+	QosResponder.Reset();
+	LanResponder.Reset();
+	FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+	FGameModeEvents::GameModePreLoginEvent.Remove(GameModePreLoginHandle);
+	FGameModeEvents::GameModePostLoginEvent.Remove(GameModePostLoginHandle);
+	FGameModeEvents::GameModeLogoutEvent.Remove(GameModeLogoutHandle);
+	FTSTicker::GetCoreTicker().RemoveTicker(SessionUpdateTickerHandle);
+	ReleasePrewarmedMap();
+	StopReservationBeacon();
+	if (ReservationClient.IsValid())
+	{
+		ReservationClient->OnReservationComplete.Unbind();
+		ReservationClient->DestroyBeacon();
 	}
+
+	Super::Deinitialize();
 }
 
 void UMultiplayerSessionsSubsystem::CreateSession(int32 NumPublicConnections, FString MatchType)
 {
-	if (!SessionInterface.IsValid())
+	QueueCreateSession(NumPublicConnections, MatchType, false);
+}
+
+void UMultiplayerSessionsSubsystem::CreateDedicatedSession(int32 NumPublicConnections, FString MatchType)
+{
+	QueueCreateSession(NumPublicConnections, MatchType, true);
+}
+
+bool UMultiplayerSessionsSubsystem::QueueCreateSession(int32 NumPublicConnections, const FString& MatchType, bool bDedicated, uint32 ContinuationId)
+{
+	if (!EnsureSessionInterface())
 	{
-		return;
+		return false;
 	}
-	//  ϴ  ִٸ ı
+	//만약 지금 존재하는 방이 있다면 파괴
 	auto ExistingSession = SessionInterface->GetNamedSession(NAME_GameSession);
-	if (ExistingSession != nullptr)
+	if (ExistingSession != nullptr || bGameSessionOnLan)
 	{
-		// ıǱ ؿ ڵ      Destroyڵ 
-		bCreateSessionOnDestroy = true;
-		LastNumPublicConnections = NumPublicConnections;
-		LastMatchType = MatchType;
+		//파괴가 큐에 먼저 들어가니 생성은 파괴가 끝난 뒤에 한번만 실행됨
+		QueueDestroySession();
+	}
+
+	EnqueueSessionOp(EMultiplayerSessionOp::Create, [this, NumPublicConnections, MatchType, bDedicated]()
+		{
+			BeginCreateSession(NumPublicConnections, MatchType, bDedicated);
+		}, ContinuationId);
+	return true;
+}
 
-		DestroySession();
-		
+void UMultiplayerSessionsSubsystem::BeginCreateSession(int32 NumPublicConnections, const FString& MatchType, bool bDedicated)
+{
+	if (SessionInterface->GetNamedSession(NAME_GameSession) != nullptr)
+	{
+		//앞의 파괴가 실패해서 아직 세션이 남아있음
+		FinishSessionOp(EMultiplayerSessionOp::Create, false);
+		NotifyCreateSessionComplete(false);
+		return;
 	}
 
-	//DELEGATE   ߿ FDelegateHandle  
+	//DELEGATE를 저장한 후 나중에 FDelegateHandle로 삭제 가능
 	CreateSessionCompleteDelegateHandle = SessionInterface->AddOnCreateSessionCompleteDelegate_Handle(CreateSessionCompletedDelegate);
 
 	LastSessionSettings = MakeShareable(new FOnlineSessionSettings());
-	LastSessionSettings->bIsLANMatch = IOnlineSubsystem::Get()->GetSubsystemName() == "NULL" ? true : false;
+	LastSessionSettings->bIsLANMatch = IsNullSubsystemActive();
 	LastSessionSettings->NumPublicConnections = NumPublicConnections;
-	LastSessionSettings->bAllowJoinInProgress = true; //  ̸ ٸ  Ҽ 
-	LastSessionSettings->bAllowJoinViaPresence = true; //   Ҷ  
-	LastSessionSettings->bShouldAdvertise = true; // ؼ  üְ ؾ
-	LastSessionSettings->bUsesPresence = true; //     ã true
-	LastSessionSettings->bUseLobbiesIfAvailable = true; // 𸮾5.0 ̻ ߰
-	LastSessionSettings->Set(FName("MatchType"),MatchType, EOnlineDataAdvertisementType::ViaOnlineServiceAndPing); //Ű  MatchType,FreeForAll  ¾ƾ  ǿ ϰ 
-	//BuildUniqueId = 1  ϸ ȿѰ  ˻  ٸ   Ҽְ  Ŀؼ  Ҽ
-	//Config ߰۾ ʿ DefaultGame.ini  ؿ ڵ ߰
+	LastSessionSettings->bAllowJoinInProgress = true; // 세션이 실행중이면 다른 유저도 가입할수 있음
+	LastSessionSettings->bAllowJoinViaPresence = !bDedicated; //스팀이 게임 세션을 설정할때 프리센스를 사용함
+	LastSessionSettings->bShouldAdvertise = true; // 광고해서 사람들이 들어올수있게 해야함
+	LastSessionSettings->bUsesPresence = !bDedicated; // 현재 지역에서 진행중인 세션 찾기위해 true
+	LastSessionSettings->bUseLobbiesIfAvailable = !bDedicated; // 언리얼5.0버전 이상부터 추가
+	LastSessionSettings->bIsDedicated = bDedicated; // 데디서버는 유저 프리센스 없이 게임서버로 광고됨
+	LastSessionSettings->Set(SETTING_MATCHTYPE,MatchType, EOnlineDataAdvertisementType::ViaOnlineServiceAndPing); //키 값 MatchType,FreeForAll 에 맞아야 같은 세션에 참여하게 세팅
+	//BuildUniqueId = 1 을 세팅하면 유효한게임 세션을 검색할 때 다른 세션을 보고 참가할수있고 오픈 커넥션이 없으면 조인할수없다
+	//Config폴더에서 추가작업 필요 DefaultGame.ini 에서 밑에 코드 추가
 	// [/Script/Engine.GameSession]
 	// MaxPlayers = 100
-	LastSessionSettings->BuildUniqueId = 1; //  ڰ ü   ȣ ϵ   ִ.
+	LastSessionSettings->BuildUniqueId = GetLocalBuildUniqueId(); // 여러 사용자가 자체 빌드 및 호스팅을 시작하도록 할 수 있다.
+	//온라인과 LAN 에 같이 광고할때 같은 호스트를 한번만 보여주기 위한 키
+	LastSessionSettings->Set(SETTING_HOSTKEY, FGuid::NewGuid().ToString(EGuidFormats::Short), EOnlineDataAdvertisementType::ViaOnlineService);
+	//가짜 백엔드의 세션은 실제로 접속할 호스트가 없으니 응답기를 띄우지 않음
+	if (QosPort >= 0 && !bUsingSessionInterfaceOverride)
+	{
+		if (!QosResponder.IsValid())
+		{
+			QosResponder = MakeUnique<FMultiplayerQosResponder>();
+		}
+		//세션을 만들기 전에 띄워서 실제로 잡은 포트만 광고
+		if (QosResponder->Start(QosPort))
+		{
+			//클라이언트가 핑을 직접 재볼수 있게 QoS 포트를 알려줌
+			LastSessionSettings->Set(SETTING_QOSPORT, QosResponder->GetPort(), EOnlineDataAdvertisementType::ViaOnlineService);
+		}
+	}
+	if (!AdvertisedMapPath.IsEmpty())
+	{
+		//참가자가 접속 주소를 받기 전에 맵 로드를 시작할 수 있게 알려줌
+		LastSessionSettings->Set(SETTING_MAPNAME, AdvertisedMapPath, EOnlineDataAdvertisementType::ViaOnlineService);
+	}
 
-	const ULocalPlayer* LocalPlayer = GetWorld()->GetFirstLocalPlayerFromController();
-	if (!SessionInterface->CreateSession(*LocalPlayer->GetPreferredUniqueNetId(), NAME_GameSession, *LastSessionSettings))
+	const FUniqueNetIdPtr LocalPlayerId = GetLocalPlayerNetId();
+	const bool bCreateStarted = LocalPlayerId.IsValid()
+		? SessionInterface->CreateSession(*LocalPlayerId, NAME_GameSession, *LastSessionSettings)
+		: SessionInterface->CreateSession(0, NAME_GameSession, *LastSessionSettings);
+	if (!bCreateStarted)
 	{
-		//ǻ ϸ Ʈ Ʈ ڵ鷯 
+		//세션생성에 실패하면 델리게이트 리스트에서 핸들러 삭제
 		SessionInterface->ClearOnCreateSessionCompleteDelegate_Handle(CreateSessionCompleteDelegateHandle);
+		if (QosResponder.IsValid())
+		{
+			QosResponder->Shutdown();
+		}
+		FinishSessionOp(EMultiplayerSessionOp::Create, false);
 
 		//BroadCast our own custom delegate
-		MultiplayerOnCreateSessionComplete.Broadcast(false);
+		NotifyCreateSessionComplete(false);
 	}
-		
-		
 }
 
-void UMultiplayerSessionsSubsystem::FindSession(int32 MaxSearchResults)
+void UMultiplayerSessionsSubsystem::FindSession(int32 MaxSearchResults, bool bStreamResults)
 {
-	if (!SessionInterface.IsValid())
+	//필터 없이 찾기
+	FMultiplayerSessionSearchParams Params;
+	Params.bRequireOpenSlots = false;
+	Params.MaxSearchResults = MaxSearchResults;
+	FindFilteredSessions(Params, bStreamResults);
+}
+
+void UMultiplayerSessionsSubsystem::FindFilteredSessions(const FMultiplayerSessionSearchParams& Params, bool bStreamResults, float TimeoutSeconds)
+{
+	QueueFindSessions(Params, bStreamResults, TimeoutSeconds);
+}
+
+bool UMultiplayerSessionsSubsystem::QueueFindSessions(const FMultiplayerSessionSearchParams& InParams, bool bStreamResults, float TimeoutSeconds, uint32 ContinuationId)
+{
+	if (!EnsureSessionInterface())
 	{
-		return;
+		return false;
+	}
+	//메뉴는 10000 개까지 요청하지만 저사양 기기에서 그만큼 들고 있을 필요는 없음
+	FMultiplayerSessionSearchParams Params = InParams;
+	if (MaxStoredSearchResults > 0)
+	{
+		Params.MaxSearchResults = FMath::Clamp(Params.MaxSearchResults, 1, MaxStoredSearchResults);
+	}
+	LastSearchParams = Params;
+
+	bool bNeedsRefresh = false;
+	if (TryServeSearchFromCache(Params, bNeedsRefresh, ContinuationId))
+	{
+		//캐시로 이미 답했으니 갱신 검색은 이 호출을 기다리게 하지 않음
+		ContinuationId = 0;
+		if (!bNeedsRefresh)
+		{
+			return true;
+		}
+	}
+	const bool bServedFromCache = bNeedsRefresh;
+	//대기열에서 기다린 시간도 사용자에게는 검색 시간이니 요청 시점부터 셈
+	const float SearchBudgetSeconds = TimeoutSeconds < 0.f ? SearchTimeoutSeconds : TimeoutSeconds;
+	const double DeadlineSeconds = SearchBudgetSeconds > 0.f ? FPlatformTime::Seconds() + SearchBudgetSeconds : 0.0;
+
+	if (ActiveSessionOp == EMultiplayerSessionOp::Find && InFlightSearchParams == Params && !bSearchCancelled)
+	{
+		//같은 조건의 검색이 이미 진행중이면 새로 보내지 않고 그 결과를 기다림
+		bBackgroundSearch = bBackgroundSearch && bServedFromCache;
+		if (ContinuationId != 0)
+		{
+			ActiveContinuationIds.Add(ContinuationId);
+		}
+		return true;
 	}
+
+	//대기중인 검색이 있으면 새 조건으로 교체됨
+	EnqueueSessionOp(EMultiplayerSessionOp::Find, [this, Params, bStreamResults, bServedFromCache, DeadlineSeconds]()
+		{
+			BeginFindSessions(Params, bStreamResults, bServedFromCache, DeadlineSeconds);
+		}, ContinuationId, Params);
+	return true;
+}
+
+void UMultiplayerSessionsSubsystem::BeginFindSessions(const FMultiplayerSessionSearchParams& Params, bool bStreamResults, bool bRefreshCacheOnly, double DeadlineSeconds)
+{
+	StopStreamingSearch();
+	StopSearchDeadline();
+	bSearchCancelled = false;
+	bBackgroundSearch = bRefreshCacheOnly;
+	++SearchSerial;
+	InFlightSearchParams = Params;
+
 	FindSessionsCompleteDelegateHandle = SessionInterface->AddOnFindSessionsCompleteDelegate_Handle(FindSessionCompletedDelegate);
 
-	LastSessionSearch = MakeShareable(new FOnlineSessionSearch());
-	LastSessionSearch->MaxSearchResults = MaxSearchResults; // 80 dev app ID  »   ID , 480 ̽    ID , ڷ ϸ   ã Ȯ 
-	LastSessionSearch->bIsLanQuery = IOnlineSubsystem::Get()->GetSubsystemName() == "NULL" ? true : false;; // lan  
-	LastSessionSearch->QuerySettings.Set(SEARCH_PRESENCE, true, EOnlineComparisonOp::Equals);
+	ResetSessionSearch();
+	LastSessionSearch->MaxSearchResults = Params.MaxSearchResults; // 80은 dev app ID 가 없는사람을 위한 공유된 ID , 480은 스페이스 워 개발자 앱 ID , 높은숫자로 설정하면 많은 세션을 찾을 확률 증가
+	LastSessionSearch->bIsLanQuery = IsNullSubsystemActive(); // lan 연결 쿼리
+	if (!Params.bSearchDedicatedServers)
+	{
+		//presence 검색은 리슨서버(로비)만 찾음, 빼면 데디케이티드 게임서버 목록을 검색
+		LastSessionSearch->QuerySettings.Set(SEARCH_PRESENCE, true, EOnlineComparisonOp::Equals);
+	}
+	//백엔드에서 걸러내면 받아오는 결과 자체가 줄어듬
+	if (!Params.MatchType.IsEmpty())
+	{
+		LastSessionSearch->QuerySettings.Set(SETTING_MATCHTYPE, Params.MatchType, EOnlineComparisonOp::Equals);
+	}
+	if (Params.bRequireOpenSlots)
+	{
+		LastSessionSearch->QuerySettings.Set(SEARCH_MINSLOTSAVAILABLE, 1, EOnlineComparisonOp::GreaterThanEquals);
+	}
 
-	const ULocalPlayer* LocalPlayer = GetWorld()->GetFirstLocalPlayerFromController();
-	if (!SessionInterface->FindSessions(*LocalPlayer->GetPreferredUniqueNetId(), LastSessionSearch.ToSharedRef()))
+	const FUniqueNetIdPtr LocalPlayerId = GetLocalPlayerNetId();
+	const bool bFindStarted = LocalPlayerId.IsValid()
+		? SessionInterface->FindSessions(*LocalPlayerId, LastSessionSearch.ToSharedRef())
+		: SessionInterface->FindSessions(0, LastSessionSearch.ToSharedRef());
+	if (!bFindStarted)
 	{
-		// ã⿡ 
+		//세션 찾기에 실패
 		SessionInterface->ClearOnFindSessionsCompleteDelegate_Handle(FindSessionsCompleteDelegateHandle);
-		// 迭 ȯ ,  false
-		MultiplayerOnFindSessionsComplete.Broadcast(TArray<FOnlineSessionSearchResult>(),false);
+		const bool bWasBackgroundSearch = bBackgroundSearch;
+		const uint32 FailedSearchSerial = SearchSerial;
+		bBackgroundSearch = false;
+		FinishSessionOp(EMultiplayerSessionOp::Find, false);
+		if (bWasBackgroundSearch)
+		{
+			//캐시된 결과는 이미 보냈음
+			return;
+		}
+		//빈 배열 반환 , 성공여부 false
+		NotifyFindSessionsComplete(FailedSearchSerial, TArray<FOnlineSessionSearchResult>(), false, EMultiplayerFindSessionsOutcome::Failed);
+		return;
 	}
 
+	if (Params.bIncludeLan)
+	{
+		BeginLanSearch(Params);
+	}
+
+	if (DeadlineSeconds > 0.0)
+	{
+		//대기열에서 이미 시간을 다 썼으면 다음 틱에 바로 만료
+		const double RemainingSeconds = FMath::Max(DeadlineSeconds - FPlatformTime::Seconds(), 0.0);
+		SearchDeadlineTickerHandle = FTSTicker::GetCoreTicker().AddTicker(
+			FTickerDelegate::CreateUObject(this, &ThisClass::OnSearchDeadline),
+			static_cast<float>(RemainingSeconds)
+		);
+	}
 
+	if (bStreamResults && !bBackgroundSearch)
+	{
+		// 검색이 끝날때까지 기다리지 않고 주기적으로 새 결과를 넘겨줌
+		bStreamingSearch = true;
+		NumStreamedResults = 0;
+		StreamSearchTickerHandle = FTSTicker::GetCoreTicker().AddTicker(
+			FTickerDelegate::CreateUObject(this, &ThisClass::PollStreamedSearchResults),
+			StreamSearchPollInterval
+		);
+	}
 }
 
-void UMultiplayerSessionsSubsystem::JoinSession(const FOnlineSessionSearchResult& SessionResult)
+void UMultiplayerSessionsSubsystem::CancelFindSession()
 {
+	StopStreamingSearch();
+	TArray<uint32> DroppedContinuationIds;
+	const int32 NumDropped = PendingSessionOps.RemoveAll([&DroppedContinuationIds](const FQueuedSessionOp& Pending)
+		{
+			if (Pending.Op != EMultiplayerSessionOp::Find)
+			{
+				return false;
+			}
+			DroppedContinuationIds.Append(Pending.ContinuationIds);
+			return true;
+		});
+	if (NumDropped > 0 && ActiveSessionOp != EMultiplayerSessionOp::Find)
+	{
+		SetSessionOpStatus(EMultiplayerSessionOp::Find, EMultiplayerSessionOpStatus::Idle);
+	}
+
+	//백엔드 검색은 끝났고 핑만 재는 중인 검색, 캐시 갱신용이면 끝까지 진행
+	if (!bQosProbeRefreshOnly)
+	{
+		CancelQosProbe();
+	}
+	//캐시 갱신용 검색은 끝까지 진행, 이미 취소중인 검색은 백엔드 확인만 기다림
+	if (bBackgroundSearch || ActiveSessionOp != EMultiplayerSessionOp::Find || bAwaitingSearchCancel)
+	{
+		//시작도 안한 검색을 기다리던 호출에만 알림
+		CompleteFindContinuations(DroppedContinuationIds, TArray<FOnlineSessionSearchResult>(), false, EMultiplayerFindSessionsOutcome::Cancelled);
+		return;
+	}
+
+	//스트리밍 배치 안에서 호출될수 있으니 검색 결과는 건드리지 않고 복사해서 보냄
+	TArray<FOnlineSessionSearchResult> PartialResults;
+	CopyPartialSearchResults(PartialResults);
+	CancelActiveSearch(PartialResults);
+	//진행중이던 검색의 호출은 위에서 받았으니 여기선 큐에서 뺀 호출과 리스너만
+	CompleteFindContinuations(DroppedContinuationIds, PartialResults, PartialResults.Num() > 0, EMultiplayerFindSessionsOutcome::Cancelled);
+	MultiplayerOnFindSessionsComplete.Broadcast(PartialResults, PartialResults.Num() > 0, EMultiplayerFindSessionsOutcome::Cancelled);
+}
+
+void UMultiplayerSessionsSubsystem::CancelActiveSearch(const TArray<FOnlineSessionSearchResult>& PartialResults)
+{
+	if (ActiveSessionOp != EMultiplayerSessionOp::Find || bAwaitingSearchCancel)
+	{
+		return;
+	}
+
+	CancelBackendSearch();
+
+	//취소된 검색은 완료를 알리지 않으니 여기서 꺼내서 바로 알림
+	TArray<uint32> CancelledContinuationIds = MoveTemp(ActiveContinuationIds);
+	ActiveContinuationIds.Reset();
+
+	//다음 작업(보통 Join)은 백엔드가 취소를 확인하면 시작
+	FinishCancelledSearchOp(false);
+
+	CompleteFindContinuations(CancelledContinuationIds, PartialResults, PartialResults.Num() > 0, EMultiplayerFindSessionsOutcome::Cancelled);
+}
+
+void UMultiplayerSessionsSubsystem::CancelBackendSearch()
+{
+	//남은 검색은 필요없으니 취소, 이후 들어오는 완료 콜백은 무시
+	bSearchCancelled = true;
+	bBackgroundSearch = false;
+	StopStreamingSearch();
+	StopSearchDeadline();
+	CancelLanSearch();
+
 	if (!SessionInterface.IsValid())
 	{
-		MultiplayerOnJoinSessionComplete.Broadcast(EOnJoinSessionCompleteResult::UnknownError);
 		return;
 	}
+	//다음 검색이 핸들을 덮어쓰기 전에 떼어둠, 안 그러면 늦게 오는 완료가 다음 검색의 결과로 처리됨
+	SessionInterface->ClearOnFindSessionsCompleteDelegate_Handle(FindSessionsCompleteDelegateHandle);
+	if (LastSessionSearch.IsValid() && LastSessionSearch->SearchState == EOnlineAsyncTaskState::InProgress)
+	{
+		CancelFindSessionsCompleteDelegateHandle = SessionInterface->AddOnCancelFindSessionsCompleteDelegate_Handle(CancelFindSessionsCompletedDelegate);
+		bAwaitingSearchCancel = SessionInterface->CancelFindSessions();
+		if (!bAwaitingSearchCancel)
+		{
+			SessionInterface->ClearOnCancelFindSessionsCompleteDelegate_Handle(CancelFindSessionsCompleteDelegateHandle);
+		}
+	}
+}
 
-	JoinSessionCompleteDelegateHandle = SessionInterface->AddOnJoinSessionCompleteDelegate_Handle(JoinSessionCompletedDelegate);
-	const ULocalPlayer* LocalPlayer = GetWorld()->GetFirstLocalPlayerFromController();
-	if (!SessionInterface->JoinSession(*LocalPlayer->GetPreferredUniqueNetId(), NAME_GameSession, SessionResult))
+void UMultiplayerSessionsSubsystem::FinishCancelledSearchOp(bool bWasSuccessful)
+{
+	if (!bAwaitingSearchCancel)
 	{
-		SessionInterface->ClearOnJoinSessionCompleteDelegate_Handle(JoinSessionCompleteDelegateHandle);
+		FinishSessionOp(EMultiplayerSessionOp::Find, bWasSuccessful);
+		return;
+	}
+	//기다리던 호출은 FinishSessionOp 처럼 따로 보관, 알림은 지금 호출한 쪽에서 함
+	bCancelledSearchSucceeded = bWasSuccessful;
+	ParkActiveContinuations(EMultiplayerSessionOp::Find);
+}
 
-		MultiplayerOnJoinSessionComplete.Broadcast(EOnJoinSessionCompleteResult::UnknownError);
+bool UMultiplayerSessionsSubsystem::OnSearchDeadline(float DeltaTime)
+{
+	SearchDeadlineTickerHandle.Reset();
+	if (ActiveSessionOp != EMultiplayerSessionOp::Find || !LastSessionSearch.IsValid())
+	{
+		return false;
+	}
+
+	//스트리밍 중이면 아직 못 보낸 결과부터 보냄, 리스너가 여기서 세션을 고르면 검색은 이미 취소됨
+	const uint32 TimedOutSearchSerial = SearchSerial;
+	BroadcastStreamedBatch();
+	if (SearchSerial != TimedOutSearchSerial || bSearchCancelled)
+	{
+		return false;
+	}
+
+	UE_LOG(LogMultiplayerSessions, Warning, TEXT("FindSessions passed its deadline, returning %d partial results"), LastSessionSearch->SearchResults.Num());
+	const bool bWasBackgroundSearch = bBackgroundSearch;
+	CancelBackendSearch();
+	if (bWasBackgroundSearch)
+	{
+		//캐시된 결과는 이미 보냈고, 일부만 온 결과로 캐시를 덮어쓰지 않음
+		FinishCancelledSearchOp(false);
+		return false;
 	}
+
+	//일부 결과는 캐시하지 않음, 다음 검색은 다시 백엔드로 감
+	RankCompletedSearch(InFlightSearchParams);
+	MergeLanResults(InFlightSearchParams);
+	MultiplayerOnSearchResultsReplaced.Broadcast();
+	//작업을 끝내기 전에 알리니 이 검색을 기다리는 호출을 먼저 넘겨둠
+	ParkActiveContinuations(EMultiplayerSessionOp::Find);
+	NotifyFindSessionsComplete(SearchSerial, *RankedSearchResults, RankedSearchResults->Num() > 0, EMultiplayerFindSessionsOutcome::TimedOut);
+	FinishCancelledSearchOp(false);
+	return false;
 }
 
-void UMultiplayerSessionsSubsystem::DestroySession()
+void UMultiplayerSessionsSubsystem::StopSearchDeadline()
 {
-	if (!SessionInterface.IsValid())
+	if (SearchDeadlineTickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(SearchDeadlineTickerHandle);
+		SearchDeadlineTickerHandle.Reset();
+	}
+}
+
+void UMultiplayerSessionsSubsystem::CopyPartialSearchResults(TArray<FOnlineSessionSearchResult>& OutResults) const
+{
+	OutResults.Reset();
+	auto CopyMatching = [this, &OutResults](const TArray<FOnlineSessionSearchResult>& Results)
+		{
+			for (const FOnlineSessionSearchResult& Result : Results)
+			{
+				if (PassesSearchFilter(Result, InFlightSearchParams))
+				{
+					OutResults.Add(Result);
+				}
+			}
+		};
+	//LAN 결과를 앞에
+	CopyMatching(LanSearchResults);
+	if (LastSessionSearch.IsValid())
+	{
+		CopyMatching(LastSessionSearch->SearchResults);
+	}
+}
+
+void UMultiplayerSessionsSubsystem::BeginLanSearch(const FMultiplayerSessionSearchParams& Params)
+{
+	//가짜 백엔드를 쓰는 동안은 LAN 도 끔
+	if (bUsingSessionInterfaceOverride || !LastSessionSearch.IsValid())
 	{
-		MultiplayerOnDestroySessionComplete.Broadcast(false);
 		return;
 	}
 
-	DestroySessionCompleteDelegateHandle = SessionInterface->AddOnDestroySessionCompleteDelegate_Handle(DestroySessionCompletedDelegate);
+	LanSearchResults.Reset();
+	bLanSearchActive = true;
 
-	if (!SessionInterface->DestroySession(NAME_GameSession))
+	FMultiplayerLanDiscoveryParams DiscoveryParams;
+	DiscoveryParams.BasePort = LanDiscoveryPort;
+	DiscoveryParams.PortRange = LanDiscoveryPortRange;
+	DiscoveryParams.ProbeIntervalSeconds = LanProbeIntervalSeconds;
+	DiscoveryParams.FirstResponseGraceSeconds = LanFirstResponseGraceSeconds;
+	DiscoveryParams.TimeoutSeconds = LanDiscoveryTimeoutSeconds;
+	DiscoveryParams.MaxResults = Params.MaxSearchResults;
+	DiscoveryParams.MatchType = Params.MatchType;
+	DiscoveryParams.BuildUniqueId = GetLocalBuildUniqueId();
+
+	LanDiscoveryCancelFlag = MakeShared<FThreadSafeBool, ESPMode::ThreadSafe>(false);
+	TWeakObjectPtr<UMultiplayerSessionsSubsystem> WeakThis(this);
+	const uint32 DiscoverySearchSerial = SearchSerial;
+	FMultiplayerLanDiscovery::DiscoverAsync(DiscoveryParams, LanDiscoveryCancelFlag,
+		[WeakThis, DiscoverySearchSerial](TArray<FMultiplayerLanHost>&& Hosts)
+		{
+			if (UMultiplayerSessionsSubsystem* Subsystem = WeakThis.Get())
+			{
+				Subsystem->OnLanDiscoveryComplete(DiscoverySearchSerial, MoveTemp(Hosts));
+			}
+		});
+}
+
+void UMultiplayerSessionsSubsystem::OnLanDiscoveryComplete(uint32 DiscoverySearchSerial, TArray<FMultiplayerLanHost>&& Hosts)
+{
+	if (DiscoverySearchSerial != SearchSerial || ActiveSessionOp != EMultiplayerSessionOp::Find || bSearchCancelled || !bLanSearchActive)
 	{
-		SessionInterface->ClearOnDestroySessionCompleteDelegate_Handle(DestroySessionCompleteDelegateHandle);
-		MultiplayerOnDestroySessionComplete.Broadcast(false);
+		return;
+	}
+	LanDiscoveryCancelFlag.Reset();
+	LanSearchResults.Reserve(LanSearchResults.Num() + Hosts.Num());
+	for (const FMultiplayerLanHost& Host : Hosts)
+	{
+		LanSearchResults.Add(FMultiplayerLanDiscovery::MakeSearchResult(Host));
+	}
+
+	//맞는 LAN 호스트가 없으면 온라인 검색 결과를 계속 기다림
+	if (HasMatchingLanResult())
+	{
+		FinishFindWithLanResults();
 	}
 }
 
+bool UMultiplayerSessionsSubsystem::HasMatchingLanResult() const
+{
+	return LanSearchResults.ContainsByPredicate([this](const FOnlineSessionSearchResult& Result)
+		{
+			return PassesSearchFilter(Result, InFlightSearchParams);
+		});
+}
 
+void UMultiplayerSessionsSubsystem::FinishFindWithLanResults()
+{
+	const bool bWasBackgroundSearch = bBackgroundSearch;
+	//온라인 검색은 여기서 끊고 그때까지 온 결과만 합침
+	CancelBackendSearch();
+	RankCompletedSearch(InFlightSearchParams);
+	MergeLanResults(InFlightSearchParams);
+	MultiplayerOnSearchResultsReplaced.Broadcast();
+	bBackgroundSearch = bWasBackgroundSearch;
+	ParkActiveContinuations(EMultiplayerSessionOp::Find);
+	//온라인 쪽이 일부뿐이니 캐시하지 않음
+	FinishFindSessions(true, false);
+	FinishCancelledSearchOp(true);
+}
 
-void UMultiplayerSessionsSubsystem::StartSession()
+void UMultiplayerSessionsSubsystem::CancelLanSearch()
 {
+	//탐색 스레드만 멈춤, 이미 받은 결과는 MergeLanResults 에서 씀
+	if (LanDiscoveryCancelFlag.IsValid())
+	{
+		*LanDiscoveryCancelFlag = true;
+		LanDiscoveryCancelFlag.Reset();
+	}
 }
 
-void UMultiplayerSessionsSubsystem::OnCretateSessionComplete(FName SessionName, bool bWasSuccessful)
+void UMultiplayerSessionsSubsystem::MergeLanResults(const FMultiplayerSessionSearchParams& Params)
 {
-	// 1.   Ϸ Ȳ
-	if (SessionInterface)
+	if (!bLanSearchActive)
 	{
-		SessionInterface->ClearOnCreateSessionCompleteDelegate_Handle(CreateSessionCompleteDelegateHandle);
+		return;
 	}
-	//Broadcast ̸ bWasSuccessful true  ޾ƿ
-	MultiplayerOnCreateSessionComplete.Broadcast(bWasSuccessful);
+	bLanSearchActive = false;
+	TArray<FOnlineSessionSearchResult> LanResults = MoveTemp(LanSearchResults);
+	LanSearchResults.Reset();
+
+	TArray<FOnlineSessionSearchResult> Merged;
+	TSet<FString> LanHostKeys;
+	for (FOnlineSessionSearchResult& Result : LanResults)
+	{
+		if (!PassesSearchFilter(Result, Params))
+		{
+			continue;
+		}
+		FString HostKey;
+		if (Result.Session.SessionSettings.Get(SETTING_HOSTKEY, HostKey))
+		{
+			LanHostKeys.Add(HostKey);
+		}
+		Merged.Add(MoveTemp(Result));
+	}
+	if (Merged.Num() == 0)
+	{
+		return;
+	}
+	Algo::StableSort(Merged, [](const FOnlineSessionSearchResult& A, const FOnlineSessionSearchResult& B)
+		{
+			return A.PingInMs < B.PingInMs;
+		});
+
+	for (const FOnlineSessionSearchResult& Result : *RankedSearchResults)
+	{
+		if (Merged.Num() >= Params.MaxSearchResults)
+		{
+			break;
+		}
+		FString HostKey;
+		if (Result.Session.SessionSettings.Get(SETTING_HOSTKEY, HostKey) && LanHostKeys.Contains(HostKey))
+		{
+			continue;
+		}
+		Merged.Add(Result);
+	}
+	if (Merged.Num() > Params.MaxSearchResults)
+	{
+		Merged.SetNum(Params.MaxSearchResults);
+	}
+	RankedSearchResults = MakeShared<const TArray<FOnlineSessionSearchResult>>(MoveTemp(Merged));
+	SessionIndex.Build(*RankedSearchResults);
 }
 
-void UMultiplayerSessionsSubsystem::OnFindSessionComplete(bool bWasSuccessful)
+void UMultiplayerSessionsSubsystem::AdvertiseOnLan()
 {
-	// ã Ȳ
-	if (SessionInterface)
+	if (!bAdvertiseOnLan || bUsingSessionInterfaceOverride || !LastSessionSettings.IsValid())
 	{
-		SessionInterface->ClearOnFindSessionsCompleteDelegate_Handle(FindSessionsCompleteDelegateHandle);
+		return;
+	}
+	if (!LanResponder.IsValid())
+	{
+		LanResponder = MakeUnique<FMultiplayerLanDiscoveryResponder>();
+	}
+	if (LanResponder->Start(LanDiscoveryPort, LanDiscoveryPortRange))
+	{
+		UpdateLanAdvertisement();
 	}
-	if (LastSessionSearch->SearchResults.Num() <= 0)
+}
+
+void UMultiplayerSessionsSubsystem::UpdateLanAdvertisement()
+{
+	if (!LanResponder.IsValid() || !LanResponder->IsRunning() || !LastSessionSettings.IsValid())
 	{
-		//  ٸ
-		// 迭 ȯ ,  false
-		MultiplayerOnFindSessionsComplete.Broadcast(TArray<FOnlineSessionSearchResult>(), false);
 		return;
 	}
-	MultiplayerOnFindSessionsComplete.Broadcast(LastSessionSearch->SearchResults, bWasSuccessful);
+
+	FMultiplayerLanAdvertisement Advertisement;
+	LastSessionSettings->Get(SETTING_MATCHTYPE, Advertisement.MatchType);
+	LastSessionSettings->Get(SETTING_HOSTKEY, Advertisement.HostKey);
+	LastSessionSettings->Get(SETTING_MAPNAME, Advertisement.MapPath);
+	Advertisement.OwningUserName = FPlatformProcess::ComputerName();
+	Advertisement.BuildUniqueId = LastSessionSettings->BuildUniqueId;
+	Advertisement.NumPublicConnections = LastSessionSettings->NumPublicConnections;
+	Advertisement.OpenSlots = GetHostOpenSlots();
+	Advertisement.QosPort = QosResponder.IsValid() ? QosResponder->GetPort() : 0;
+	Advertisement.BeaconPort = BeaconListenPort;
+	//리슨 서버는 로비 맵을 연 뒤에야 포트가 정해짐, 그 전엔 기본 포트
+	const UWorld* World = GetWorld();
+	const ENetMode NetMode = World ? World->GetNetMode() : NM_Standalone;
+	Advertisement.GamePort = (NetMode == NM_ListenServer || NetMode == NM_DedicatedServer) ? World->URL.Port : FURL::UrlConfig.DefaultPort;
+	LanResponder->SetAdvertisement(Advertisement);
 }
 
-void UMultiplayerSessionsSubsystem::OnJoinSessionComplete(FName SessionName, EOnJoinSessionCompleteResult::Type Result)
+bool UMultiplayerSessionsSubsystem::ResolveSearchResultAddress(const FOnlineSessionSearchResult& SessionResult, FString& OutConnectInfo) const
 {
-	if (SessionInterface)
+	if (IsLanSearchResult(SessionResult))
 	{
-		SessionInterface->ClearOnJoinSessionCompleteDelegate_Handle(JoinSessionCompleteDelegateHandle);
+		OutConnectInfo = FMultiplayerLanDiscovery::GetHostAddress(SessionResult);
+		return !OutConnectInfo.IsEmpty();
 	}
+	return SessionInterface.IsValid() && SessionInterface->GetResolvedConnectString(SessionResult, NAME_GamePort, OutConnectInfo);
+}
 
-	MultiplayerOnJoinSessionComplete.Broadcast(Result);
+bool UMultiplayerSessionsSubsystem::IsLanSearchResult(const FOnlineSessionSearchResult& SessionResult)
+{
+	bool bIsLanResult = false;
+	return SessionResult.Session.SessionSettings.Get(SETTING_LANRESULT, bIsLanResult) && bIsLanResult;
 }
 
-void UMultiplayerSessionsSubsystem::OnDestroySessionComplete(FName SessionName, bool bWasSuccessful)
+bool UMultiplayerSessionsSubsystem::GetResolvedConnectString(FString& OutConnectInfo, FName PortType) const
 {
-	if (SessionInterface)
+	if (bGameSessionOnLan)
 	{
-		SessionInterface->ClearOnDestroySessionCompleteDelegate_Handle(DestroySessionCompleteDelegateHandle);
+		ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+		TSharedPtr<FInternetAddr> HostAddress = SocketSubsystem ? SocketSubsystem->GetAddressFromString(JoinedLanAddress) : nullptr;
+		if (!HostAddress.IsValid())
+		{
+			return false;
+		}
+		int32 HostBeaconPort = 0;
+		if (PortType == NAME_BeaconPort)
+		{
+			if (!JoinedLanSettings.Get(SETTING_BEACONPORT, HostBeaconPort) || HostBeaconPort <= 0)
+			{
+				return false;
+			}
+			HostAddress->SetPort(HostBeaconPort);
+		}
+		OutConnectInfo = HostAddress->ToString(true);
+		return true;
+	}
+	return SessionInterface.IsValid() && SessionInterface->GetResolvedConnectString(NAME_GameSession, OutConnectInfo, PortType);
+}
+
+bool UMultiplayerSessionsSubsystem::PollStreamedSearchResults(float DeltaTime)
+{
+	BroadcastStreamedBatch();
+
+	// 리스너가 배치 안에서 CancelFindSession 을 호출했다면 여기서 멈춤
+	return bStreamingSearch;
+}
+
+void UMultiplayerSessionsSubsystem::BroadcastStreamedBatch()
+{
+	if (!bStreamingSearch || !LastSessionSearch.IsValid())
+	{
+		return;
 	}
-	if (bWasSuccessful && bCreateSessionOnDestroy)
+
+	const TArray<FOnlineSessionSearchResult>& Results = LastSessionSearch->SearchResults;
+	if (Results.Num() <= NumStreamedResults)
 	{
-		//ǹ  ٽ Ϸ 
-		bCreateSessionOnDestroy = false;
-		
-		// ıϷ  
-		CreateSession(LastNumPublicConnections, LastMatchType);
+		return;
 	}
-	// ıƴٴ° ˸
-	MultiplayerOnDestroySessionComplete.Broadcast(bWasSuccessful);
+
+	const int32 FirstNewResult = NumStreamedResults;
+	NumStreamedResults = Results.Num();
+
+	// Keep the search alive while listeners look at the batch; they may cancel it from inside the broadcast
+	TSharedPtr<FOnlineSessionSearch> SearchInFlight = LastSessionSearch;
+	MultiplayerOnFindSessionsBatch.Broadcast(MakeArrayView(SearchInFlight->SearchResults).Slice(FirstNewResult, NumStreamedResults - FirstNewResult));
 }
 
-void UMultiplayerSessionsSubsystem::OnStartSessionComplete(FName SessionName, bool bWasSuccessful)
+void UMultiplayerSessionsSubsystem::StopStreamingSearch()
+{
+	bStreamingSearch = false;
+	if (StreamSearchTickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(StreamSearchTickerHandle);
+		StreamSearchTickerHandle.Reset();
+	}
+}
+
+bool UMultiplayerSessionsSubsystem::PassesSearchFilter(const FOnlineSessionSearchResult& SessionResult) const
+{
+	return PassesSearchFilter(SessionResult, LastSearchParams);
+}
+
+bool UMultiplayerSessionsSubsystem::PassesSearchFilter(const FOnlineSessionSearchResult& SessionResult, const FMultiplayerSessionSearchParams& Params)
+{
+	if (!Params.MatchType.IsEmpty())
+	{
+		FString SettingsValue;
+		SessionResult.Session.SessionSettings.Get(SETTING_MATCHTYPE, SettingsValue);
+		if (SettingsValue != Params.MatchType)
+		{
+			return false;
+		}
+	}
+	if (Params.bRequireOpenSlots && GetOpenSlots(SessionResult) <= 0)
+	{
+		return false;
+	}
+	// Backends that can't measure ping report MAX_QUERY_PING, don't throw those away
+	if (Params.MaxPingMs > 0 && SessionResult.PingInMs < MAX_QUERY_PING && SessionResult.PingInMs > Params.MaxPingMs)
+	{
+		return false;
+	}
+	return true;
+}
+
+int32 UMultiplayerSessionsSubsystem::GetOpenSlots(const FOnlineSessionSearchResult& SessionResult)
+{
+	return FMultiplayerSessionIndex::GetOpenSlots(SessionResult);
+}
+
+int32 UMultiplayerSessionsSubsystem::SelectTopSessions(const FMultiplayerSessionSearchParams& Params, int32 K, TArray<int32>& OutResultIndices) const
+{
+	return SessionIndex.SelectTopK(MakeIndexFilter(Params), K, OutResultIndices);
+}
+
+const FOnlineSessionSearchResult* UMultiplayerSessionsSubsystem::GetRankedSearchResult(int32 ResultIndex) const
+{
+	return RankedSearchResults->IsValidIndex(ResultIndex) ? &(*RankedSearchResults)[ResultIndex] : nullptr;
+}
+
+FMultiplayerSessionIndex::FFilter UMultiplayerSessionsSubsystem::MakeIndexFilter(const FMultiplayerSessionSearchParams& Params)
 {
+	FMultiplayerSessionIndex::FFilter Filter;
+	Filter.bAnyMatchType = Params.MatchType.IsEmpty();
+	Filter.MatchTypeHash = FMultiplayerSessionIndex::HashMatchType(Params.MatchType);
+	Filter.MatchType = Params.MatchType;
+	Filter.MinOpenSlots = Params.bRequireOpenSlots ? 1 : 0;
+	Filter.MaxPingMs = Params.MaxPingMs;
+	Filter.BuildId = GetLocalBuildUniqueId();
+	return Filter;
+}
+
+int32 UMultiplayerSessionsSubsystem::GetLocalBuildUniqueId()
+{
+	//접속 가능 여부도 같은 값으로 판단하니 네트워크 버전을 그대로 씀, 0 은 아무 빌드나 받는다는 뜻이라 피함
+	const int32 NetworkVersion = static_cast<int32>(FNetworkVersion::GetLocalNetworkVersion());
+	return NetworkVersion != 0 ? NetworkVersion : 1;
+}
+
+void UMultiplayerSessionsSubsystem::RankCompletedSearch(const FMultiplayerSessionSearchParams& Params)
+{
+	TArray<FOnlineSessionSearchResult>& SearchResults = LastSessionSearch->SearchResults;
+
+	//NULL 서브시스템처럼 쿼리 조건을 무시하는 백엔드도 있어서 인덱스에서 한번 더 확인
+	SessionIndex.Build(SearchResults);
+	TArray<int32> Selected;
+	SessionIndex.SelectTopK(MakeIndexFilter(Params), Params.MaxSearchResults, Selected);
+
+	TArray<FOnlineSessionSearchResult> Ranked;
+	Ranked.Reserve(Selected.Num());
+	for (const int32 ResultIndex : Selected)
+	{
+		Ranked.Add(MoveTemp(SearchResults[ResultIndex]));
+	}
+	RankedSearchResults = MakeShared<const TArray<FOnlineSessionSearchResult>>(MoveTemp(Ranked));
+	//할당은 남겨서 다음 검색에 재사용, 최대 MaxStoredSearchResults 개라 크기는 정해져 있음
+	SearchResults.Reset();
+
+	//남긴 결과 기준으로 다시 만들어서 인덱스가 RankedSearchResults 를 가리키게 함
+	SessionIndex.Build(*RankedSearchResults);
+}
+
+bool UMultiplayerSessionsSubsystem::TryServeSearchFromCache(const FMultiplayerSessionSearchParams& Params, bool& bOutNeedsRefresh, uint32 ContinuationId)
+{
+	bOutNeedsRefresh = false;
+	if (SearchCacheTTLSeconds <= 0.f)
+	{
+		return false;
+	}
+
+	const FCachedSessionSearch* Cached = SearchCache.Find(Params);
+	if (Cached == nullptr)
+	{
+		return false;
+	}
+
+	const double Age = FPlatformTime::Seconds() - Cached->Timestamp;
+	if (Age > SearchCacheTTLSeconds + SearchCacheStaleSeconds || Cached->Results->Num() == 0)
+	{
+		SearchCache.Remove(Params);
+		return false;
+	}
+	bOutNeedsRefresh = Age > SearchCacheTTLSeconds;
+
+	//복사하지 않고 캐시 배열을 그대로 공유, 리스너가 콜백 안에서 캐시나 결과를 바꿀수도 있으니 따로 잡아둠
+	const TSharedRef<const TArray<FOnlineSessionSearchResult>> Results = Cached->Results.ToSharedRef();
+	RankedSearchResults = Results;
+	SessionIndex.Build(*Results);
+	UpdateSearchMemoryStats();
+	MultiplayerOnSearchResultsReplaced.Broadcast();
+	//이 호출에만 알림, 진행중이거나 핑을 재는 다른 검색을 기다리는 호출은 그 검색의 결과를 받음
+	if (ContinuationId != 0)
+	{
+		CompleteFindContinuations({ ContinuationId }, *Results, true, EMultiplayerFindSessionsOutcome::Complete);
+	}
+	MultiplayerOnFindSessionsComplete.Broadcast(*Results, true, EMultiplayerFindSessionsOutcome::Complete);
+	return true;
+}
+
+void UMultiplayerSessionsSubsystem::CacheSearchResults(const FMultiplayerSessionSearchParams& Params, const TSharedRef<const TArray<FOnlineSessionSearchResult>>& SearchResults)
+{
+	if (SearchCacheTTLSeconds <= 0.f || SearchResults->Num() == 0)
+	{
+		SearchCache.Remove(Params);
+		return;
+	}
+
+	if (MaxCachedSearches > 0 && !SearchCache.Contains(Params) && SearchCache.Num() >= MaxCachedSearches)
+	{
+		//가장 오래된 검색부터 버림
+		const FMultiplayerSessionSearchParams* Oldest = nullptr;
+		double OldestTimestamp = TNumericLimits<double>::Max();
+		for (const TPair<FMultiplayerSessionSearchParams, FCachedSessionSearch>& Pair : SearchCache)
+		{
+			if (Pair.Value.Timestamp < OldestTimestamp)
+			{
+				OldestTimestamp = Pair.Value.Timestamp;
+				Oldest = &Pair.Key;
+			}
+		}
+		if (Oldest)
+		{
+			const FMultiplayerSessionSearchParams OldestParams = *Oldest;
+			SearchCache.Remove(OldestParams);
+		}
+	}
+
+	FCachedSessionSearch& Cached = SearchCache.FindOrAdd(Params);
+	Cached.Results = SearchResults;
+	Cached.Timestamp = FPlatformTime::Seconds();
+}
+
+void UMultiplayerSessionsSubsystem::EvictSessionFromCache(const FString& SessionId)
+{
+	for (auto It = SearchCache.CreateIterator(); It; ++It)
+	{
+		FCachedSessionSearch& Cached = It.Value();
+		const int32 FoundIndex = Cached.Results->IndexOfByPredicate([&SessionId](const FOnlineSessionSearchResult& Result)
+			{
+				return Result.GetSessionIdStr() == SessionId;
+			});
+		if (FoundIndex == INDEX_NONE)
+		{
+			continue;
+		}
+
+		//다른 곳에서 보고있을수도 있는 배열은 건드리지 않고 새로 만들어서 교체
+		TArray<FOnlineSessionSearchResult> Remaining = *Cached.Results;
+		Remaining.RemoveAt(FoundIndex);
+		if (Remaining.Num() == 0)
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+		Cached.Results = MakeShared<const TArray<FOnlineSessionSearchResult>>(MoveTemp(Remaining));
+	}
+}
+
+void UMultiplayerSessionsSubsystem::JoinSession(const FOnlineSessionSearchResult& SessionResult)
+{
+	QueueJoinSession(SessionResult);
+}
+
+bool UMultiplayerSessionsSubsystem::QueueJoinSession(const FOnlineSessionSearchResult& SessionResult, uint32 ContinuationId)
+{
+	if (!EnsureSessionInterface())
+	{
+		NotifyJoinSessionComplete(EOnJoinSessionCompleteResult::UnknownError);
+		return false;
+	}
+
+	//캐시 갱신 때문에 참가가 늦어지지 않게 갱신은 포기
+	if (bBackgroundSearch)
+	{
+		CancelActiveSearch();
+	}
+
+	FString HostMapPath;
+	if (SessionResult.Session.SessionSettings.Get(SETTING_MAPNAME, HostMapPath))
+	{
+		PrewarmTravelMap(HostMapPath);
+	}
+
+	EnqueueSessionOp(EMultiplayerSessionOp::Join, [this, SessionResult]()
+		{
+			BeginJoinSession(SessionResult);
+		}, ContinuationId);
+	return true;
+}
+
+void UMultiplayerSessionsSubsystem::BeginJoinSession(const FOnlineSessionSearchResult& SessionResult)
+{
+	PendingJoinSessionId = SessionResult.GetSessionIdStr();
+	if (IsLanSearchResult(SessionResult))
+	{
+		JoinLanHost(SessionResult);
+		return;
+	}
+	JoinSessionCompleteDelegateHandle = SessionInterface->AddOnJoinSessionCompleteDelegate_Handle(JoinSessionCompletedDelegate);
+	const FUniqueNetIdPtr LocalPlayerId = GetLocalPlayerNetId();
+	const bool bJoinStarted = LocalPlayerId.IsValid()
+		? SessionInterface->JoinSession(*LocalPlayerId, NAME_GameSession, SessionResult)
+		: SessionInterface->JoinSession(0, NAME_GameSession, SessionResult);
+	if (!bJoinStarted)
+	{
+		SessionInterface->ClearOnJoinSessionCompleteDelegate_Handle(JoinSessionCompleteDelegateHandle);
+		FinishSessionOp(EMultiplayerSessionOp::Join, false);
+
+		NotifyJoinSessionComplete(EOnJoinSessionCompleteResult::UnknownError);
+	}
+}
+
+void UMultiplayerSessionsSubsystem::JoinLanHost(const FOnlineSessionSearchResult& SessionResult)
+{
+	//LAN 호스트는 백엔드 세션이 없음, 주소와 설정만 들고 있다가 이동/비콘 예약에 씀
+	JoinedLanAddress = FMultiplayerLanDiscovery::GetHostAddress(SessionResult);
+	if (JoinedLanAddress.IsEmpty())
+	{
+		FinishSessionOp(EMultiplayerSessionOp::Join, false);
+		NotifyJoinSessionComplete(EOnJoinSessionCompleteResult::CouldNotRetrieveAddress);
+		return;
+	}
+	JoinedLanSettings = SessionResult.Session.SessionSettings;
+	bGameSessionOnLan = true;
+	OnJoinSessionComplete(NAME_GameSession, EOnJoinSessionCompleteResult::Success);
+}
+
+void UMultiplayerSessionsSubsystem::DestroySession()
+{
+	QueueDestroySession();
+}
+
+bool UMultiplayerSessionsSubsystem::QueueDestroySession(uint32 ContinuationId)
+{
+	if (!EnsureSessionInterface())
+	{
+		NotifyDestroySessionComplete(false);
+		return false;
+	}
+
+	EnqueueSessionOp(EMultiplayerSessionOp::Destroy, [this]()
+		{
+			BeginDestroySession();
+		}, ContinuationId);
+	return true;
+}
+
+void UMultiplayerSessionsSubsystem::BeginDestroySession()
+{
+	if (bGameSessionOnLan)
+	{
+		//LAN 참가는 백엔드에 지울 세션이 없음
+		OnDestroySessionComplete(NAME_GameSession, true);
+		return;
+	}
+
+	DestroySessionCompleteDelegateHandle = SessionInterface->AddOnDestroySessionCompleteDelegate_Handle(DestroySessionCompletedDelegate);
+
+	if (!SessionInterface->DestroySession(NAME_GameSession))
+	{
+		SessionInterface->ClearOnDestroySessionCompleteDelegate_Handle(DestroySessionCompleteDelegateHandle);
+		FinishSessionOp(EMultiplayerSessionOp::Destroy, false);
+		NotifyDestroySessionComplete(false);
+	}
+}
+
+void UMultiplayerSessionsSubsystem::StartSession()
+{
+	QueueStartSession();
+}
+
+bool UMultiplayerSessionsSubsystem::QueueStartSession(uint32 ContinuationId)
+{
+	if (!EnsureSessionInterface())
+	{
+		NotifyStartSessionComplete(false);
+		return false;
+	}
+
+	EnqueueSessionOp(EMultiplayerSessionOp::Start, [this]()
+		{
+			BeginStartSession();
+		}, ContinuationId);
+	return true;
+}
+
+void UMultiplayerSessionsSubsystem::BeginStartSession()
+{
+	if (bGameSessionOnLan)
+	{
+		OnStartSessionComplete(NAME_GameSession, true);
+		return;
+	}
+
+	StartSessionCompleteDelegateHandle = SessionInterface->AddOnStartSessionCompleteDelegate_Handle(StartSessionCompletedDelegate);
+
+	if (!SessionInterface->StartSession(NAME_GameSession))
+	{
+		SessionInterface->ClearOnStartSessionCompleteDelegate_Handle(StartSessionCompleteDelegateHandle);
+		FinishSessionOp(EMultiplayerSessionOp::Start, false);
+		NotifyStartSessionComplete(false);
+	}
+}
+
+void UMultiplayerSessionsSubsystem::SetSessionInterfaceOverride(IOnlineSessionPtr InSessionInterface)
+{
+	ensureMsgf(ActiveSessionOp == EMultiplayerSessionOp::None && PendingSessionOps.Num() == 0, TEXT("Session interface swapped while a session op is pending"));
+
+	StopStreamingSearch();
+	CancelLanSearch();
+	ClearSearchCache();
+	LastSessionSearch.Reset();
+	LanSearchResults.Empty();
+	bLanSearchActive = false;
+	bGameSessionOnLan = false;
+	JoinedLanAddress.Reset();
+	RankedSearchResults = MakeShared<const TArray<FOnlineSessionSearchResult>>();
+	SessionIndex.Reset();
+	++SearchSerial;
+	CancelQosProbe();
+	MultiplayerOnSearchResultsReplaced.Broadcast();
+
+	bUsingSessionInterfaceOverride = InSessionInterface.IsValid();
+	if (bUsingSessionInterfaceOverride)
+	{
+		SessionInterface = InSessionInterface;
+		return;
+	}
+
+	//원래 백엔드는 다음 세션 호출때 다시 가져옴
+	SessionInterface.Reset();
+	OnlineSubsystemName = NAME_None;
+	bOnlineInitialized = false;
+}
+
+void UMultiplayerSessionsSubsystem::ClearSearchCache()
+{
+	SearchCache.Reset();
+	UpdateSearchMemoryStats();
+}
+
+void UMultiplayerSessionsSubsystem::ResetSessionSearch()
+{
+	//취소된 검색을 백엔드가 아직 잡고 있으면 늦게 오는 결과가 섞이니 새로 만듬
+	if (!LastSessionSearch.IsValid() || LastSessionSearch.GetSharedReferenceCount() > 1 || LastSessionSearch->SearchState == EOnlineAsyncTaskState::InProgress)
+	{
+		LastSessionSearch = MakeShared<FOnlineSessionSearch>();
+		return;
+	}
+	LastSessionSearch->SearchResults.Reset();
+	LastSessionSearch->QuerySettings = FOnlineSearchSettings();
+	LastSessionSearch->SearchState = EOnlineAsyncTaskState::NotStarted;
+}
+
+void UMultiplayerSessionsSubsystem::ReleaseSearchResults()
+{
+	//참가가 끝났으면 검색 결과는 다시 볼 일이 없음, 메뉴로 돌아오면 캐시도 어차피 만료됨
+	if (LastSessionSearch.IsValid() && LastSessionSearch.GetSharedReferenceCount() == 1)
+	{
+		LastSessionSearch->SearchResults.Empty();
+	}
+	else
+	{
+		LastSessionSearch.Reset();
+	}
+	LanSearchResults.Empty();
+	bLanSearchActive = false;
+	RankedSearchResults = MakeShared<const TArray<FOnlineSessionSearchResult>>();
+	SessionIndex.Empty();
+	SearchCache.Empty();
+	//아직 핑을 재고 있는 검색이 결과를 되살려 캐시하지 않게
+	++SearchSerial;
+	CancelQosProbe();
+	UpdateSearchMemoryStats();
+	MultiplayerOnSearchResultsReplaced.Broadcast();
+}
+
+void UMultiplayerSessionsSubsystem::UpdateSearchMemoryStats() const
+{
+	//세션 설정 맵과 배열 할당만 셈, 문자열 값은 제외한 추정치
+	int32 NumStoredResults = 0;
+	SIZE_T AllocatedBytes = SessionIndex.GetAllocatedSize() + SearchCache.GetAllocatedSize();
+	auto CountResults = [&NumStoredResults, &AllocatedBytes](const TArray<FOnlineSessionSearchResult>& Results)
+		{
+			NumStoredResults += Results.Num();
+			AllocatedBytes += Results.GetAllocatedSize();
+			for (const FOnlineSessionSearchResult& Result : Results)
+			{
+				AllocatedBytes += Result.Session.SessionSettings.Settings.GetAllocatedSize() + Result.Session.OwningUserName.GetAllocatedSize();
+				if (Result.Session.SessionInfo.IsValid())
+				{
+					AllocatedBytes += Result.Session.SessionInfo->GetSize();
+				}
+			}
+		};
+	if (LastSessionSearch.IsValid())
+	{
+		CountResults(LastSessionSearch->SearchResults);
+	}
+	CountResults(LanSearchResults);
+	CountResults(*RankedSearchResults);
+	for (const TPair<FMultiplayerSessionSearchParams, FCachedSessionSearch>& Pair : SearchCache)
+	{
+		//캐시에서 꺼낸 결과는 같은 배열이라 두번 세지 않음
+		if (Pair.Value.Results.Get() == &RankedSearchResults.Get())
+		{
+			continue;
+		}
+		CountResults(*Pair.Value.Results);
+	}
+	FMultiplayerSessionsStats::Get().SetSearchMemory(NumStoredResults, AllocatedBytes);
+}
+
+void UMultiplayerSessionsSubsystem::PrewarmTravelMap(const FString& MapPath)
+{
+	//?listen 같은 URL 옵션은 패키지 이름이 아님
+	FString PackageName = MapPath;
+	int32 OptionsStart = INDEX_NONE;
+	if (PackageName.FindChar(TEXT('?'), OptionsStart))
+	{
+		PackageName.LeftInline(OptionsStart);
+	}
+	if (!FPackageName::IsValidLongPackageName(PackageName))
+	{
+		UE_LOG(LogMultiplayerSessions, Warning, TEXT("Not prewarming '%s', it is not a long package name"), *MapPath);
+		return;
+	}
+
+	const FName PackageFName(*PackageName);
+	if (PackageFName == PrewarmingMapName)
+	{
+		return;
+	}
+	ReleasePrewarmedMap();
+
+	//PIE 는 맵 패키지 이름에 접두사가 붙어서 미리 로드한 패키지를 쓰지 못함
+	const UWorld* World = GetWorld();
+	if (World && World->IsPlayInEditor())
+	{
+		return;
+	}
+
+	PrewarmingMapName = PackageFName;
+	FMultiplayerSessionsStats::Get().BeginTimer(EMultiplayerSessionTimer::MapPrewarm);
+	LoadPackageAsync(PackageName, FLoadPackageAsyncDelegate::CreateUObject(this, &ThisClass::OnTravelMapPrewarmed));
+}
+
+void UMultiplayerSessionsSubsystem::OnTravelMapPrewarmed(const FName& PackageName, UPackage* LoadedPackage, EAsyncLoadingResult::Type Result)
+{
+	//그 사이에 다른 맵으로 바뀌었거나 취소됨
+	if (PackageName != PrewarmingMapName)
+	{
+		return;
+	}
+
+	UWorld* LoadedWorld = Result == EAsyncLoadingResult::Succeeded && LoadedPackage != nullptr ? UWorld::FindWorldInPackage(LoadedPackage) : nullptr;
+	FMultiplayerSessionsStats::Get().EndTimer(EMultiplayerSessionTimer::MapPrewarm, LoadedWorld != nullptr);
+	if (LoadedWorld == nullptr)
+	{
+		UE_LOG(LogMultiplayerSessions, Warning, TEXT("Failed to prewarm travel map %s"), *PackageName.ToString());
+		ReleasePrewarmedMap();
+		return;
+	}
+	PrewarmedWorld = LoadedWorld;
+}
+
+void UMultiplayerSessionsSubsystem::OnPostLoadMap(UWorld* LoadedWorld)
+{
+	//이동이 끝났으니 이제 월드가 패키지를 잡고 있음
+	ReleasePrewarmedMap();
+	//하드 트래블이면 다시 접속하는 동안 인원이 바뀜
+	MarkSessionPlayerCountDirty();
+	StartReservationBeacon(LoadedWorld);
+	RegisterDedicatedSession(LoadedWorld);
+}
+
+void UMultiplayerSessionsSubsystem::StartReservationBeacon(UWorld* World)
+{
+	if (World == nullptr || !SessionInterface.IsValid() || bUsingSessionInterfaceOverride)
+	{
+		return;
+	}
+	//클라이언트나 메뉴 맵(스탠드얼론)은 곧 떠나거나 받을 사람이 없음
+	const ENetMode NetMode = World->GetNetMode();
+	if (NetMode != NM_ListenServer && NetMode != NM_DedicatedServer)
+	{
+		return;
+	}
+	const FNamedOnlineSession* Session = SessionInterface->GetNamedSession(NAME_GameSession);
+	if (Session == nullptr || !Session->bHosting)
+	{
+		return;
+	}
+	if (ReservationBeaconHost.IsValid() && ReservationBeaconHost->GetWorld() == World)
+	{
+		return;
+	}
+	StopReservationBeacon();
+
+	AOnlineBeaconHost* BeaconHost = World->SpawnActor<AOnlineBeaconHost>();
+	if (BeaconHost)
+	{
+		//InitHost 가 실제로 잡은 포트로 ListenPort 를 바꿔주니 광고는 GetListenPort 로
+		BeaconHost->ListenPort = FMath::Max(BeaconPort, 0);
+	}
+	if (BeaconHost == nullptr || !BeaconHost->InitHost())
+	{
+		UE_LOG(LogMultiplayerSessions, Warning, TEXT("Could not start the reservation beacon, clients will travel without reserving"));
+		if (BeaconHost)
+		{
+			BeaconHost->DestroyBeacon();
+		}
+		return;
+	}
+	AMultiplayerReservationBeaconHostObject* HostObject = World->SpawnActor<AMultiplayerReservationBeaconHostObject>();
+	HostObject->Init(this, ReservationTimeoutSeconds);
+	BeaconHost->RegisterHost(HostObject);
+	BeaconHost->PauseBeaconRequests(false);
+
+	ReservationBeaconHost = BeaconHost;
+	ReservationHostObject = HostObject;
+	BeaconListenPort = BeaconHost->GetListenPort();
+	//비콘 포트를 광고하도록 바로 업데이트
+	LastAdvertisedOpenSlots = INDEX_NONE;
+	MarkSessionPlayerCountDirty();
+}
+
+void UMultiplayerSessionsSubsystem::StopReservationBeacon()
+{
+	if (ReservationBeaconHost.IsValid())
+	{
+		ReservationBeaconHost->DestroyBeacon();
+	}
+	if (ReservationHostObject.IsValid())
+	{
+		ReservationHostObject->Destroy();
+	}
+	ReservationBeaconHost.Reset();
+	ReservationHostObject.Reset();
+	BeaconListenPort = 0;
+}
+
+bool UMultiplayerSessionsSubsystem::BeginSlotReservation()
+{
+	if (!bReserveSlotBeforeTravel || bUsingSessionInterfaceOverride)
+	{
+		return false;
+	}
+	const FNamedOnlineSession* Session = SessionInterface->GetNamedSession(NAME_GameSession);
+	const FOnlineSessionSettings* JoinedSettings = bGameSessionOnLan ? &JoinedLanSettings : (Session ? &Session->SessionSettings : nullptr);
+	int32 HostBeaconPort = 0;
+	if (JoinedSettings == nullptr || !JoinedSettings->Get(SETTING_BEACONPORT, HostBeaconPort) || HostBeaconPort <= 0)
+	{
+		return false;
+	}
+
+	FString BeaconAddress;
+	UWorld* World = GetWorld();
+	if (World == nullptr || !GetResolvedConnectString(BeaconAddress, NAME_BeaconPort))
+	{
+		return false;
+	}
+
+	AMultiplayerReservationBeaconClient* Client = World->SpawnActor<AMultiplayerReservationBeaconClient>();
+	if (Client == nullptr)
+	{
+		return false;
+	}
+	Client->OnReservationComplete.BindUObject(this, &ThisClass::OnSlotReservationComplete);
+	if (!Client->RequestReservation(BeaconAddress, FUniqueNetIdRepl(GetLocalPlayerNetId()), ReservationResponseTimeoutSeconds))
+	{
+		Client->OnReservationComplete.Unbind();
+		Client->DestroyBeacon();
+		//세션은 광고했는데 연결조차 시작 못하면 자리를 확인할 수 없으니 실패로 처리
+		OnSlotReservationComplete(EMultiplayerReservationResult::Failed);
+		return true;
+	}
+	ReservationClient = Client;
+	return true;
+}
+
+void UMultiplayerSessionsSubsystem::OnSlotReservationComplete(EMultiplayerReservationResult Result)
+{
+	ReservationClient.Reset();
+	if (Result == EMultiplayerReservationResult::Accepted)
+	{
+		CompleteJoinSession(EOnJoinSessionCompleteResult::Success);
+		return;
+	}
+
+	//자리를 못 잡았으면 로컬에 만들어진 세션을 정리, 진행중인 Join 다음 순서로 들어감
+	DestroySession();
+	CompleteJoinSession(Result == EMultiplayerReservationResult::SessionFull
+		? EOnJoinSessionCompleteResult::SessionIsFull
+		: EOnJoinSessionCompleteResult::UnknownError);
+}
+
+void UMultiplayerSessionsSubsystem::AddReservedSlots(int32 Delta)
+{
+	ReservedSlots = FMath::Max(0, ReservedSlots + Delta);
+	MarkSessionPlayerCountDirty();
+}
+
+void UMultiplayerSessionsSubsystem::OnGameModePreLogin(AGameModeBase* GameMode, const FUniqueNetIdRepl& NewPlayer, FString& ErrorMessage)
+{
+	if (!ErrorMessage.IsEmpty() || GameMode == nullptr || GameMode->GetGameInstance() != GetGameInstance())
+	{
+		return;
+	}
+	//비콘을 광고하는 동안은 자리를 예약한 플레이어만 받음
+	if (!bReserveSlotBeforeTravel || !ReservationHostObject.IsValid() || AdmittedPlayers.Contains(NewPlayer))
+	{
+		return;
+	}
+	if (!NewPlayer.IsValid() || !ReservationHostObject->HasReservation(NewPlayer))
+	{
+		UE_LOG(LogMultiplayerSessions, Warning, TEXT("Rejected %s, no slot reservation"), *NewPlayer.ToDebugString());
+		ErrorMessage = TEXT("No slot reservation");
+	}
+}
+
+void UMultiplayerSessionsSubsystem::OnGameModePostLogin(AGameModeBase* GameMode, APlayerController* NewPlayer)
+{
+	if (GameMode && GameMode->GetGameInstance() == GetGameInstance())
+	{
+		//예약하고 들어온 플레이어는 이제 접속 인원으로 셈
+		if (ReservationHostObject.IsValid() && NewPlayer && NewPlayer->PlayerState)
+		{
+			const FUniqueNetIdRepl& PlayerId = NewPlayer->PlayerState->GetUniqueId();
+			ReservationHostObject->ConsumeReservation(PlayerId);
+			if (PlayerId.IsValid())
+			{
+				AdmittedPlayers.Add(PlayerId);
+			}
+		}
+		MarkSessionPlayerCountDirty();
+	}
+}
+
+void UMultiplayerSessionsSubsystem::OnGameModeLogout(AGameModeBase* GameMode, AController* Exiting)
+{
+	if (GameMode && GameMode->GetGameInstance() == GetGameInstance())
+	{
+		MarkSessionPlayerCountDirty();
+	}
+}
+
+void UMultiplayerSessionsSubsystem::MarkSessionPlayerCountDirty()
+{
+	if (bSessionUpdateScheduled || !SessionInterface.IsValid())
+	{
+		return;
+	}
+	const FNamedOnlineSession* Session = SessionInterface->GetNamedSession(NAME_GameSession);
+	if (Session == nullptr || !Session->bHosting)
+	{
+		return;
+	}
+
+	//여러 명이 한꺼번에 들어와도 간격 안에서는 한번만 올림
+	bSessionUpdateScheduled = true;
+	const double Delay = FMath::Max(0.0, LastSessionUpdateSeconds + SessionUpdateIntervalSeconds - FPlatformTime::Seconds());
+	SessionUpdateTickerHandle = FTSTicker::GetCoreTicker().AddTicker(
+		FTickerDelegate::CreateUObject(this, &ThisClass::OnSessionUpdateTimer),
+		static_cast<float>(Delay)
+	);
+}
+
+bool UMultiplayerSessionsSubsystem::OnSessionUpdateTimer(float DeltaTime)
+{
+	bSessionUpdateScheduled = false;
+	SessionUpdateTickerHandle.Reset();
+	FlushSessionPlayerCount();
+	//한번만 실행
+	return false;
+}
+
+int32 UMultiplayerSessionsSubsystem::GetHostOpenSlots() const
+{
+	const FNamedOnlineSession* Session = SessionInterface.IsValid() ? SessionInterface->GetNamedSession(NAME_GameSession) : nullptr;
+	if (Session == nullptr)
+	{
+		return 0;
+	}
+	//이벤트 개수를 세지 않고 게임모드에서 직접 읽어서 트래블 중에도 어긋나지 않게 함
+	const UWorld* World = GetWorld();
+	const AGameModeBase* GameMode = World ? World->GetAuthGameMode() : nullptr;
+	const int32 ConnectedPlayers = GameMode ? GameMode->GetNumPlayers() : 0;
+	return FMath::Max(0, Session->SessionSettings.NumPublicConnections - ConnectedPlayers - ReservedSlots);
+}
+
+void UMultiplayerSessionsSubsystem::FlushSessionPlayerCount()
+{
+	if (!SessionInterface.IsValid())
+	{
+		return;
+	}
+	const FNamedOnlineSession* Session = SessionInterface->GetNamedSession(NAME_GameSession);
+	if (Session == nullptr || !Session->bHosting)
+	{
+		return;
+	}
+
+	//LAN 응답은 로컬이라 바뀐게 없어도 매번 갱신 (비콘 포트, 게임 포트도 여기서 반영)
+	UpdateLanAdvertisement();
+
+	//이벤트 개수를 세지 않고 게임모드에서 직접 읽어서 트래블 중에도 어긋나지 않게 함
+	const int32 OpenSlots = GetHostOpenSlots();
+	if (OpenSlots == LastAdvertisedOpenSlots)
+	{
+		return;
+	}
+	LastAdvertisedOpenSlots = OpenSlots;
+	LastSessionUpdateSeconds = FPlatformTime::Seconds();
+
+	FOnlineSessionSettings UpdatedSettings = Session->SessionSettings;
+	UpdatedSettings.Set(SETTING_OPENSLOTS, OpenSlots, EOnlineDataAdvertisementType::ViaOnlineServiceAndPing);
+	if (BeaconListenPort > 0)
+	{
+		UpdatedSettings.Set(SETTING_BEACONPORT, BeaconListenPort, EOnlineDataAdvertisementType::ViaOnlineService);
+	}
+	EnqueueSessionOp(EMultiplayerSessionOp::Update, [this, UpdatedSettings]() mutable
+		{
+			BeginUpdateSession(UpdatedSettings);
+		});
+}
+
+void UMultiplayerSessionsSubsystem::BeginUpdateSession(FOnlineSessionSettings& UpdatedSettings)
+{
+	UpdateSessionCompleteDelegateHandle = SessionInterface->AddOnUpdateSessionCompleteDelegate_Handle(UpdateSessionCompletedDelegate);
+	if (!SessionInterface->UpdateSession(NAME_GameSession, UpdatedSettings, true))
+	{
+		SessionInterface->ClearOnUpdateSessionCompleteDelegate_Handle(UpdateSessionCompleteDelegateHandle);
+		//다음 변화 때 다시 올리도록
+		LastAdvertisedOpenSlots = INDEX_NONE;
+		FinishSessionOp(EMultiplayerSessionOp::Update, false);
+	}
+}
+
+void UMultiplayerSessionsSubsystem::OnUpdateSessionComplete(FName SessionName, bool bWasSuccessful)
+{
+	if (SessionInterface)
+	{
+		SessionInterface->ClearOnUpdateSessionCompleteDelegate_Handle(UpdateSessionCompleteDelegateHandle);
+	}
+	if (!bWasSuccessful)
+	{
+		LastAdvertisedOpenSlots = INDEX_NONE;
+	}
+	FinishSessionOp(EMultiplayerSessionOp::Update, bWasSuccessful);
+}
+
+void UMultiplayerSessionsSubsystem::ReleasePrewarmedMap()
+{
+	FMultiplayerSessionsStats::Get().CancelTimer(EMultiplayerSessionTimer::MapPrewarm);
+	PrewarmedWorld = nullptr;
+	PrewarmingMapName = NAME_None;
+}
+
+FUniqueNetIdPtr UMultiplayerSessionsSubsystem::GetLocalPlayerNetId() const
+{
+	const UWorld* World = GetWorld();
+	const ULocalPlayer* LocalPlayer = World ? World->GetFirstLocalPlayerFromController() : nullptr;
+	if (LocalPlayer == nullptr)
+	{
+		return nullptr;
+	}
+	return LocalPlayer->GetPreferredUniqueNetId().GetUniqueNetId();
+}
+
+EMultiplayerSessionTimer UMultiplayerSessionsSubsystem::GetSessionOpTimer(EMultiplayerSessionOp Op)
+{
+	switch (Op)
+	{
+	case EMultiplayerSessionOp::Create:		return EMultiplayerSessionTimer::CreateSession;
+	case EMultiplayerSessionOp::Find:		return EMultiplayerSessionTimer::FindSessions;
+	case EMultiplayerSessionOp::Join:		return EMultiplayerSessionTimer::JoinSession;
+	case EMultiplayerSessionOp::Destroy:	return EMultiplayerSessionTimer::DestroySession;
+	case EMultiplayerSessionOp::Update:		return EMultiplayerSessionTimer::UpdateSession;
+	default:								return EMultiplayerSessionTimer::StartSession;
+	}
+}
+
+EMultiplayerSessionOpStatus UMultiplayerSessionsSubsystem::GetSessionOpStatus(EMultiplayerSessionOp Op) const
+{
+	return SessionOpStatuses[static_cast<int32>(Op)];
+}
+
+void UMultiplayerSessionsSubsystem::EnqueueSessionOp(EMultiplayerSessionOp Op, TFunction<void()>&& Begin, uint32 ContinuationId, const FMultiplayerSessionSearchParams& SearchParams)
+{
+	//같은 작업이 이미 대기중이면 새로 쌓지 않음, Create/Find/Join 은 마지막 요청으로 교체
+	if (FQueuedSessionOp* Queued = PendingSessionOps.FindByPredicate([Op](const FQueuedSessionOp& Pending) { return Pending.Op == Op; }))
+	{
+		if (Op != EMultiplayerSessionOp::Destroy && Op != EMultiplayerSessionOp::Start)
+		{
+			Queued->Begin = MoveTemp(Begin);
+			Queued->SearchParams = SearchParams;
+		}
+		//교체된 호출도 대기중인 작업의 결과를 받음
+		if (ContinuationId != 0)
+		{
+			Queued->ContinuationIds.Add(ContinuationId);
+		}
+		return;
+	}
+	//이미 파괴중인 세션을 또 파괴할 필요는 없음
+	if (Op == EMultiplayerSessionOp::Destroy && ActiveSessionOp == EMultiplayerSessionOp::Destroy)
+	{
+		if (ContinuationId != 0)
+		{
+			ActiveContinuationIds.Add(ContinuationId);
+		}
+		return;
+	}
+
+	FQueuedSessionOp& Queued = PendingSessionOps.Add_GetRef({ Op, MoveTemp(Begin), SearchParams });
+	if (ContinuationId != 0)
+	{
+		Queued.ContinuationIds.Add(ContinuationId);
+	}
+	SetSessionOpStatus(Op, EMultiplayerSessionOpStatus::Queued);
+	PumpSessionOps();
+}
+
+void UMultiplayerSessionsSubsystem::PumpSessionOps()
+{
+	if (bPumpingSessionOps)
+	{
+		return;
+	}
+	TGuardValue<bool> PumpGuard(bPumpingSessionOps, true);
+
+	//Begin 안에서 바로 실패하면 ActiveSessionOp 이 비워지니 다음 작업을 계속 진행
+	while (ActiveSessionOp == EMultiplayerSessionOp::None && PendingSessionOps.Num() > 0)
+	{
+		FQueuedSessionOp Next = MoveTemp(PendingSessionOps[0]);
+		PendingSessionOps.RemoveAt(0);
+
+		ActiveSessionOp = Next.Op;
+		ActiveContinuationIds = MoveTemp(Next.ContinuationIds);
+		SetSessionOpStatus(Next.Op, EMultiplayerSessionOpStatus::InFlight);
+		//큐에서 기다린 시간은 빼고 백엔드 호출부터 완료까지만 잰다
+		FMultiplayerSessionsStats::Get().BeginTimer(GetSessionOpTimer(Next.Op));
+		Next.Begin();
+	}
+}
+
+void UMultiplayerSessionsSubsystem::FinishSessionOp(EMultiplayerSessionOp Op, bool bWasSuccessful)
+{
+	if (ActiveSessionOp != Op)
+	{
+		return;
+	}
+	ActiveSessionOp = EMultiplayerSessionOp::None;
+	ParkActiveContinuations(Op);
+	FMultiplayerSessionsStats::Get().EndTimer(GetSessionOpTimer(Op), bWasSuccessful);
+	SetSessionOpStatus(Op, bWasSuccessful ? EMultiplayerSessionOpStatus::Succeeded : EMultiplayerSessionOpStatus::Failed);
+
+	//다음 작업은 리스너에게 알리기 전에 바로 시작해서 백엔드가 쉬는 시간을 없앰
+	PumpSessionOps();
+}
+
+void UMultiplayerSessionsSubsystem::ParkActiveContinuations(EMultiplayerSessionOp Op)
+{
+	if (ActiveContinuationIds.Num() == 0)
+	{
+		return;
+	}
+	//다음 작업이 ActiveContinuationIds 를 쓰니 알릴때까지 따로 보관, 검색은 어느 검색을 기다렸는지도 남김
+	CompletedContinuations.Add({ Op, MoveTemp(ActiveContinuationIds), Op == EMultiplayerSessionOp::Find ? SearchSerial : 0u });
+	ActiveContinuationIds.Reset();
+}
+
+void UMultiplayerSessionsSubsystem::SetSessionOpStatus(EMultiplayerSessionOp Op, EMultiplayerSessionOpStatus Status)
+{
+	SessionOpStatuses[static_cast<int32>(Op)] = Status;
+	MultiplayerOnSessionOpStatusChanged.Broadcast(Op, Status);
+}
+
+FMultiplayerSessionOpHandle UMultiplayerSessionsSubsystem::CreateSessionAsync(int32 NumPublicConnections, const FString& MatchType, FMultiplayerSessionOpContinuation&& OnComplete)
+{
+	const uint32 ContinuationId = AddSessionOpContinuation(EMultiplayerSessionOp::Create);
+	SessionOpContinuations[ContinuationId].OnComplete = MoveTemp(OnComplete);
+	const bool bQueued = QueueCreateSession(NumPublicConnections, MatchType, false, ContinuationId);
+	return FinishAsyncCall(ContinuationId, bQueued);
+}
+
+FMultiplayerSessionOpHandle UMultiplayerSessionsSubsystem::FindSessionsAsync(const FMultiplayerSessionSearchParams& Params, FMultiplayerFindSessionsContinuation&& OnComplete, bool bStreamResults, float TimeoutSeconds)
+{
+	const uint32 ContinuationId = AddSessionOpContinuation(EMultiplayerSessionOp::Find);
+	SessionOpContinuations[ContinuationId].OnFindComplete = MoveTemp(OnComplete);
+	const bool bQueued = QueueFindSessions(Params, bStreamResults, TimeoutSeconds, ContinuationId);
+	return FinishAsyncCall(ContinuationId, bQueued);
+}
+
+FMultiplayerSessionOpHandle UMultiplayerSessionsSubsystem::JoinSessionAsync(const FOnlineSessionSearchResult& SessionResult, FMultiplayerJoinSessionContinuation&& OnComplete)
+{
+	const uint32 ContinuationId = AddSessionOpContinuation(EMultiplayerSessionOp::Join);
+	SessionOpContinuations[ContinuationId].OnJoinComplete = MoveTemp(OnComplete);
+	const bool bQueued = QueueJoinSession(SessionResult, ContinuationId);
+	return FinishAsyncCall(ContinuationId, bQueued);
+}
+
+FMultiplayerSessionOpHandle UMultiplayerSessionsSubsystem::DestroySessionAsync(FMultiplayerSessionOpContinuation&& OnComplete)
+{
+	const uint32 ContinuationId = AddSessionOpContinuation(EMultiplayerSessionOp::Destroy);
+	SessionOpContinuations[ContinuationId].OnComplete = MoveTemp(OnComplete);
+	const bool bQueued = QueueDestroySession(ContinuationId);
+	return FinishAsyncCall(ContinuationId, bQueued);
+}
+
+FMultiplayerSessionOpHandle UMultiplayerSessionsSubsystem::StartSessionAsync(FMultiplayerSessionOpContinuation&& OnComplete)
+{
+	const uint32 ContinuationId = AddSessionOpContinuation(EMultiplayerSessionOp::Start);
+	SessionOpContinuations[ContinuationId].OnComplete = MoveTemp(OnComplete);
+	const bool bQueued = QueueStartSession(ContinuationId);
+	return FinishAsyncCall(ContinuationId, bQueued);
+}
+
+void UMultiplayerSessionsSubsystem::CancelSessionOp(FMultiplayerSessionOpHandle& Handle)
+{
+	const uint32 ContinuationId = Handle.Id;
+	Handle.Reset();
+	const FSessionOpContinuation* Continuation = ContinuationId != 0 ? SessionOpContinuations.Find(ContinuationId) : nullptr;
+	if (Continuation == nullptr)
+	{
+		//이미 끝났거나 취소된 호출
+		return;
+	}
+	const EMultiplayerSessionOp Op = Continuation->Op;
+	SessionOpContinuations.Remove(ContinuationId);
+
+	//아직 시작 안한 작업은 기다리는 호출이 더 없으면 큐에서 뺌
+	const int32 QueuedIndex = PendingSessionOps.IndexOfByPredicate([ContinuationId](const FQueuedSessionOp& Pending) { return Pending.ContinuationIds.Contains(ContinuationId); });
+	if (QueuedIndex != INDEX_NONE)
+	{
+		FQueuedSessionOp& Queued = PendingSessionOps[QueuedIndex];
+		Queued.ContinuationIds.Remove(ContinuationId);
+		if (Queued.ContinuationIds.Num() == 0)
+		{
+			PendingSessionOps.RemoveAt(QueuedIndex);
+			if (ActiveSessionOp != Op)
+			{
+				SetSessionOpStatus(Op, EMultiplayerSessionOpStatus::Idle);
+			}
+		}
+		return;
+	}
+
+	//보낸 생성/참가는 되돌릴수 없지만 검색은 기다리는 곳이 없으면 멈춤
+	if (ActiveSessionOp == Op && ActiveContinuationIds.Remove(ContinuationId) > 0
+		&& Op == EMultiplayerSessionOp::Find && ActiveContinuationIds.Num() == 0 && !bBackgroundSearch
+		&& !MultiplayerOnFindSessionsComplete.IsBound() && !MultiplayerOnFindSessionsBatch.IsBound())
+	{
+		CancelActiveSearch();
+	}
+}
+
+uint32 UMultiplayerSessionsSubsystem::AddSessionOpContinuation(EMultiplayerSessionOp Op)
+{
+	//0 은 빈 핸들
+	if (++NextContinuationId == 0)
+	{
+		++NextContinuationId;
+	}
+	SessionOpContinuations.Add(NextContinuationId).Op = Op;
+	return NextContinuationId;
+}
+
+FMultiplayerSessionOpHandle UMultiplayerSessionsSubsystem::FinishAsyncCall(uint32 ContinuationId, bool bQueued)
+{
+	if (!bQueued)
+	{
+		//큐에 넣지도 못하고 돌아온 호출 (세션 인터페이스 없음)
+		FSessionOpContinuation Continuation;
+		if (SessionOpContinuations.RemoveAndCopyValue(ContinuationId, Continuation))
+		{
+			if (Continuation.OnFindComplete)
+			{
+				Continuation.OnFindComplete(TArray<FOnlineSessionSearchResult>(), false, EMultiplayerFindSessionsOutcome::Failed);
+			}
+			else if (Continuation.OnJoinComplete)
+			{
+				Continuation.OnJoinComplete(EOnJoinSessionCompleteResult::UnknownError);
+			}
+			else if (Continuation.OnComplete)
+			{
+				Continuation.OnComplete(false);
+			}
+		}
+	}
+
+	//캐시 결과처럼 이미 끝났으면 취소할 것이 없으니 빈 핸들
+	FMultiplayerSessionOpHandle Handle;
+	if (SessionOpContinuations.Contains(ContinuationId))
+	{
+		Handle.Id = ContinuationId;
+	}
+	return Handle;
+}
+
+void UMultiplayerSessionsSubsystem::TakeCompletedContinuations(EMultiplayerSessionOp Op, TArray<FSessionOpContinuation>& OutContinuations, uint32 ForSearchSerial)
+{
+	TArray<uint32> ContinuationIds;
+	for (int32 Index = CompletedContinuations.Num() - 1; Index >= 0; --Index)
+	{
+		const FCompletedContinuations& Completed = CompletedContinuations[Index];
+		if (Completed.Op != Op || (Op == EMultiplayerSessionOp::Find && Completed.SearchSerial != ForSearchSerial))
+		{
+			continue;
+		}
+		ContinuationIds.Append(Completed.ContinuationIds);
+		CompletedContinuations.RemoveAt(Index);
+		if (Op != EMultiplayerSessionOp::Find)
+		{
+			break;
+		}
+	}
+	TakeContinuations(ContinuationIds, OutContinuations);
+}
+
+void UMultiplayerSessionsSubsystem::TakeContinuations(const TArray<uint32>& ContinuationIds, TArray<FSessionOpContinuation>& OutContinuations)
+{
+	for (const uint32 ContinuationId : ContinuationIds)
+	{
+		//취소된 호출은 이미 맵에서 빠져있음
+		if (FSessionOpContinuation* Continuation = SessionOpContinuations.Find(ContinuationId))
+		{
+			OutContinuations.Add(MoveTemp(*Continuation));
+			SessionOpContinuations.Remove(ContinuationId);
+		}
+	}
+}
+
+void UMultiplayerSessionsSubsystem::NotifyCreateSessionComplete(bool bWasSuccessful)
+{
+	TArray<FSessionOpContinuation> Continuations;
+	TakeCompletedContinuations(EMultiplayerSessionOp::Create, Continuations);
+	for (FSessionOpContinuation& Continuation : Continuations)
+	{
+		if (Continuation.OnComplete)
+		{
+			Continuation.OnComplete(bWasSuccessful);
+		}
+	}
+	MultiplayerOnCreateSessionComplete.Broadcast(bWasSuccessful);
+}
+
+void UMultiplayerSessionsSubsystem::NotifyFindSessionsComplete(uint32 ForSearchSerial, const TArray<FOnlineSessionSearchResult>& SessionResults, bool bWasSuccessful, EMultiplayerFindSessionsOutcome Outcome, bool bBroadcast)
+{
+	TArray<FSessionOpContinuation> Continuations;
+	TakeCompletedContinuations(EMultiplayerSessionOp::Find, Continuations, ForSearchSerial);
+	for (FSessionOpContinuation& Continuation : Continuations)
+	{
+		if (Continuation.OnFindComplete)
+		{
+			Continuation.OnFindComplete(SessionResults, bWasSuccessful, Outcome);
+		}
+	}
+	if (bBroadcast)
+	{
+		MultiplayerOnFindSessionsComplete.Broadcast(SessionResults, bWasSuccessful, Outcome);
+	}
+}
+
+void UMultiplayerSessionsSubsystem::CompleteFindContinuations(const TArray<uint32>& ContinuationIds, const TArray<FOnlineSessionSearchResult>& SessionResults, bool bWasSuccessful, EMultiplayerFindSessionsOutcome Outcome)
+{
+	//콜백 안에서 새 호출을 등록할수 있으니 먼저 맵에서 빼고 부름
+	TArray<FSessionOpContinuation> Continuations;
+	TakeContinuations(ContinuationIds, Continuations);
+	for (FSessionOpContinuation& Continuation : Continuations)
+	{
+		if (Continuation.OnFindComplete)
+		{
+			Continuation.OnFindComplete(SessionResults, bWasSuccessful, Outcome);
+		}
+	}
+}
+
+void UMultiplayerSessionsSubsystem::NotifyJoinSessionComplete(EOnJoinSessionCompleteResult::Type Result)
+{
+	TArray<FSessionOpContinuation> Continuations;
+	TakeCompletedContinuations(EMultiplayerSessionOp::Join, Continuations);
+	for (FSessionOpContinuation& Continuation : Continuations)
+	{
+		if (Continuation.OnJoinComplete)
+		{
+			Continuation.OnJoinComplete(Result);
+		}
+	}
+	MultiplayerOnJoinSessionComplete.Broadcast(Result);
+}
+
+void UMultiplayerSessionsSubsystem::NotifyDestroySessionComplete(bool bWasSuccessful)
+{
+	TArray<FSessionOpContinuation> Continuations;
+	TakeCompletedContinuations(EMultiplayerSessionOp::Destroy, Continuations);
+	for (FSessionOpContinuation& Continuation : Continuations)
+	{
+		if (Continuation.OnComplete)
+		{
+			Continuation.OnComplete(bWasSuccessful);
+		}
+	}
+	MultiplayerOnDestroySessionComplete.Broadcast(bWasSuccessful);
+}
+
+void UMultiplayerSessionsSubsystem::NotifyStartSessionComplete(bool bWasSuccessful)
+{
+	TArray<FSessionOpContinuation> Continuations;
+	TakeCompletedContinuations(EMultiplayerSessionOp::Start, Continuations);
+	for (FSessionOpContinuation& Continuation : Continuations)
+	{
+		if (Continuation.OnComplete)
+		{
+			Continuation.OnComplete(bWasSuccessful);
+		}
+	}
+	MultiplayerOnStartSessionComplete.Broadcast(bWasSuccessful);
+}
+
+void UMultiplayerSessionsSubsystem::OnCretateSessionComplete(FName SessionName, bool bWasSuccessful)
+{
+	// 1. 세션이 생성 완료된 상황
+	if (SessionInterface)
+	{
+		SessionInterface->ClearOnCreateSessionCompleteDelegate_Handle(CreateSessionCompleteDelegateHandle);
+	}
+	if (!bWasSuccessful)
+	{
+		ReleasePrewarmedMap();
+		if (QosResponder.IsValid())
+		{
+			QosResponder->Shutdown();
+		}
+	}
+	FinishSessionOp(EMultiplayerSessionOp::Create, bWasSuccessful);
+	if (bWasSuccessful)
+	{
+		//새 세션이니 처음 인원을 바로 광고
+		LastAdvertisedOpenSlots = INDEX_NONE;
+		MarkSessionPlayerCountDirty();
+		//데디서버는 이미 맵이 떠 있으니 여기서 비콘을 띄움, 리슨서버는 로비 맵 로드 후
+		StartReservationBeacon(GetWorld());
+		AdvertiseOnLan();
+	}
+	//Broadcast가 성공적이면 bWasSuccessful에 true 값을 받아옴
+	NotifyCreateSessionComplete(bWasSuccessful);
+}
+
+void UMultiplayerSessionsSubsystem::OnFindSessionComplete(bool bWasSuccessful)
+{
+	//성공적으로 찾은 상황
+	if (SessionInterface)
+	{
+		SessionInterface->ClearOnFindSessionsCompleteDelegate_Handle(FindSessionsCompleteDelegateHandle);
+	}
+	if (bSearchCancelled)
+	{
+		//취소된 검색은 결과를 알리지 않음
+		return;
+	}
+	StopSearchDeadline();
+
+	//스트리밍 중이었다면 아직 전달하지 못한 나머지 결과를 먼저 보냄
+	const bool bWasStreaming = bStreamingSearch;
+	BroadcastStreamedBatch();
+	if (bWasStreaming && !bStreamingSearch)
+	{
+		//리스너가 마지막 배치에서 이미 세션을 골랐음
+		return;
+	}
+	StopStreamingSearch();
+	//온라인이 먼저 끝나면 그때까지 응답한 LAN 호스트만 합침
+	CancelLanSearch();
+
+	RankCompletedSearch(InFlightSearchParams);
+	MergeLanResults(InFlightSearchParams);
+	MultiplayerOnSearchResultsReplaced.Broadcast();
+	//알리기 전에 이 검색을 기다리는 호출을 SearchSerial 과 같이 넘겨둠
+	ParkActiveContinuations(EMultiplayerSessionOp::Find);
+	if (InFlightSearchParams.bProbeLatency && StartQosProbe(bWasSuccessful))
+	{
+		//핑 측정은 백엔드 호출이 아니니 다음 작업을 막지 않음
+		FinishSessionOp(EMultiplayerSessionOp::Find, bWasSuccessful);
+		return;
+	}
+	FinishFindSessions(bWasSuccessful);
+	FinishSessionOp(EMultiplayerSessionOp::Find, bWasSuccessful);
+}
+
+bool UMultiplayerSessionsSubsystem::StartQosProbe(bool bWasSuccessful)
+{
+	ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	if (SocketSubsystem == nullptr || !SessionInterface.IsValid())
+	{
+		return false;
+	}
+
+	//IP 주소로 접속하는 세션만 잴수 있음, 스팀 P2P 주소는 백엔드 핑을 그대로 씀
+	TArray<int32> ProbedResultIndices;
+	TArray<FString> HostAddresses;
+	for (int32 ResultIndex = 0; ResultIndex < RankedSearchResults->Num() && HostAddresses.Num() < QosProbeCandidates; ++ResultIndex)
+	{
+		const FOnlineSessionSearchResult& Result = (*RankedSearchResults)[ResultIndex];
+		int32 HostQosPort = 0;
+		FString ConnectInfo;
+		if (!Result.Session.SessionSettings.Get(SETTING_QOSPORT, HostQosPort) || HostQosPort <= 0
+			|| !ResolveSearchResultAddress(Result, ConnectInfo))
+		{
+			continue;
+		}
+		TSharedPtr<FInternetAddr> HostAddress = SocketSubsystem->GetAddressFromString(ConnectInfo);
+		if (!HostAddress.IsValid())
+		{
+			continue;
+		}
+		HostAddress->SetPort(HostQosPort);
+		HostAddresses.Add(HostAddress->ToString(true));
+		ProbedResultIndices.Add(ResultIndex);
+	}
+	if (HostAddresses.Num() == 0)
+	{
+		return false;
+	}
+
+	//작업은 핑을 재기 전에 끝나니 그 사이 캐시 결과나 참가가 RankedSearchResults 를 바꿀수 있음, 잰 결과는 복사본에 적용
+	TSharedRef<TArray<FOnlineSessionSearchResult>> ProbedResults = MakeShared<TArray<FOnlineSessionSearchResult>>(*RankedSearchResults);
+	TWeakObjectPtr<UMultiplayerSessionsSubsystem> WeakThis(this);
+	const uint32 ProbedSearchSerial = SearchSerial;
+	QosProbeSearchSerial = SearchSerial;
+	bQosProbeRefreshOnly = bBackgroundSearch;
+	QosProbeResults = RankedSearchResults;
+	FMultiplayerQosProbe::ProbeAsync(MoveTemp(HostAddresses), QosProbesPerHost, QosProbeTimeoutSeconds,
+		[WeakThis, ProbedSearchSerial, ProbedResults, ProbedResultIndices, bWasSuccessful](TArray<FMultiplayerQosResult>&& QosResults)
+		{
+			UMultiplayerSessionsSubsystem* Subsystem = WeakThis.Get();
+			if (Subsystem == nullptr || Subsystem->QosProbeSearchSerial != ProbedSearchSerial)
+			{
+				//취소되면서 기다리던 호출은 이미 알림을 받았음
+				return;
+			}
+			const bool bResultsReplaced = Subsystem->SearchSerial != ProbedSearchSerial || Subsystem->QosProbeResults != Subsystem->RankedSearchResults;
+			Subsystem->QosProbeSearchSerial = 0;
+			Subsystem->QosProbeResults.Reset();
+			ApplyQosResults(*ProbedResults, ProbedResultIndices, QosResults);
+			if (bResultsReplaced)
+			{
+				if (Subsystem->SearchSerial == ProbedSearchSerial)
+				{
+					Subsystem->bBackgroundSearch = false;
+				}
+				//다음 검색이나 캐시 결과가 이미 자리를 차지함, 지금 상태는 두고 이 검색을 기다리던 호출에만 알림
+				const EMultiplayerFindSessionsOutcome Outcome = bWasSuccessful ? EMultiplayerFindSessionsOutcome::Complete : EMultiplayerFindSessionsOutcome::Failed;
+				Subsystem->NotifyFindSessionsComplete(ProbedSearchSerial, *ProbedResults, bWasSuccessful, Outcome, false);
+				return;
+			}
+			Subsystem->RankedSearchResults = ProbedResults;
+			Subsystem->SessionIndex.Build(*ProbedResults);
+			Subsystem->MultiplayerOnSearchResultsReplaced.Broadcast();
+			Subsystem->FinishFindSessions(bWasSuccessful);
+		});
+	return true;
+}
+
+void UMultiplayerSessionsSubsystem::CancelQosProbe()
+{
+	if (QosProbeSearchSerial == 0)
+	{
+		return;
+	}
+	const uint32 ProbedSearchSerial = QosProbeSearchSerial;
+	const TSharedPtr<const TArray<FOnlineSessionSearchResult>> Results = MoveTemp(QosProbeResults);
+	QosProbeSearchSerial = 0;
+	QosProbeResults.Reset();
+	if (SearchSerial == ProbedSearchSerial)
+	{
+		//FinishFindSessions 가 불리지 않으니 여기서 내림
+		bBackgroundSearch = false;
+	}
+	//늦게 오는 측정 결과는 버리고 기다리던 호출에는 재기 전 순서로 보냄
+	NotifyFindSessionsComplete(ProbedSearchSerial, *Results, Results->Num() > 0, EMultiplayerFindSessionsOutcome::Cancelled, !bQosProbeRefreshOnly);
+}
+
+void UMultiplayerSessionsSubsystem::ApplyQosResults(TArray<FOnlineSessionSearchResult>& Results, const TArray<int32>& ProbedResultIndices, const TArray<FMultiplayerQosResult>& QosResults)
+{
+	//잰 후보들끼리만 점수순으로 자리를 바꿈, 나머지 결과의 순서는 그대로
+	TArray<int32> Order;
+	for (int32 ProbeIndex = 0; ProbeIndex < ProbedResultIndices.Num(); ++ProbeIndex)
+	{
+		if (!QosResults.IsValidIndex(ProbeIndex) || !Results.IsValidIndex(ProbedResultIndices[ProbeIndex]))
+		{
+			return;
+		}
+		Order.Add(ProbeIndex);
+		if (QosResults[ProbeIndex].WasReachable())
+		{
+			Results[ProbedResultIndices[ProbeIndex]].PingInMs = FMath::RoundToInt(QosResults[ProbeIndex].RttMs);
+		}
+	}
+	Algo::StableSort(Order, [&QosResults](int32 A, int32 B)
+		{
+			return QosResults[A].GetScore() < QosResults[B].GetScore();
+		});
+
+	TArray<FOnlineSessionSearchResult> Probed;
+	Probed.Reserve(Order.Num());
+	for (const int32 ProbeIndex : Order)
+	{
+		Probed.Add(MoveTemp(Results[ProbedResultIndices[ProbeIndex]]));
+	}
+	for (int32 Slot = 0; Slot < ProbedResultIndices.Num(); ++Slot)
+	{
+		Results[ProbedResultIndices[Slot]] = MoveTemp(Probed[Slot]);
+	}
+}
+
+void UMultiplayerSessionsSubsystem::FinishFindSessions(bool bWasSuccessful, bool bCacheResults)
+{
+	if (bWasSuccessful && bCacheResults)
+	{
+		CacheSearchResults(InFlightSearchParams, RankedSearchResults);
+	}
+	UpdateSearchMemoryStats();
+
+	if (bBackgroundSearch)
+	{
+		//캐시 갱신용 검색은 이미 캐시된 결과를 보냈으니 알리지 않음
+		bBackgroundSearch = false;
+		return;
+	}
+
+	if (RankedSearchResults->Num() <= 0)
+	{
+		//생성된 방이 없다면
+		//빈 배열 반환 , 성공여부 false
+		NotifyFindSessionsComplete(SearchSerial, TArray<FOnlineSessionSearchResult>(), false, bWasSuccessful ? EMultiplayerFindSessionsOutcome::Complete : EMultiplayerFindSessionsOutcome::Failed);
+		return;
+	}
+	NotifyFindSessionsComplete(SearchSerial, *RankedSearchResults, bWasSuccessful, bWasSuccessful ? EMultiplayerFindSessionsOutcome::Complete : EMultiplayerFindSessionsOutcome::Failed);
+}
+
+void UMultiplayerSessionsSubsystem::OnJoinSessionComplete(FName SessionName, EOnJoinSessionCompleteResult::Type Result)
+{
+	if (SessionInterface)
+	{
+		SessionInterface->ClearOnJoinSessionCompleteDelegate_Handle(JoinSessionCompleteDelegateHandle);
+	}
+
+	//이동하기 전에 비콘으로 자리부터 확인, 답이 오면 CompleteJoinSession
+	if (Result == EOnJoinSessionCompleteResult::Success && BeginSlotReservation())
+	{
+		return;
+	}
+	CompleteJoinSession(Result);
+}
+
+void UMultiplayerSessionsSubsystem::CompleteJoinSession(EOnJoinSessionCompleteResult::Type Result)
+{
+	//꽉 찼거나 없어진 세션은 캐시에서 빼서 재시도할때 다음 세션으로 가게 함
+	if (Result == EOnJoinSessionCompleteResult::SessionIsFull || Result == EOnJoinSessionCompleteResult::SessionDoesNotExist)
+	{
+		EvictSessionFromCache(PendingJoinSessionId);
+	}
+	PendingJoinSessionId.Reset();
+	if (Result != EOnJoinSessionCompleteResult::Success)
+	{
+		ReleasePrewarmedMap();
+	}
+	else
+	{
+		//다음 작업이 시작되기 전에 해제, 큐에 있던 검색의 결과를 지우지 않게
+		ReleaseSearchResults();
+	}
+	FinishSessionOp(EMultiplayerSessionOp::Join, Result == EOnJoinSessionCompleteResult::Success);
+
+	NotifyJoinSessionComplete(Result);
+}
+
+void UMultiplayerSessionsSubsystem::OnDestroySessionComplete(FName SessionName, bool bWasSuccessful)
+{
+	if (SessionInterface)
+	{
+		SessionInterface->ClearOnDestroySessionCompleteDelegate_Handle(DestroySessionCompleteDelegateHandle);
+	}
+	if (bWasSuccessful)
+	{
+		//다음 세션은 다시 온라인부터
+		bGameSessionOnLan = false;
+		JoinedLanAddress.Reset();
+		if (LanResponder.IsValid())
+		{
+			LanResponder->Shutdown();
+		}
+	}
+	if (bWasSuccessful && QosResponder.IsValid())
+	{
+		QosResponder->Shutdown();
+	}
+	if (bWasSuccessful)
+	{
+		//세션이 없어졌으니 그 세션으로 가려고 미리 올린 맵도 필요없음
+		ReleasePrewarmedMap();
+	}
+	if (bWasSuccessful)
+	{
+		//다음에 만드는 세션은 처음부터 다시 셈
+		FTSTicker::GetCoreTicker().RemoveTicker(SessionUpdateTickerHandle);
+		SessionUpdateTickerHandle.Reset();
+		bSessionUpdateScheduled = false;
+		StopReservationBeacon();
+		AdmittedPlayers.Reset();
+		LastAdvertisedOpenSlots = INDEX_NONE;
+		ReservedSlots = 0;
+	}
+	//대기중인 생성이 있으면 여기서 바로 시작됨
+	FinishSessionOp(EMultiplayerSessionOp::Destroy, bWasSuccessful);
+	//성공적으로 파괴됐다는걸 알림
+	NotifyDestroySessionComplete(bWasSuccessful);
+}
+
+void UMultiplayerSessionsSubsystem::OnStartSessionComplete(FName SessionName, bool bWasSuccessful)
+{
+	if (SessionInterface)
+	{
+		SessionInterface->ClearOnStartSessionCompleteDelegate_Handle(StartSessionCompleteDelegateHandle);
+	}
+	FinishSessionOp(EMultiplayerSessionOp::Start, bWasSuccessful);
+	NotifyStartSessionComplete(bWasSuccessful);
+}
+
+void UMultiplayerSessionsSubsystem::OnCancelFindSessionsComplete(bool bWasSuccessful)
+{
+	if (SessionInterface)
+	{
+		//검색 완료 핸들은 취소할때 이미 뗐음, 지금 핸들은 그 뒤에 시작한 검색 것
+		SessionInterface->ClearOnCancelFindSessionsCompleteDelegate_Handle(CancelFindSessionsCompleteDelegateHandle);
+	}
+	if (bAwaitingSearchCancel)
+	{
+		//취소가 끝났으니 잡아둔 Find 작업을 끝내고 다음 작업을 시작
+		bAwaitingSearchCancel = false;
+		FinishSessionOp(EMultiplayerSessionOp::Find, bCancelledSearchSucceeded);
+	}
 }
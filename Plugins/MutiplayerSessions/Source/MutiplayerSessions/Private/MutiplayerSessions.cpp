@@ -1,18 +1,25 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "MutiplayerSessions.h"
+#include "MultiplayerSessionsStats.h"
+
+DEFINE_LOG_CATEGORY(LogMultiplayerSessions);
 
 #define LOCTEXT_NAMESPACE "FMutiplayerSessionsModule"
 
 void FMutiplayerSessionsModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+	//온라인 서브시스템은 여기서 건드리지 않음, 첫 프레임 이후나 첫 세션 호출때 UMultiplayerSessionsSubsystem 이 띄움
+	FMultiplayerSessionsStats::Get().MarkStartupPhase(EMultiplayerStartupPhase::ModuleStartup);
+	FMultiplayerSessionsStats::Get().Startup();
 }
 
 void FMutiplayerSessionsModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+	FMultiplayerSessionsStats::Get().Shutdown();
 }
 
 #undef LOCTEXT_NAMESPACE
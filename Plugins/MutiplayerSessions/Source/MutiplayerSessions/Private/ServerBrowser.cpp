@@ -0,0 +1,395 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ServerBrowser.h"
+#include "MultiplayerSessionNames.h"
+#include "MultiplayerSessionsSubsystem.h"
+#include "MultiplayerSessionsStats.h"
+#include "MultiplayerSessionIndex.h"
+#include "Components/Button.h"
+#include "Components/ListView.h"
+#include "Components/TextBlock.h"
+#include "OnlineSessionSettings.h"
+
+void UServerBrowserEntry::NativeOnListItemObjectSet(UObject* ListItemObject)
+{
+	IUserObjectListEntry::NativeOnListItemObjectSet(ListItemObject);
+
+	const UServerBrowserItem* Item = Cast<UServerBrowserItem>(ListItemObject);
+	const UServerBrowser* Browser = Item ? Item->Browser.Get() : nullptr;
+	const FOnlineSessionSearchResult* Result = Browser ? Browser->GetRowResult(Item->RowIndex) : nullptr;
+	if (Result == nullptr)
+	{
+		ServerNameText->SetText(FText::GetEmpty());
+		return;
+	}
+
+	ServerNameText->SetText(FText::FromString(Result->Session.OwningUserName));
+	if (MatchTypeText)
+	{
+		FString MatchType;
+		Result->Session.SessionSettings.Get(SETTING_MATCHTYPE, MatchType);
+		MatchTypeText->SetText(FText::FromString(MatchType));
+	}
+	if (PlayersText)
+	{
+		const int32 MaxSlots = Result->Session.SessionSettings.NumPublicConnections;
+		const int32 Players = FMath::Max(0, MaxSlots - UMultiplayerSessionsSubsystem::GetOpenSlots(*Result));
+		PlayersText->SetText(FText::FromString(FString::Printf(TEXT("%d/%d"), Players, MaxSlots)));
+	}
+	if (PingText)
+	{
+		PingText->SetText(Result->PingInMs < MAX_QUERY_PING ? FText::AsNumber(Result->PingInMs) : FText::FromString(TEXT("-")));
+	}
+}
+
+void UServerBrowser::NativeConstruct()
+{
+	Super::NativeConstruct();
+
+	UGameInstance* GameInstance = GetGameInstance();
+	if (GameInstance)
+	{
+		MultiplayerSessionsSubsystem = GameInstance->GetSubsystem<UMultiplayerSessionsSubsystem>();
+	}
+	if (MultiplayerSessionsSubsystem)
+	{
+		//메뉴 등 다른 곳에서 한 검색도 서브시스템 결과를 바꾸니 모든 검색 완료를 받음
+		MultiplayerSessionsSubsystem->MultiplayerOnFindSessionsComplete.AddUObject(this, &ThisClass::OnFindSessions);
+		MultiplayerSessionsSubsystem->MultiplayerOnFindSessionsBatch.AddUObject(this, &ThisClass::OnFindSessionsBatch);
+		//캐시 결과, 참가 후 해제 등 검색 완료 없이도 결과가 바뀔수 있음
+		MultiplayerSessionsSubsystem->MultiplayerOnSearchResultsReplaced.AddUObject(this, &ThisClass::OnSearchResultsReplaced);
+	}
+	if (RefreshButton)
+	{
+		RefreshButton->OnClicked.AddDynamic(this, &ThisClass::RefreshButtonClicked);
+	}
+	if (JoinSelectedButton)
+	{
+		JoinSelectedButton->OnClicked.AddDynamic(this, &ThisClass::JoinSelectedButtonClicked);
+	}
+	MatchTypeFilterHash = FMultiplayerSessionIndex::HashMatchType(MatchTypeFilter);
+}
+
+void UServerBrowser::NativeDestruct()
+{
+	if (MultiplayerSessionsSubsystem)
+	{
+		MultiplayerSessionsSubsystem->MultiplayerOnFindSessionsComplete.RemoveAll(this);
+		MultiplayerSessionsSubsystem->MultiplayerOnFindSessionsBatch.RemoveAll(this);
+		MultiplayerSessionsSubsystem->MultiplayerOnSearchResultsReplaced.RemoveAll(this);
+		MultiplayerSessionsSubsystem->CancelSessionOp(JoinSessionHandle);
+	}
+	Super::NativeDestruct();
+}
+
+void UServerBrowser::NativeTick(const FGeometry& MyGeometry, float InDeltaTime)
+{
+	Super::NativeTick(MyGeometry, InDeltaTime);
+
+	if (Rows.Num() < NumResultsToBuild)
+	{
+		BuildPendingRows();
+	}
+}
+
+void UServerBrowser::Refresh()
+{
+	if (MultiplayerSessionsSubsystem == nullptr)
+	{
+		return;
+	}
+	//필터는 클라이언트에서 하니 조건 없이 많이 받아옴
+	FMultiplayerSessionSearchParams SearchParams;
+	SearchParams.MaxSearchResults = MaxSessions;
+	SearchParams.bRequireOpenSlots = false;
+	//이전 결과를 지우고 들어오는 대로 보여줌, 캐시에서 바로 끝나면 완료에서 다시 만들어짐
+	Rows.Reset();
+	StreamedResults.Reset();
+	NumResultsToBuild = 0;
+	bRowsFromStream = true;
+	VisibleItems.Reset();
+	SessionList->ClearListItems();
+	MultiplayerSessionsSubsystem->FindFilteredSessions(SearchParams, true);
+	if (StatusText)
+	{
+		StatusText->SetText(FText::FromString(TEXT("Searching...")));
+	}
+}
+
+void UServerBrowser::SetSortMode(EServerBrowserSortMode InSortMode)
+{
+	SortMode = InSortMode;
+	ApplySortAndFilter();
+}
+
+void UServerBrowser::SetFilter(const FString& InMatchType, bool bInHideFullSessions, int32 InMaxPingMs)
+{
+	MatchTypeFilter = InMatchType;
+	MatchTypeFilterHash = FMultiplayerSessionIndex::HashMatchType(MatchTypeFilter);
+	bHideFullSessions = bInHideFullSessions;
+	MaxPingMs = InMaxPingMs;
+	ApplySortAndFilter();
+}
+
+void UServerBrowser::JoinSelectedSession()
+{
+	const UServerBrowserItem* Item = Cast<UServerBrowserItem>(SessionList->GetSelectedItem());
+	const FOnlineSessionSearchResult* Result = Item ? GetRowResult(Item->RowIndex) : nullptr;
+	if (Result == nullptr || MultiplayerSessionsSubsystem == nullptr || bJoinRequested)
+	{
+		return;
+	}
+	bJoinRequested = true;
+	if (JoinSelectedButton)
+	{
+		JoinSelectedButton->SetIsEnabled(false);
+	}
+	FMultiplayerSessionsStats::Get().BeginTimer(EMultiplayerSessionTimer::TimeToLobby);
+	JoinSessionHandle = MultiplayerSessionsSubsystem->JoinSessionAsync(*Result, [WeakThis = TWeakObjectPtr<UServerBrowser>(this)](EOnJoinSessionCompleteResult::Type JoinResult)
+		{
+			if (UServerBrowser* Browser = WeakThis.Get())
+			{
+				Browser->OnJoinSession(JoinResult);
+			}
+		});
+}
+
+const FOnlineSessionSearchResult* UServerBrowser::GetRowResult(int32 RowIndex) const
+{
+	if (!Rows.IsValidIndex(RowIndex) || MultiplayerSessionsSubsystem == nullptr)
+	{
+		return nullptr;
+	}
+	return GetSourceResult(Rows[RowIndex].ResultIndex);
+}
+
+const FOnlineSessionSearchResult* UServerBrowser::GetSourceResult(int32 ResultIndex) const
+{
+	if (bRowsFromStream)
+	{
+		return StreamedResults.IsValidIndex(ResultIndex) ? &StreamedResults[ResultIndex] : nullptr;
+	}
+	//결과는 서브시스템에만 있음, 결과가 바뀌면 행도 다시 만들어짐
+	return MultiplayerSessionsSubsystem ? MultiplayerSessionsSubsystem->GetRankedSearchResult(ResultIndex) : nullptr;
+}
+
+void UServerBrowser::OnFindSessionsBatch(TArrayView<const FOnlineSessionSearchResult> NewResults)
+{
+	//다른 곳에서 시작한 검색은 완료될때 한번에 반영
+	if (!bRowsFromStream || MultiplayerSessionsSubsystem == nullptr)
+	{
+		return;
+	}
+	//스트리밍 결과는 걸러지지 않은 상태로 옴
+	for (const FOnlineSessionSearchResult& Result : NewResults)
+	{
+		if (StreamedResults.Num() < MaxSessions && MultiplayerSessionsSubsystem->PassesSearchFilter(Result))
+		{
+			StreamedResults.Add(Result);
+		}
+	}
+	NumResultsToBuild = StreamedResults.Num();
+	UpdateStatusText();
+}
+
+void UServerBrowser::OnFindSessions(const TArray<FOnlineSessionSearchResult>& SessionResults, bool bWasSuccessful, EMultiplayerFindSessionsOutcome Outcome)
+{
+	if (Outcome == EMultiplayerFindSessionsOutcome::Cancelled)
+	{
+		return;
+	}
+	//완료로 넘어온 배열이 아니라 행이 가리킬 서브시스템 결과 기준으로 만듬
+	OnSearchResultsReplaced();
+}
+
+void UServerBrowser::OnSearchResultsReplaced()
+{
+	//행은 다음 틱부터 나눠서 만듬
+	bRowsFromStream = false;
+	StreamedResults.Empty();
+	const int32 NumResults = MultiplayerSessionsSubsystem ? MultiplayerSessionsSubsystem->GetNumRankedSearchResults() : 0;
+	Rows.Reset(NumResults);
+	NumResultsToBuild = NumResults;
+	VisibleItems.Reset();
+	SessionList->ClearListItems();
+	UpdateStatusText();
+}
+
+void UServerBrowser::OnJoinSession(EOnJoinSessionCompleteResult::Type Result)
+{
+	bJoinRequested = false;
+	if (Result != EOnJoinSessionCompleteResult::Success || MultiplayerSessionsSubsystem == nullptr)
+	{
+		JoinFailed(TEXT("Could not join the session"));
+		return;
+	}
+
+	FString Address;
+	APlayerController* PlayerController = GetGameInstance()->GetFirstLocalPlayerController();
+	if (!MultiplayerSessionsSubsystem->GetResolvedConnectString(Address) || PlayerController == nullptr)
+	{
+		JoinFailed(TEXT("Could not resolve the session address"));
+		return;
+	}
+	FMultiplayerSessionsStats::Get().BeginTimer(EMultiplayerSessionTimer::Travel);
+	PlayerController->ClientTravel(Address, ETravelType::TRAVEL_Absolute);
+}
+
+void UServerBrowser::JoinFailed(const TCHAR* Status)
+{
+	FMultiplayerSessionsStats::Get().CancelTimer(EMultiplayerSessionTimer::TimeToLobby);
+	if (JoinSelectedButton)
+	{
+		JoinSelectedButton->SetIsEnabled(true);
+	}
+	if (StatusText)
+	{
+		StatusText->SetText(FText::FromString(Status));
+	}
+}
+
+void UServerBrowser::RefreshButtonClicked()
+{
+	Refresh();
+}
+
+void UServerBrowser::JoinSelectedButtonClicked()
+{
+	JoinSelectedSession();
+}
+
+void UServerBrowser::BuildPendingRows()
+{
+	const int32 FirstRow = Rows.Num();
+	const int32 EndRow = FMath::Min(NumResultsToBuild, FirstRow + FMath::Max(RowsPerFrame, 1));
+	for (int32 RowIndex = FirstRow; RowIndex < EndRow; ++RowIndex)
+	{
+		const FOnlineSessionSearchResult* Result = GetSourceResult(RowIndex);
+		if (Result == nullptr)
+		{
+			//결과가 그새 해제됨 (참가 완료 등)
+			NumResultsToBuild = Rows.Num();
+			break;
+		}
+
+		FRow& Row = Rows.AddDefaulted_GetRef();
+		Row.ResultIndex = RowIndex;
+		Row.PingMs = Result->PingInMs;
+		Row.OpenSlots = UMultiplayerSessionsSubsystem::GetOpenSlots(*Result);
+		Row.MaxSlots = Result->Session.SessionSettings.NumPublicConnections;
+		FString MatchType;
+		Result->Session.SessionSettings.Get(SETTING_MATCHTYPE, MatchType);
+		Row.MatchTypeHash = FMultiplayerSessionIndex::HashMatchType(MatchType);
+
+	}
+
+	if (Rows.Num() >= NumResultsToBuild)
+	{
+		//정렬은 전부 만든 뒤 한번만
+		ApplySortAndFilter();
+		return;
+	}
+	//다 만들기 전에는 들어온 순서대로 붙여서 보여줌, 리스트는 프레임마다 한번만 갱신
+	for (int32 RowIndex = FirstRow; RowIndex < Rows.Num(); ++RowIndex)
+	{
+		if (PassesFilter(RowIndex))
+		{
+			VisibleItems.Add(GetPooledItem(RowIndex));
+		}
+	}
+	SessionList->SetListItems(VisibleItems);
+	UpdateStatusText();
+}
+
+bool UServerBrowser::PassesFilter(int32 RowIndex) const
+{
+	const FRow& Row = Rows[RowIndex];
+	if (!MatchTypeFilter.IsEmpty())
+	{
+		if (Row.MatchTypeHash != MatchTypeFilterHash)
+		{
+			return false;
+		}
+		//해시가 같아도 충돌일수 있으니 문자열로 한번 더 확인, 해시가 맞은 행만 결과를 읽음
+		const FOnlineSessionSearchResult* Result = GetRowResult(RowIndex);
+		FString MatchType;
+		if (Result == nullptr || !Result->Session.SessionSettings.Get(SETTING_MATCHTYPE, MatchType) || !MatchType.Equals(MatchTypeFilter, ESearchCase::IgnoreCase))
+		{
+			return false;
+		}
+	}
+	if (bHideFullSessions && Row.OpenSlots <= 0)
+	{
+		return false;
+	}
+	// Backends that can't measure ping report MAX_QUERY_PING, keep those
+	if (MaxPingMs > 0 && Row.PingMs < MAX_QUERY_PING && Row.PingMs > MaxPingMs)
+	{
+		return false;
+	}
+	return true;
+}
+
+void UServerBrowser::ApplySortAndFilter()
+{
+	if (Rows.Num() < NumResultsToBuild)
+	{
+		//아직 만드는 중이면 다 만든 뒤에 적용됨
+		return;
+	}
+
+	TArray<int32> Order;
+	Order.Reserve(Rows.Num());
+	for (int32 RowIndex = 0; RowIndex < Rows.Num(); ++RowIndex)
+	{
+		if (PassesFilter(RowIndex))
+		{
+			Order.Add(RowIndex);
+		}
+	}
+
+	//문자열이 아닌 작은 행만 비교하니 1만개도 금방 끝남
+	switch (SortMode)
+	{
+	case EServerBrowserSortMode::OpenSlots:
+		Order.StableSort([this](int32 A, int32 B) { return Rows[A].OpenSlots > Rows[B].OpenSlots; });
+		break;
+	case EServerBrowserSortMode::Players:
+		Order.StableSort([this](int32 A, int32 B) { return Rows[A].MaxSlots - Rows[A].OpenSlots > Rows[B].MaxSlots - Rows[B].OpenSlots; });
+		break;
+	default:
+		Order.StableSort([this](int32 A, int32 B) { return Rows[A].PingMs < Rows[B].PingMs; });
+		break;
+	}
+
+	VisibleItems.Reset(Order.Num());
+	for (const int32 RowIndex : Order)
+	{
+		VisibleItems.Add(GetPooledItem(RowIndex));
+	}
+	SessionList->SetListItems(VisibleItems);
+	UpdateStatusText();
+}
+
+UServerBrowserItem* UServerBrowser::GetPooledItem(int32 RowIndex)
+{
+	//행 번호마다 하나씩, 새로고침해도 같은 객체를 다시 씀
+	while (ItemPool.Num() <= RowIndex)
+	{
+		UServerBrowserItem* Item = NewObject<UServerBrowserItem>(this);
+		Item->Browser = this;
+		Item->RowIndex = ItemPool.Num();
+		ItemPool.Add(Item);
+	}
+	return ItemPool[RowIndex];
+}
+
+void UServerBrowser::UpdateStatusText()
+{
+	if (StatusText == nullptr)
+	{
+		return;
+	}
+	StatusText->SetText(FText::FromString(FString::Printf(TEXT("%d / %d sessions"), VisibleItems.Num(), NumResultsToBuild)));
+}
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "Blueprint/UserWidget.h"
 #include "Interfaces/OnlineSessionInterface.h"
+#include "MultiplayerSessionsSubsystem.h"
 #include "Menu.generated.h"
 
 /**
@@ -16,28 +17,23 @@ class MUTIPLAYERSESSIONS_API UMenu : public UUserWidget
 	GENERATED_BODY()
 public:
 	UFUNCTION(BlueprintCallable)
-	void MenuSetup(int32 NumberOfPublicConnections = 4,FString TypeOfMatch = FString(TEXT("FreeForAll")), FString LobbyPath = FString(TEXT("/Game/ThirdPerson/Maps/Lobby")));
+	void MenuSetup(int32 NumberOfPublicConnections = 4,FString TypeOfMatch = FString(TEXT("FreeForAll")), FString LobbyPath = FString(TEXT("/Game/ThirdPerson/Maps/Lobby")), bool bProbeLatency = false, bool bJoinDedicatedServers = false, bool bIncludeLanSessions = false);
 
 protected:
 	virtual bool Initialize() override;
 
-	//   ȣǴ Լ
+	//이 레벨이 없어질때 호출되는 함수
 	virtual void NativeDestruct() override;
 
-	// MultiplayerSessionSubsystem.h   DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FMultiplayerOnCreateSessionComplete, bool, bWasSuccessful)  ݹԼ
-	// Callbacks for the custom delegates on the MultiplayerSessionsSubsystem
-	// Ʈ ҋ DYNAMICΰ ο ν UFUNCTION ũθ 
+	// Callbacks for the MultiplayerSessionsSubsystem
+	// 생성/검색/참가는 메뉴가 보낸 호출의 결과만 받음 (CreateSessionAsync 등), 스트리밍 배치만 델리게이트로 받음
 	//
-	UFUNCTION()
 	void OnCreateSession(bool bWasSuccessful);
-	void OnFindSession(const TArray<FOnlineSessionSearchResult>& SessionResults, bool bWasSuccessful);
+	void OnFindSession(const TArray<FOnlineSessionSearchResult>& SessionResults, bool bWasSuccessful, EMultiplayerFindSessionsOutcome Outcome);
+	void OnFindSessionsBatch(TArrayView<const FOnlineSessionSearchResult> NewResults);
 	void OnJoinSession(EOnJoinSessionCompleteResult::Type Result);
-	UFUNCTION()
-	void OnDestroySession(bool bWasSuccessful);
-	UFUNCTION()
-	void OnStartSession(bool bWasSuccessful);
 private:
-	//UPROPERTY(meta = (BindWidget))  WBP_Menu ư̸ ϰ ƾ
+	//UPROPERTY(meta = (BindWidget))를 쓰려면 WBP_Menu에 버튼이름과 변수명하고 같아야함
 	UPROPERTY(meta = (BindWidget))
 	class UButton* HostButton;
 	UPROPERTY(meta = (BindWidget))
@@ -49,13 +45,33 @@ private:
 	UFUNCTION()
 	void JoinButtonClicked();
 
-	//ǲ ý ʱȭ
+	//인풋 시스템 초기화
 	void MenuTearDown();
 
-	//޴ ý 
-	class UMultiplayerSessionsSubsystem* MultiplayerSessionsSubsystem;
+	//검색 조건에 맞는 첫 세션에 바로 참가하고 남은 검색은 취소
+	bool JoinFirstMatchingSession(TArrayView<const FOnlineSessionSearchResult> SessionResults);
+	void StartSessionSearch();
+
+	//메뉴에서 서브시스템 접근
+	UMultiplayerSessionsSubsystem* MultiplayerSessionsSubsystem;
+	//메뉴가 없어지면 취소해서 끝난 뒤에 불리지 않게 함
+	FMultiplayerSessionOpHandle CreateSessionHandle;
+	FMultiplayerSessionOpHandle FindSessionsHandle;
+	FMultiplayerSessionOpHandle JoinSessionHandle;
 
 	int32 NumPublicConnections{ 4 };
 	FString MatchType{ TEXT("FreeForAll") };
 	FString PathToLobby{ TEXT("") };
+	FString LobbyMapPath{ TEXT("") };
+
+	bool bJoinRequested{ false };
+	//참가 직전에 꽉 찼거나 사라진 세션이면 다시 검색해서 다음 세션으로
+	int32 NumJoinRetries{ 0 };
+	static constexpr int32 MaxJoinRetries{ 3 };
+	//true 면 첫 결과에 바로 들어가지 않고 QoS 로 잰 핑이 가장 낮은 세션에 참가
+	bool bProbeSessionLatency{ false };
+	//true 면 리슨서버 로비 대신 데디케이티드 서버 목록에서 찾음
+	bool bSearchDedicatedServers{ false };
+	//true 면 온라인과 같이 LAN 도 검색, 같은 LAN 에 호스트가 있으면 그쪽으로 먼저 참가
+	bool bSearchLanSessions{ false };
 };
@@ -0,0 +1,110 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Interfaces/OnlineSessionInterface.h"
+#include "OnlineSessionSettings.h"
+#include "Containers/Ticker.h"
+
+struct MUTIPLAYERSESSIONS_API FMultiplayerFakeSessionConfig
+{
+	/** Sessions the fake backend advertises to FindSessions */
+	int32 NumAdvertisedSessions{ 2000 };
+	/** Delay before a completion delegate fires, unless the caller flushes */
+	float LatencySeconds{ 0.05f };
+	/** Chance (0..1) that any backend call completes with a failure */
+	float FailureRate{ 0.f };
+	/** Chance (0..1) that an advertised session starts with no open slots */
+	float FullSessionRate{ 0.1f };
+	int32 MaxPublicConnections{ 4 };
+	TArray<FString> MatchTypes{ TEXT("FreeForAll"), TEXT("TeamDeathMatch") };
+	int32 Seed{ 1337 };
+};
+
+/**
+ * In-process IOnlineSession used to drive UMultiplayerSessionsSubsystem without Steam or a network.
+ * Completions are queued and fired from the core ticker after LatencySeconds, or right away by Flush().
+ * Only the calls the subsystem uses are simulated, everything else fails or returns empty.
+ */
+class MUTIPLAYERSESSIONS_API FMultiplayerFakeOnlineSession : public IOnlineSession
+{
+public:
+	explicit FMultiplayerFakeOnlineSession(const FMultiplayerFakeSessionConfig& InConfig = FMultiplayerFakeSessionConfig());
+	virtual ~FMultiplayerFakeOnlineSession();
+
+	/** Fires every queued completion now, regardless of simulated latency */
+	void Flush();
+	int32 GetNumPendingCompletions() const { return PendingCompletions.Num(); }
+	const FMultiplayerFakeSessionConfig& GetConfig() const { return Config; }
+
+	// IOnlineSession
+	virtual FUniqueNetIdPtr CreateSessionIdFromString(const FString& SessionIdStr) override;
+	virtual FNamedOnlineSession* GetNamedSession(FName SessionName) override;
+	virtual void RemoveNamedSession(FName SessionName) override;
+	virtual bool HasPresenceSession() override;
+	virtual EOnlineSessionState::Type GetSessionState(FName SessionName) const override;
+	virtual bool CreateSession(int32 HostingPlayerNum, FName SessionName, const FOnlineSessionSettings& NewSessionSettings) override;
+	virtual bool CreateSession(const FUniqueNetId& HostingPlayerId, FName SessionName, const FOnlineSessionSettings& NewSessionSettings) override;
+	virtual bool StartSession(FName SessionName) override;
+	virtual bool UpdateSession(FName SessionName, FOnlineSessionSettings& UpdatedSessionSettings, bool bShouldRefreshOnlineData = true) override;
+	virtual bool EndSession(FName SessionName) override;
+	virtual bool DestroySession(FName SessionName, const FOnDestroySessionCompleteDelegate& CompletionDelegate = FOnDestroySessionCompleteDelegate()) override;
+	virtual bool IsPlayerInSession(FName SessionName, const FUniqueNetId& UniqueId) override;
+	virtual bool StartMatchmaking(const TArray<FUniqueNetIdRef>& LocalPlayers, FName SessionName, const FOnlineSessionSettings& NewSessionSettings, TSharedRef<FOnlineSessionSearch>& SearchSettings) override;
+	virtual bool CancelMatchmaking(int32 SearchingPlayerNum, FName SessionName) override;
+	virtual bool CancelMatchmaking(const FUniqueNetId& SearchingPlayerId, FName SessionName) override;
+	virtual bool FindSessions(int32 SearchingPlayerNum, const TSharedRef<FOnlineSessionSearch>& SearchSettings) override;
+	virtual bool FindSessions(const FUniqueNetId& SearchingPlayerId, const TSharedRef<FOnlineSessionSearch>& SearchSettings) override;
+	virtual bool FindSessionById(const FUniqueNetId& SearchingUserId, const FUniqueNetId& SessionId, const FUniqueNetId& FriendId, const FOnSingleSessionResultCompleteDelegate& CompletionDelegate) override;
+	virtual bool CancelFindSessions() override;
+	virtual bool PingSearchResults(const FOnlineSessionSearchResult& SearchResult) override;
+	virtual bool JoinSession(int32 LocalUserNum, FName SessionName, const FOnlineSessionSearchResult& DesiredSession) override;
+	virtual bool JoinSession(const FUniqueNetId& LocalUserId, FName SessionName, const FOnlineSessionSearchResult& DesiredSession) override;
+	virtual bool FindFriendSession(int32 LocalUserNum, const FUniqueNetId& Friend) override;
+	virtual bool FindFriendSession(const FUniqueNetId& LocalUserId, const FUniqueNetId& Friend) override;
+	virtual bool FindFriendSession(const FUniqueNetId& LocalUserId, const TArray<FUniqueNetIdRef>& FriendList) override;
+	virtual bool SendSessionInviteToFriend(int32 LocalUserNum, FName SessionName, const FUniqueNetId& Friend) override;
+	virtual bool SendSessionInviteToFriend(const FUniqueNetId& LocalUserId, FName SessionName, const FUniqueNetId& Friend) override;
+	virtual bool SendSessionInviteToFriends(int32 LocalUserNum, FName SessionName, const TArray<FUniqueNetIdRef>& Friends) override;
+	virtual bool SendSessionInviteToFriends(const FUniqueNetId& LocalUserId, FName SessionName, const TArray<FUniqueNetIdRef>& Friends) override;
+	virtual bool GetResolvedConnectString(FName SessionName, FString& ConnectInfo, FName PortType = NAME_GamePort) override;
+	virtual bool GetResolvedConnectString(const FOnlineSessionSearchResult& SearchResult, FName PortType, FString& ConnectInfo) override;
+	virtual FOnlineSessionSettings* GetSessionSettings(FName SessionName) override;
+	virtual bool RegisterPlayer(FName SessionName, const FUniqueNetId& PlayerId, bool bWasInvited) override;
+	virtual bool RegisterPlayers(FName SessionName, const TArray<FUniqueNetIdRef>& Players, bool bWasInvited = false) override;
+	virtual bool UnregisterPlayer(FName SessionName, const FUniqueNetId& PlayerId) override;
+	virtual bool UnregisterPlayers(FName SessionName, const TArray<FUniqueNetIdRef>& Players) override;
+	virtual void RegisterLocalPlayer(const FUniqueNetId& PlayerId, FName SessionName, const FOnRegisterLocalPlayerCompleteDelegate& Delegate) override;
+	virtual void UnregisterLocalPlayer(const FUniqueNetId& PlayerId, FName SessionName, const FOnUnregisterLocalPlayerCompleteDelegate& Delegate) override;
+	virtual void RemovePlayerFromSession(int32 LocalUserNum, FName SessionName, const FUniqueNetId& TargetPlayerId) override;
+	virtual int32 GetNumSessions() override;
+	virtual void DumpSessionState() override;
+
+protected:
+	virtual FNamedOnlineSession* AddNamedSession(FName SessionName, const FOnlineSessionSettings& SessionSettings) override;
+	virtual FNamedOnlineSession* AddNamedSession(FName SessionName, const FOnlineSession& Session) override;
+
+private:
+	void PopulateAdvertisedSessions();
+	FOnlineSessionSearchResult* FindAdvertisedSession(const FString& SessionId);
+	bool RollFailure();
+	void QueueCompletion(TFunction<void()>&& Completion);
+	bool Tick(float DeltaTime);
+
+	FMultiplayerFakeSessionConfig Config;
+	FRandomStream Random;
+	FUniqueNetIdRef FakeLocalUserId;
+
+	TArray<FOnlineSessionSearchResult> AdvertisedSessions;
+	TArray<TUniquePtr<FNamedOnlineSession>> NamedSessions;
+	TSharedPtr<FOnlineSessionSearch> ActiveSearch;
+
+	struct FPendingCompletion
+	{
+		double DueSeconds;
+		TFunction<void()> Completion;
+	};
+	TArray<FPendingCompletion> PendingCompletions;
+	FTSTicker::FDelegateHandle TickerHandle;
+};
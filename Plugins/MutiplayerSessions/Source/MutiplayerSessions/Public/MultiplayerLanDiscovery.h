@@ -0,0 +1,106 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "HAL/ThreadSafeBool.h"
+#include "OnlineSessionSettings.h"
+
+class FSocket;
+class FRunnableThread;
+
+/** What a LAN host tells discovery probes about its session, mirrors the hosted session settings */
+struct MUTIPLAYERSESSIONS_API FMultiplayerLanAdvertisement
+{
+	FString MatchType;
+	FString HostKey;
+	FString OwningUserName;
+	FString MapPath;
+	int32 BuildUniqueId{ 0 };
+	int32 NumPublicConnections{ 0 };
+	int32 OpenSlots{ 0 };
+	int32 GamePort{ 0 };
+	int32 QosPort{ 0 };
+	int32 BeaconPort{ 0 };
+};
+
+struct MUTIPLAYERSESSIONS_API FMultiplayerLanHost
+{
+	// ip:gameport, taken from the reply's source address
+	FString Address;
+	FMultiplayerLanAdvertisement Advertisement;
+	float PingMs{ 0.f };
+};
+
+struct MUTIPLAYERSESSIONS_API FMultiplayerLanDiscoveryParams
+{
+	// Hosts bind the first free port in [BasePort, BasePort + PortRange) so several can run on one machine
+	int32 BasePort{ 7797 };
+	int32 PortRange{ 8 };
+	// Probes are re-sent at this cadence until the timeout, lost broadcasts are common on busy Wi-Fi
+	float ProbeIntervalSeconds{ 0.05f };
+	float TimeoutSeconds{ 1.f };
+	// Once the first valid host has answered, wait this much longer for others and return
+	float FirstResponseGraceSeconds{ 0.005f };
+	int32 MaxResults{ 16 };
+	// Hosts built with a different BuildUniqueId are ignored, 0 accepts any
+	int32 BuildUniqueId{ 0 };
+	// Empty matches every MatchType
+	FString MatchType;
+	bool bProbeLoopback{ true };
+};
+
+/**
+ * Host side of LAN discovery. Answers discovery probes on a UDP port from its own thread
+ * with a reply serialized up front, so answering costs one SendTo regardless of the game frame.
+ */
+class MUTIPLAYERSESSIONS_API FMultiplayerLanDiscoveryResponder : public FRunnable
+{
+public:
+	~FMultiplayerLanDiscoveryResponder();
+
+	/** Binds the first free port in [BasePort, BasePort + PortRange) */
+	bool Start(int32 BasePort, int32 PortRange);
+	void Shutdown();
+	bool IsRunning() const { return Thread != nullptr; }
+	int32 GetBoundPort() const { return BoundPort; }
+
+	/** Thread safe, called from the game thread whenever the session settings or player count change */
+	void SetAdvertisement(const FMultiplayerLanAdvertisement& Advertisement);
+
+	//~ Begin FRunnable Interface
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+	//~ End FRunnable Interface
+
+private:
+	FSocket* Socket{ nullptr };
+	FRunnableThread* Thread{ nullptr };
+	FThreadSafeBool bStopping{ false };
+	int32 BoundPort{ 0 };
+
+	FCriticalSection AdvertisementLock;
+	TArray<uint8> AdvertisementPayload;
+	FString MatchType;
+	int32 BuildUniqueId{ 0 };
+};
+
+/**
+ * Client side of LAN discovery. Broadcasts (and optionally sends to loopback) a probe to every port
+ * in the range at ProbeIntervalSeconds and returns as soon as the first hosts have answered.
+ */
+class MUTIPLAYERSESSIONS_API FMultiplayerLanDiscovery
+{
+public:
+	/** Runs on the thread pool; OnComplete is called on the game thread. Setting *CancelFlag makes it return early */
+	static void DiscoverAsync(const FMultiplayerLanDiscoveryParams& Params, TSharedPtr<FThreadSafeBool, ESPMode::ThreadSafe> CancelFlag, TFunction<void(TArray<FMultiplayerLanHost>&&)> OnComplete);
+
+	// Blocking version, used by DiscoverAsync and the loopback benchmark
+	static TArray<FMultiplayerLanHost> Discover(const FMultiplayerLanDiscoveryParams& Params, const FThreadSafeBool* CancelFlag = nullptr);
+
+	/** Builds a search result the session subsystem can rank, filter and join directly */
+	static FOnlineSessionSearchResult MakeSearchResult(const FMultiplayerLanHost& Host);
+	/** ip:port of a result made by MakeSearchResult */
+	static FString GetHostAddress(const FOnlineSessionSearchResult& SearchResult);
+};
@@ -0,0 +1,93 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OnlineBeaconClient.h"
+#include "OnlineBeaconHostObject.h"
+#include "MultiplayerReservationBeacon.generated.h"
+
+class UMultiplayerSessionsSubsystem;
+
+UENUM(BlueprintType)
+enum class EMultiplayerReservationResult : uint8
+{
+	Accepted,
+	SessionFull,
+	Failed
+};
+
+DECLARE_DELEGATE_OneParam(FMultiplayerOnReservationComplete, EMultiplayerReservationResult Result);
+
+/**
+ * Client half of the slot reservation handshake.
+ * Connects to the host's beacon port, asks for a slot for the local player and reports the answer,
+ * so a full server is found out about before the map load instead of after it.
+ */
+UCLASS(Transient, NotPlaceable)
+class MUTIPLAYERSESSIONS_API AMultiplayerReservationBeaconClient : public AOnlineBeaconClient
+{
+	GENERATED_BODY()
+
+public:
+	/** Connects to ConnectInfo (host:beaconport) and requests a slot; false if the connection could not be started */
+	bool RequestReservation(const FString& ConnectInfo, const FUniqueNetIdRepl& PlayerId, float ResponseTimeoutSeconds);
+
+	FMultiplayerOnReservationComplete OnReservationComplete;
+
+	//~ Begin AOnlineBeaconClient Interface
+	virtual void OnConnected() override;
+	virtual void OnFailure() override;
+	//~ End AOnlineBeaconClient Interface
+
+	UFUNCTION(Server, Reliable)
+	void ServerRequestReservation(const FUniqueNetIdRepl& PlayerId);
+
+	UFUNCTION(Client, Reliable)
+	void ClientReservationResponse(EMultiplayerReservationResult Result);
+
+private:
+	void OnResponseTimeout();
+	void CompleteReservation(EMultiplayerReservationResult Result);
+
+	FUniqueNetIdRepl PendingPlayerId;
+	FTimerHandle ResponseTimeoutHandle;
+	/** Host side: a beacon connection gets one reservation request, later ones are refused */
+	bool bReservationRequested{ false };
+};
+
+/**
+ * Host half of the slot reservation handshake, registered on the session host's AOnlineBeaconHost.
+ * A granted reservation counts against the advertised open slots until the player logs in
+ * or ReservationTimeoutSeconds passes without them arriving.
+ */
+UCLASS(Transient, NotPlaceable)
+class MUTIPLAYERSESSIONS_API AMultiplayerReservationBeaconHostObject : public AOnlineBeaconHostObject
+{
+	GENERATED_BODY()
+
+public:
+	AMultiplayerReservationBeaconHostObject(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+
+	void Init(UMultiplayerSessionsSubsystem* InSessionsSubsystem, float InReservationTimeoutSeconds);
+
+	void ProcessReservationRequest(AMultiplayerReservationBeaconClient* Client, const FUniqueNetIdRepl& PlayerId);
+	bool HasReservation(const FUniqueNetIdRepl& PlayerId) const;
+	/** Called once the reserved player has logged in; the slot is now counted as a connected player */
+	void ConsumeReservation(const FUniqueNetIdRepl& PlayerId);
+	int32 GetNumReservations() const { return Reservations.Num(); }
+
+	virtual void Tick(float DeltaSeconds) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	struct FReservation
+	{
+		FUniqueNetIdRepl PlayerId;
+		double ExpireSeconds{ 0.0 };
+	};
+	TArray<FReservation> Reservations;
+
+	TWeakObjectPtr<UMultiplayerSessionsSubsystem> SessionsSubsystem;
+	float ReservationTimeoutSeconds{ 30.f };
+};
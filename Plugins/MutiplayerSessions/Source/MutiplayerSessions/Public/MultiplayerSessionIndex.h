@@ -0,0 +1,56 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FOnlineSessionSearchResult;
+
+/**
+ * Compact view over a session search, built once when the search completes.
+ * Every column lives in its own array so a filter only walks the few bytes it reads,
+ * and rows are stored best first (lowest ping, then most open slots) so the top K
+ * matches are simply the first K rows that pass the filter.
+ */
+struct MUTIPLAYERSESSIONS_API FMultiplayerSessionIndex
+{
+	struct FFilter
+	{
+		bool bAnyMatchType{ true };
+		// Rows whose hash matches are confirmed against MatchType, ignoring case
+		uint32 MatchTypeHash{ 0 };
+		FString MatchType;
+		int32 MinOpenSlots{ 0 };
+		// 0 means no ping limit
+		int32 MaxPingMs{ 0 };
+		// 0 accepts every build
+		int32 BuildId{ 0 };
+	};
+
+	void Build(const TArray<FOnlineSessionSearchResult>& SearchResults);
+	void Reset();
+	// Reset keeps the column allocations for the next Build, Empty gives them back
+	void Empty();
+	SIZE_T GetAllocatedSize() const;
+
+	int32 Num() const { return ResultIndices.Num(); }
+
+	// Appends at most K indices into the results the index was built from, best first. Returns how many were added.
+	int32 SelectTopK(const FFilter& Filter, int32 K, TArray<int32>& OutResultIndices) const;
+
+	static uint32 HashMatchType(const FString& MatchType);
+
+	// Free slots as advertised by the host (OPENSLOTS, includes reservations), capped by what the backend reports
+	static int32 GetOpenSlots(const FOnlineSessionSearchResult& SearchResult);
+
+private:
+	bool PassesFilter(int32 Row, const FFilter& Filter) const;
+
+	TArray<uint32> MatchTypeHashes;
+	// Only read when the hash matches
+	TArray<FString> MatchTypes;
+	TArray<int32> PingsMs;
+	TArray<int32> OpenSlots;
+	TArray<int32> BuildIds;
+	TArray<int32> ResultIndices;
+};
@@ -0,0 +1,20 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+//
+// Session setting keys used by this plugin, declared like the engine's Online/OnlineSessionNames.h
+//
+
+// 같은 MatchType 끼리만 참가, 검색 쿼리와 결과 필터에 같이 씀
+#define SETTING_MATCHTYPE FName(TEXT("MatchType"))
+// 호스트가 광고하는 빈자리 (접속 + 예약 제외), 인원이 바뀌면 갱신
+#define SETTING_OPENSLOTS FName(TEXT("OPENSLOTS"))
+// 온라인과 LAN 에 같이 광고된 같은 호스트를 한번만 보여주기 위한 키
+#define SETTING_HOSTKEY FName(TEXT("HOSTKEY"))
+// LAN 탐색으로 찾은 결과에 로컬로만 붙이는 표시, 광고되지 않음
+#define SETTING_LANRESULT FName(TEXT("LANRESULT"))
+// 호스트 QoS 응답기가 받는 포트, 바인드에 성공했을 때만 광고
+#define SETTING_QOSPORT FName(TEXT("QOSPORT"))
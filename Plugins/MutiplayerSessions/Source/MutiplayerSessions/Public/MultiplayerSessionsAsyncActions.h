@@ -0,0 +1,114 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "FindSessionsCallbackProxy.h"
+#include "MultiplayerSessionsSubsystem.h"
+#include "MultiplayerSessionsAsyncActions.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FMultiplayerSessionAsyncActionPin);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FMultiplayerFindSessionsAsyncActionPin, const TArray<FBlueprintSessionResult>&, Results, EMultiplayerFindSessionsOutcome, Outcome);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FMultiplayerJoinSessionAsyncActionPin, const FString&, ConnectString);
+
+/**
+ * Base for the Blueprint session nodes. Each node makes one *Async call on UMultiplayerSessionsSubsystem,
+ * so its output pins only fire for that call, and the node is released once they have.
+ */
+UCLASS(Abstract)
+class MUTIPLAYERSESSIONS_API UMultiplayerSessionAsyncActionBase : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+
+public:
+	/** Output pins will not fire. A call still waiting in the session queue is removed from it */
+	UFUNCTION(BlueprintCallable, Category = "Multiplayer Sessions")
+	void Cancel();
+
+protected:
+	static UMultiplayerSessionsSubsystem* GetSessionsSubsystem(const UObject* WorldContextObject);
+
+	TWeakObjectPtr<UMultiplayerSessionsSubsystem> SessionsSubsystem;
+	FMultiplayerSessionOpHandle Handle;
+};
+
+/** Create / Destroy / Start, the session ops that only report success */
+UCLASS()
+class MUTIPLAYERSESSIONS_API UMultiplayerSessionOpAsyncAction : public UMultiplayerSessionAsyncActionBase
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION(BlueprintCallable, meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"), Category = "Multiplayer Sessions")
+	static UMultiplayerSessionOpAsyncAction* CreateMultiplayerSession(UObject* WorldContextObject, int32 NumPublicConnections = 4, FString MatchType = TEXT("FreeForAll"));
+
+	UFUNCTION(BlueprintCallable, meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"), Category = "Multiplayer Sessions")
+	static UMultiplayerSessionOpAsyncAction* DestroyMultiplayerSession(UObject* WorldContextObject);
+
+	UFUNCTION(BlueprintCallable, meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"), Category = "Multiplayer Sessions")
+	static UMultiplayerSessionOpAsyncAction* StartMultiplayerSession(UObject* WorldContextObject);
+
+	virtual void Activate() override;
+
+	UPROPERTY(BlueprintAssignable)
+	FMultiplayerSessionAsyncActionPin OnSuccess;
+	UPROPERTY(BlueprintAssignable)
+	FMultiplayerSessionAsyncActionPin OnFailure;
+
+private:
+	static UMultiplayerSessionOpAsyncAction* MakeAction(UObject* WorldContextObject, EMultiplayerSessionOp InOp);
+	void OnComplete(bool bWasSuccessful);
+
+	EMultiplayerSessionOp Op{ EMultiplayerSessionOp::None };
+	int32 NumPublicConnections{ 4 };
+	FString MatchType;
+};
+
+UCLASS()
+class MUTIPLAYERSESSIONS_API UFindMultiplayerSessionsAsyncAction : public UMultiplayerSessionAsyncActionBase
+{
+	GENERATED_BODY()
+
+public:
+	// TimeoutSeconds < 0 uses the subsystem's SearchTimeoutSeconds, 0 waits for the backend
+	UFUNCTION(BlueprintCallable, meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"), Category = "Multiplayer Sessions")
+	static UFindMultiplayerSessionsAsyncAction* FindMultiplayerSessions(UObject* WorldContextObject, const FMultiplayerSessionSearchParams& SearchParams, float TimeoutSeconds = -1.f);
+
+	virtual void Activate() override;
+
+	// Also fires for TimedOut searches that returned results
+	UPROPERTY(BlueprintAssignable)
+	FMultiplayerFindSessionsAsyncActionPin OnSuccess;
+	UPROPERTY(BlueprintAssignable)
+	FMultiplayerFindSessionsAsyncActionPin OnFailure;
+
+private:
+	void OnComplete(const TArray<FOnlineSessionSearchResult>& SessionResults, bool bWasSuccessful, EMultiplayerFindSessionsOutcome Outcome);
+
+	FMultiplayerSessionSearchParams SearchParams;
+	float TimeoutSeconds{ -1.f };
+};
+
+UCLASS()
+class MUTIPLAYERSESSIONS_API UJoinMultiplayerSessionAsyncAction : public UMultiplayerSessionAsyncActionBase
+{
+	GENERATED_BODY()
+
+public:
+	// OnSuccess gives the address to ClientTravel to
+	UFUNCTION(BlueprintCallable, meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"), Category = "Multiplayer Sessions")
+	static UJoinMultiplayerSessionAsyncAction* JoinMultiplayerSession(UObject* WorldContextObject, const FBlueprintSessionResult& SearchResult);
+
+	virtual void Activate() override;
+
+	UPROPERTY(BlueprintAssignable)
+	FMultiplayerJoinSessionAsyncActionPin OnSuccess;
+	UPROPERTY(BlueprintAssignable)
+	FMultiplayerJoinSessionAsyncActionPin OnFailure;
+
+private:
+	void OnComplete(EOnJoinSessionCompleteResult::Type Result);
+
+	FBlueprintSessionResult SearchResult;
+};
@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "HAL/ThreadSafeBool.h"
+
+class FSocket;
+class FRunnableThread;
+
+struct MUTIPLAYERSESSIONS_API FMultiplayerQosResult
+{
+	FString Address;
+	float RttMs{ 0.f };
+	float JitterMs{ 0.f };
+	int32 NumSent{ 0 };
+	int32 NumReceived{ 0 };
+
+	bool WasReachable() const { return NumReceived > 0; }
+
+	// 지터가 큰 호스트는 평균 RTT 가 같아도 체감이 나쁘니 가중치를 줌
+	float GetScore() const { return WasReachable() ? RttMs + 2.f * JitterMs : TNumericLimits<float>::Max(); }
+};
+
+/**
+ * Host side of the QoS probe. Echoes probe packets back on a small UDP port
+ * from its own thread so the reply time doesn't depend on the game frame rate.
+ */
+class MUTIPLAYERSESSIONS_API FMultiplayerQosResponder : public FRunnable
+{
+public:
+	~FMultiplayerQosResponder();
+
+	// Port 0 lets the OS pick a free port, a taken port falls back to that too
+	bool Start(int32 Port);
+	void Shutdown();
+	bool IsRunning() const { return Thread != nullptr; }
+	// The port the responder actually bound, 0 while it isn't running
+	int32 GetPort() const { return IsRunning() ? BoundPort : 0; }
+
+	//~ Begin FRunnable Interface
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+	//~ End FRunnable Interface
+
+private:
+	FSocket* Socket{ nullptr };
+	FRunnableThread* Thread{ nullptr };
+	FThreadSafeBool bStopping{ false };
+	int32 BoundPort{ 0 };
+};
+
+/**
+ * Client side of the QoS probe. Sends ProbesPerHost tiny UDP packets to every host at once
+ * and measures round trip time and jitter. Runs on the thread pool, OnComplete is called
+ * on the game thread with one result per address, in the order they were passed in.
+ */
+class MUTIPLAYERSESSIONS_API FMultiplayerQosProbe
+{
+public:
+	static void ProbeAsync(TArray<FString> HostAddresses, int32 ProbesPerHost, float TimeoutSeconds, TFunction<void(TArray<FMultiplayerQosResult>&&)> OnComplete);
+
+	// Blocking version, used by ProbeAsync and the loopback benchmark
+	static TArray<FMultiplayerQosResult> Probe(const TArray<FString>& HostAddresses, int32 ProbesPerHost, float TimeoutSeconds);
+};
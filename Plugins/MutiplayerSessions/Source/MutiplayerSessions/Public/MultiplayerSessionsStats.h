@@ -0,0 +1,143 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "Containers/Ticker.h"
+
+DECLARE_STATS_GROUP(TEXT("MultiplayerSessions"), STATGROUP_MultiplayerSessions, STATCAT_Advanced);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Search Results Memory"), STAT_MultiplayerSearchResultsMemory, STATGROUP_MultiplayerSessions, MUTIPLAYERSESSIONS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Stored Search Results"), STAT_MultiplayerStoredSearchResults, STATGROUP_MultiplayerSessions, MUTIPLAYERSESSIONS_API);
+
+/**
+ * Phases timed by FMultiplayerSessionsStats.
+ * Session ops are measured from the backend call to its completion callback,
+ * MapPrewarm from the async load request to the travel map being resident,
+ * Travel from ServerTravel/ClientTravel to the next PostLoadMap,
+ * TimeToLobby from the Host/Join click to the lobby map being loaded,
+ * OnlineInit the deferred IOnlineSubsystem bring-up on its own.
+ */
+enum class EMultiplayerSessionTimer : uint8
+{
+	CreateSession,
+	FindSessions,
+	JoinSession,
+	DestroySession,
+	StartSession,
+	UpdateSession,
+	ResolveConnectString,
+	MapPrewarm,
+	Travel,
+	TimeToLobby,
+	OnlineInit,
+
+	MAX
+};
+
+/** Boot milestones, each recorded once as seconds since process start */
+enum class EMultiplayerStartupPhase : uint8
+{
+	ModuleStartup,
+	SubsystemInitialize,
+	StartupMapLoaded,
+	FirstFrame,
+	OnlineReady,
+
+	MAX
+};
+
+/** Log-bucketed latency histogram, cheap enough to keep for the whole process lifetime */
+class MUTIPLAYERSESSIONS_API FMultiplayerLatencyHistogram
+{
+public:
+	void AddSample(double Milliseconds);
+	void Reset();
+
+	/** Upper bound of the bucket containing the given percentile (0..1) */
+	double GetPercentile(double Percentile) const;
+
+	int32 Num() const { return NumSamples; }
+	double GetMin() const { return NumSamples > 0 ? MinMs : 0.0; }
+	double GetMax() const { return NumSamples > 0 ? MaxMs : 0.0; }
+	double GetMean() const { return NumSamples > 0 ? SumMs / NumSamples : 0.0; }
+
+private:
+	// 0.5ms 부터 25% 씩 늘어나는 버킷, 마지막 버킷은 약 10분
+	static constexpr int32 NumBuckets{ 64 };
+	static constexpr double FirstBucketMs{ 0.5 };
+	static constexpr double BucketGrowth{ 1.25 };
+
+	static int32 GetBucketIndex(double Milliseconds);
+	static double GetBucketUpperBound(int32 BucketIndex);
+
+	uint32 Buckets[NumBuckets]{};
+	int32 NumSamples{ 0 };
+	double MinMs{ 0.0 };
+	double MaxMs{ 0.0 };
+	double SumMs{ 0.0 };
+};
+
+/**
+ * Process-wide latency bookkeeping for session operations.
+ * Every sample goes to the histogram, the CSV profiler and an Insights region so the same numbers
+ * show up in field CSVs, traces and the MultiplayerSessions.LatencyStats console command.
+ */
+class MUTIPLAYERSESSIONS_API FMultiplayerSessionsStats
+{
+public:
+	static FMultiplayerSessionsStats& Get();
+
+	void Startup();
+	void Shutdown();
+
+	void BeginTimer(EMultiplayerSessionTimer Timer);
+	/** Records the elapsed time if the timer is running; failures are counted but kept out of the histogram */
+	void EndTimer(EMultiplayerSessionTimer Timer, bool bWasSuccessful = true);
+	void CancelTimer(EMultiplayerSessionTimer Timer);
+	bool IsTimerRunning(EMultiplayerSessionTimer Timer) const;
+
+	/** Records an already measured, synchronous phase */
+	void AddSample(EMultiplayerSessionTimer Timer, double Milliseconds);
+
+	/** Only the first call per phase is recorded, so the same mark can sit on a path that runs more than once */
+	void MarkStartupPhase(EMultiplayerStartupPhase Phase);
+	/** Seconds since process start, negative if the phase has not been reached */
+	double GetStartupPhaseSeconds(EMultiplayerStartupPhase Phase) const;
+
+	/** Resident search result storage (live search, ranked results, cache), reported to stat MultiplayerSessions and CSV */
+	void SetSearchMemory(int32 NumStoredResults, SIZE_T AllocatedBytes);
+
+	const FMultiplayerLatencyHistogram& GetHistogram(EMultiplayerSessionTimer Timer) const;
+	void DumpToLog() const;
+	void Reset();
+
+	static const TCHAR* GetTimerName(EMultiplayerSessionTimer Timer);
+	static const TCHAR* GetStartupPhaseName(EMultiplayerStartupPhase Phase);
+
+private:
+	FMultiplayerSessionsStats();
+
+	void OnPostLoadMap(UWorld* LoadedWorld);
+	bool OnFirstFrame(float DeltaTime);
+
+	struct FTimerSlot
+	{
+		FMultiplayerLatencyHistogram Histogram;
+		double StartSeconds{ 0.0 };
+		int32 NumFailures{ 0 };
+		bool bRunning{ false };
+	};
+	FTimerSlot Slots[static_cast<int32>(EMultiplayerSessionTimer::MAX)];
+
+	int32 NumStoredSearchResults{ 0 };
+	SIZE_T SearchMemoryBytes{ 0 };
+	SIZE_T PeakSearchMemoryBytes{ 0 };
+
+	static constexpr int32 NumStartupPhases = static_cast<int32>(EMultiplayerStartupPhase::MAX);
+	/** Filled with -1 (not reached) by the constructor */
+	double StartupPhaseSeconds[NumStartupPhases];
+
+	FDelegateHandle PostLoadMapHandle;
+	FTSTicker::FDelegateHandle FirstFrameTickerHandle;
+};
@@ -5,25 +5,143 @@
 #include "CoreMinimal.h"
 #include "Subsystems/GameInstanceSubsystem.h"
 #include "Interfaces/OnlineSessionInterface.h"
+#include "Containers/Ticker.h"
+#include "MultiplayerSessionIndex.h"
+#include "MultiplayerSessionsQos.h"
+#include "MultiplayerLanDiscovery.h"
+#include "MultiplayerSessionsStats.h"
+#include "MultiplayerReservationBeacon.h"
 
 #include "MultiplayerSessionsSubsystem.generated.h"
 
 
 
+UENUM(BlueprintType)
+enum class EMultiplayerFindSessionsOutcome : uint8
+{
+	Complete,
+	// The deadline passed, results are whatever arrived before it
+	TimedOut,
+	// CancelFindSession was called, results are whatever arrived before it
+	Cancelled,
+	Failed
+};
+
 //
 // Declaring our own custom delegates for the Menu class to bind callbacks
+// Every listener gets every completion, UI that only cares about its own call should use the *Async functions instead
 //
-DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FMultiplayerOnCreateSessionComplete, bool, bWasSuccessful);
-DECLARE_MULTICAST_DELEGATE_TwoParams(FMultiplayerOnFindSessionsComplete, const TArray<FOnlineSessionSearchResult>& SessionResults, bool bWasSuccessful);
+DECLARE_MULTICAST_DELEGATE_OneParam(FMultiplayerOnCreateSessionComplete, bool bWasSuccessful);
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FMultiplayerOnFindSessionsComplete, const TArray<FOnlineSessionSearchResult>& SessionResults, bool bWasSuccessful, EMultiplayerFindSessionsOutcome Outcome);
+DECLARE_MULTICAST_DELEGATE_OneParam(FMultiplayerOnFindSessionsBatch, TArrayView<const FOnlineSessionSearchResult> NewResults);
+// RankedSearchResults was replaced or released, indices from GetRankedSearchResult no longer point at the same sessions
+DECLARE_MULTICAST_DELEGATE(FMultiplayerOnSearchResultsReplaced);
 DECLARE_MULTICAST_DELEGATE_OneParam(FMultiplayerOnJoinSessionComplete, EOnJoinSessionCompleteResult::Type Result);
-DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FMultiplayerOnDestroySessionComplete, bool, bWasSuccessful);
-DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FMultiplayerOnStartSessionComplete, bool, bWasSuccessful);
+DECLARE_MULTICAST_DELEGATE_OneParam(FMultiplayerOnDestroySessionComplete, bool bWasSuccessful);
+DECLARE_MULTICAST_DELEGATE_OneParam(FMultiplayerOnStartSessionComplete, bool bWasSuccessful);
+
+// Per-call continuations, called once for the call that registered them and then released
+using FMultiplayerSessionOpContinuation = TFunction<void(bool bWasSuccessful)>;
+using FMultiplayerFindSessionsContinuation = TFunction<void(const TArray<FOnlineSessionSearchResult>& SessionResults, bool bWasSuccessful, EMultiplayerFindSessionsOutcome Outcome)>;
+using FMultiplayerJoinSessionContinuation = TFunction<void(EOnJoinSessionCompleteResult::Type Result)>;
+
+/** Identifies one *Async call, CancelSessionOp with it drops the continuation */
+struct FMultiplayerSessionOpHandle
+{
+	uint32 Id{ 0 };
+
+	bool IsValid() const { return Id != 0; }
+	void Reset() { Id = 0; }
+};
 
+UENUM(BlueprintType)
+enum class EMultiplayerSessionOp : uint8
+{
+	None,
+	Create,
+	Find,
+	Join,
+	Destroy,
+	Start,
+	Update,
+
+	MAX UMETA(Hidden)
+};
+
+UENUM(BlueprintType)
+enum class EMultiplayerSessionOpStatus : uint8
+{
+	Idle,
+	Queued,
+	InFlight,
+	Succeeded,
+	Failed
+};
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FMultiplayerOnSessionOpStatusChanged, EMultiplayerSessionOp Op, EMultiplayerSessionOpStatus Status);
+
+/**
+ * Search filters pushed into the backend query. Whatever the backend can't filter on
+ * (ping, for instance) is applied to the returned results before they are ranked.
+ */
+USTRUCT(BlueprintType)
+struct FMultiplayerSessionSearchParams
+{
+	GENERATED_BODY()
+
+	// Empty matches every MatchType
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FString MatchType;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool bRequireOpenSlots{ true };
+
+	// 0 means no ping limit
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 MaxPingMs{ 0 };
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 MaxSearchResults{ 50 };
+
+	// Measure real RTT to the best candidates with UDP probes before reporting the results
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool bProbeLatency{ false };
+
+	// Dedicated servers advertise without presence, so they need a separate (non-presence) query
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool bSearchDedicatedServers{ false };
+
+	// Also run LAN discovery at the same time; matching LAN hosts come first
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool bIncludeLan{ false };
+
+	bool operator==(const FMultiplayerSessionSearchParams& Other) const
+	{
+		return MatchType == Other.MatchType
+			&& bRequireOpenSlots == Other.bRequireOpenSlots
+			&& MaxPingMs == Other.MaxPingMs
+			&& MaxSearchResults == Other.MaxSearchResults
+			&& bProbeLatency == Other.bProbeLatency
+			&& bSearchDedicatedServers == Other.bSearchDedicatedServers
+			&& bIncludeLan == Other.bIncludeLan;
+	}
+
+	friend uint32 GetTypeHash(const FMultiplayerSessionSearchParams& Params)
+	{
+		uint32 Hash = GetTypeHash(Params.MatchType);
+		Hash = HashCombine(Hash, GetTypeHash(Params.bRequireOpenSlots));
+		Hash = HashCombine(Hash, GetTypeHash(Params.MaxPingMs));
+		Hash = HashCombine(Hash, GetTypeHash(Params.MaxSearchResults));
+		Hash = HashCombine(Hash, GetTypeHash(Params.bProbeLatency));
+		Hash = HashCombine(Hash, GetTypeHash(Params.bSearchDedicatedServers));
+		return HashCombine(Hash, GetTypeHash(Params.bIncludeLan));
+	}
+};
 
 /**
  * 
  */
-UCLASS()
+UCLASS(Config = Game)
 class MUTIPLAYERSESSIONS_API UMultiplayerSessionsSubsystem : public UGameInstanceSubsystem
 {
 	GENERATED_BODY()
@@ -31,22 +149,92 @@ class MUTIPLAYERSESSIONS_API UMultiplayerSessionsSubsystem : public UGameInstanc
 public:
 	UMultiplayerSessionsSubsystem();
 
-	//
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	//기능
 	void CreateSession(int32 NumPublicConnections, FString MatchType);
-	void FindSession(int32 MaxSearchResults);
+	// 로컬 플레이어 없이 데디케이티드 서버로 세션 등록 (presence, 로비 사용 안함)
+	void CreateDedicatedSession(int32 NumPublicConnections, FString MatchType);
+	// bStreamResults 가 true 이면 검색이 끝나기 전에도 새로 들어온 결과를 MultiplayerOnFindSessionsBatch 로 전달
+	void FindSession(int32 MaxSearchResults, bool bStreamResults = false);
+	// MatchType, 빈 슬롯, 핑 조건을 쿼리에 넣고 결과는 핑 -> 빈 슬롯 순으로 정렬해서 전달
+	// TimeoutSeconds 가 지나면 검색을 취소하고 그때까지 온 결과를 TimedOut 으로 전달, 음수면 SearchTimeoutSeconds, 0 이면 무제한
+	void FindFilteredSessions(const FMultiplayerSessionSearchParams& Params, bool bStreamResults = false, float TimeoutSeconds = -1.f);
+	// 진행중인 검색을 취소하고 그때까지 온 결과를 Cancelled 로 전달
+	void CancelFindSession();
 	void JoinSession(const FOnlineSessionSearchResult& SessionResult);
 	void DestroySession();
 	void StartSession();
 
+	/**
+	 * Same calls as above, but the continuation is only called for this call, exactly once, and then released.
+	 * Calls that are coalesced with an identical queued or in-flight call share its result.
+	 * Finds served from the cache complete before the function returns.
+	 */
+	FMultiplayerSessionOpHandle CreateSessionAsync(int32 NumPublicConnections, const FString& MatchType, FMultiplayerSessionOpContinuation&& OnComplete);
+	FMultiplayerSessionOpHandle FindSessionsAsync(const FMultiplayerSessionSearchParams& Params, FMultiplayerFindSessionsContinuation&& OnComplete, bool bStreamResults = false, float TimeoutSeconds = -1.f);
+	FMultiplayerSessionOpHandle JoinSessionAsync(const FOnlineSessionSearchResult& SessionResult, FMultiplayerJoinSessionContinuation&& OnComplete);
+	FMultiplayerSessionOpHandle DestroySessionAsync(FMultiplayerSessionOpContinuation&& OnComplete);
+	FMultiplayerSessionOpHandle StartSessionAsync(FMultiplayerSessionOpContinuation&& OnComplete);
+	/**
+	 * The continuation will not be called. A call still waiting in the queue is removed from it,
+	 * a search nobody else is waiting on is cancelled, anything else already sent to the backend runs to completion.
+	 */
+	void CancelSessionOp(FMultiplayerSessionOpHandle& Handle);
+
+	// Streamed batches are not filtered, listeners can use this to check each result
+	bool PassesSearchFilter(const FOnlineSessionSearchResult& SessionResult) const;
+	static int32 GetOpenSlots(const FOnlineSessionSearchResult& SessionResult);
+	// bIncludeLan 검색에서 LAN 탐색으로 찾은 결과, 백엔드 세션 없이 주소로 바로 참가
+	static bool IsLanSearchResult(const FOnlineSessionSearchResult& SessionResult);
+	// 호스트가 광고하고 검색이 요구하는 빌드 id, 네트워크 버전이 다른 빌드의 세션은 결과에서 빠짐
+	static int32 GetLocalBuildUniqueId();
+	// 참가한 세션의 접속 주소, LAN 호스트에 참가했으면 탐색 응답의 주소
+	bool GetResolvedConnectString(FString& OutConnectInfo, FName PortType = NAME_GamePort) const;
+
+	// Top K of the last completed search, best first, read from the compact index instead of the full results
+	int32 SelectTopSessions(const FMultiplayerSessionSearchParams& Params, int32 K, TArray<int32>& OutResultIndices) const;
+	const FOnlineSessionSearchResult* GetRankedSearchResult(int32 ResultIndex) const;
+	int32 GetNumRankedSearchResults() const { return RankedSearchResults->Num(); }
+
+	/**
+	 * Replaces the online subsystem's session interface, e.g. with FMultiplayerFakeOnlineSession for benchmarks.
+	 * Pass nullptr to go back to IOnlineSubsystem::Get(). Only swap while no session op is queued or in flight.
+	 */
+	void SetSessionInterfaceOverride(IOnlineSessionPtr InSessionInterface);
+	bool IsUsingSessionInterfaceOverride() const { return bUsingSessionInterfaceOverride; }
+	void ClearSearchCache();
+
+	/**
+	 * Starts async loading the map the next travel will open, together with its hard dependencies,
+	 * so disk I/O overlaps the backend round trip. The package stays resident until the next map load.
+	 */
+	void PrewarmTravelMap(const FString& MapPath);
+	// 비콘 예약 등으로 아직 접속하지 않았지만 잡아둔 자리, 광고하는 빈자리에서 빠짐
+	void AddReservedSlots(int32 Delta);
+	int32 GetReservedSlots() const { return ReservedSlots; }
+	// 호스트: 지금 새로 받을 수 있는 인원 (접속 + 예약 제외)
+	int32 GetHostOpenSlots() const;
+
+	// 호스트가 광고하는 맵, 참가하는 쪽은 이걸 보고 JoinSession 때 미리 로드
+	void SetAdvertisedMapPath(const FString& MapPath) { AdvertisedMapPath = MapPath; }
+
+	// Session calls run one at a time, UI can use this to show what is queued or waiting on the backend
+	UFUNCTION(BlueprintPure)
+	EMultiplayerSessionOpStatus GetSessionOpStatus(EMultiplayerSessionOp Op) const;
 
 	//
 	// Our own custom delegates for the Menu class to bind callbacks to
 	//
 	FMultiplayerOnCreateSessionComplete MultiplayerOnCreateSessionComplete;
 	FMultiplayerOnFindSessionsComplete MultiplayerOnFindSessionsComplete;
+	FMultiplayerOnFindSessionsBatch MultiplayerOnFindSessionsBatch;
+	FMultiplayerOnSearchResultsReplaced MultiplayerOnSearchResultsReplaced;
 	FMultiplayerOnJoinSessionComplete MultiplayerOnJoinSessionComplete;
 	FMultiplayerOnDestroySessionComplete MultiplayerOnDestroySessionComplete;
 	FMultiplayerOnStartSessionComplete MultiplayerOnStartSessionComplete;
+	FMultiplayerOnSessionOpStatusChanged MultiplayerOnSessionOpStatusChanged;
 protected:
 	//internal callbacks for the delegates we'll add to the Online Session Interface delegate list
 	// This don't need to be called outside this class
@@ -56,16 +244,178 @@ protected:
 	void OnJoinSessionComplete(FName SessionName, EOnJoinSessionCompleteResult::Type Result);
 	void OnDestroySessionComplete(FName SessionName, bool bWasSuccessful);
 	void OnStartSessionComplete(FName SessionName, bool bWasSuccessful);
+	void OnCancelFindSessionsComplete(bool bWasSuccessful);
+
+	// Operation queue: only one backend call is in flight, the next one starts when it completes
+	// ContinuationId 0 is a plain call with no per-call continuation
+	void EnqueueSessionOp(EMultiplayerSessionOp Op, TFunction<void()>&& Begin, uint32 ContinuationId = 0, const FMultiplayerSessionSearchParams& SearchParams = FMultiplayerSessionSearchParams());
+	void PumpSessionOps();
+	void FinishSessionOp(EMultiplayerSessionOp Op, bool bWasSuccessful);
+	// Moves the active op's continuation ids to CompletedContinuations so the next op can start before they are notified
+	void ParkActiveContinuations(EMultiplayerSessionOp Op);
+	void SetSessionOpStatus(EMultiplayerSessionOp Op, EMultiplayerSessionOpStatus Status);
+	static EMultiplayerSessionTimer GetSessionOpTimer(EMultiplayerSessionOp Op);
+
+	// Per-call continuations: the *Async functions register one and pass its id to the Queue function,
+	// the op it enqueues carries the id, and the Notify functions call it next to the multicast delegate
+	uint32 AddSessionOpContinuation(EMultiplayerSessionOp Op);
+	// Called after the Queue function returns, fails the continuation if the call returned without enqueueing anything
+	FMultiplayerSessionOpHandle FinishAsyncCall(uint32 ContinuationId, bool bQueued);
+	void NotifyCreateSessionComplete(bool bWasSuccessful);
+	// Calls the continuations parked for the search with that SearchSerial, continuations waiting on other searches are left alone
+	void NotifyFindSessionsComplete(uint32 ForSearchSerial, const TArray<FOnlineSessionSearchResult>& SessionResults, bool bWasSuccessful, EMultiplayerFindSessionsOutcome Outcome, bool bBroadcast = true);
+	// For calls that never reached a search (dropped from the queue, served from the cache) or were taken off the active one
+	void CompleteFindContinuations(const TArray<uint32>& ContinuationIds, const TArray<FOnlineSessionSearchResult>& SessionResults, bool bWasSuccessful, EMultiplayerFindSessionsOutcome Outcome);
+	void NotifyJoinSessionComplete(EOnJoinSessionCompleteResult::Type Result);
+	void NotifyDestroySessionComplete(bool bWasSuccessful);
+	void NotifyStartSessionComplete(bool bWasSuccessful);
+
+	// Return false when nothing was queued and ContinuationId was not used
+	bool QueueCreateSession(int32 NumPublicConnections, const FString& MatchType, bool bDedicated, uint32 ContinuationId = 0);
+	bool QueueFindSessions(const FMultiplayerSessionSearchParams& InParams, bool bStreamResults, float TimeoutSeconds, uint32 ContinuationId = 0);
+	bool QueueJoinSession(const FOnlineSessionSearchResult& SessionResult, uint32 ContinuationId = 0);
+	bool QueueDestroySession(uint32 ContinuationId = 0);
+	bool QueueStartSession(uint32 ContinuationId = 0);
+	void BeginCreateSession(int32 NumPublicConnections, const FString& MatchType, bool bDedicated);
+	void BeginFindSessions(const FMultiplayerSessionSearchParams& Params, bool bStreamResults, bool bRefreshCacheOnly, double DeadlineSeconds);
+	void BeginJoinSession(const FOnlineSessionSearchResult& SessionResult);
+	void BeginDestroySession();
+	void BeginStartSession();
+	// 진행중인 검색을 기다리던 호출은 PartialResults 와 Cancelled 를 받음, 리스너 방송은 호출한 쪽에서
+	void CancelActiveSearch(const TArray<FOnlineSessionSearchResult>& PartialResults = TArray<FOnlineSessionSearchResult>());
+	// 백엔드 검색만 멈춤, Find 작업은 호출한 쪽에서 FinishCancelledSearchOp 로 끝냄
+	void CancelBackendSearch();
+	// 백엔드가 취소를 확인할때까지 Find 작업을 잡아둠, 확인 전에 다음 검색을 보내면 거절됨
+	void FinishCancelledSearchOp(bool bWasSuccessful);
+	bool OnSearchDeadline(float DeltaTime);
+	void StopSearchDeadline();
+	void CopyPartialSearchResults(TArray<FOnlineSessionSearchResult>& OutResults) const;
+	// 로컬 플레이어가 없으면(데디서버, 벤치마크) nullptr, 그때는 PlayerNum 0 오버로드를 사용
+	FUniqueNetIdPtr GetLocalPlayerNetId() const;
+
+	// Online bring-up is kept off the boot path: it runs OnlineInitDelaySeconds after the first frame,
+	// or on the first session call if that comes sooner. False if there is no session interface
+	bool EnsureSessionInterface();
+	// NULL 서브시스템이면 LAN 으로 만들고 찾음, 세션 인터페이스를 바꿔 끼웠으면 false
+	bool IsNullSubsystemActive() const;
+	bool OnDeferredOnlineInit(float DeltaTime);
+	// 한 머신에 서버를 여러개 띄울수 있게 -QosPort= -LanDiscoveryPort= 로 설정값을 덮어씀, 게임 포트는 엔진의 -port=
+	void ApplyCommandLinePorts();
+	// 데디서버는 첫 맵이 뜨고 넷 드라이버가 포트를 잡은 뒤에 세션을 등록
+	void RegisterDedicatedSession(UWorld* LoadedWorld);
+
+	void OnTravelMapPrewarmed(const FName& PackageName, class UPackage* LoadedPackage, EAsyncLoadingResult::Type Result);
+	void OnPostLoadMap(UWorld* LoadedWorld);
+	void ReleasePrewarmedMap();
+
+	// 호스트: 접속/예약 인원이 바뀌면 SessionUpdateIntervalSeconds 에 한번만 UpdateSession
+	void OnGameModePreLogin(class AGameModeBase* GameMode, const FUniqueNetIdRepl& NewPlayer, FString& ErrorMessage);
+	void OnGameModePostLogin(class AGameModeBase* GameMode, class APlayerController* NewPlayer);
+	void OnGameModeLogout(class AGameModeBase* GameMode, class AController* Exiting);
+	void MarkSessionPlayerCountDirty();
+	bool OnSessionUpdateTimer(float DeltaTime);
+	void FlushSessionPlayerCount();
+	void BeginUpdateSession(FOnlineSessionSettings& UpdatedSettings);
+	void OnUpdateSessionComplete(FName SessionName, bool bWasSuccessful);
+
+	// 호스트: 세션이 있는 월드마다 예약 비콘을 띄우고 포트를 세션에 광고
+	void StartReservationBeacon(UWorld* World);
+	void StopReservationBeacon();
+	// 참가: JoinSession 성공 후 이동 전에 비콘으로 자리를 잡음, 시작 못하면 false
+	bool BeginSlotReservation();
+	void OnSlotReservationComplete(EMultiplayerReservationResult Result);
+	void CompleteJoinSession(EOnJoinSessionCompleteResult::Type Result);
+
+	// Caches and reports a ranked search, after the QoS stage if one was requested
+	void FinishFindSessions(bool bWasSuccessful, bool bCacheResults = true);
+	bool StartQosProbe(bool bWasSuccessful);
+	// 핑을 재는 중인 검색을 기다리던 호출에 재기 전 결과를 Cancelled 로 보내고 늦게 오는 측정은 버림
+	void CancelQosProbe();
+	static void ApplyQosResults(TArray<FOnlineSessionSearchResult>& Results, const TArray<int32>& ProbedResultIndices, const TArray<FMultiplayerQosResult>& QosResults);
+
+	// Streaming search: forwards results the backend has appended since the last poll
+	bool PollStreamedSearchResults(float DeltaTime);
+	void BroadcastStreamedBatch();
+	void StopStreamingSearch();
+	static bool PassesSearchFilter(const FOnlineSessionSearchResult& SessionResult, const FMultiplayerSessionSearchParams& Params);
+	static FMultiplayerSessionIndex::FFilter MakeIndexFilter(const FMultiplayerSessionSearchParams& Params);
+	// Keeps the best MaxSearchResults matches in RankedSearchResults and releases the rest of the search
+	void RankCompletedSearch(const FMultiplayerSessionSearchParams& Params);
+
+	// Search result cache
+	bool TryServeSearchFromCache(const FMultiplayerSessionSearchParams& Params, bool& bOutNeedsRefresh, uint32 ContinuationId);
+	void CacheSearchResults(const FMultiplayerSessionSearchParams& Params, const TSharedRef<const TArray<FOnlineSessionSearchResult>>& SearchResults);
+	void EvictSessionFromCache(const FString& SessionId);
+
+	// Search storage: the FOnlineSessionSearch is reused while the backend no longer holds it,
+	// and everything is released once a join has gone through
+	void ResetSessionSearch();
+	void ReleaseSearchResults();
+	void UpdateSearchMemoryStats() const;
+
+	// LAN + online search: FMultiplayerLanDiscovery probes the LAN next to the online query.
+	// It returns a few milliseconds after the first host answers, so a LAN host never waits on the backend
+	void BeginLanSearch(const FMultiplayerSessionSearchParams& Params);
+	void OnLanDiscoveryComplete(uint32 DiscoverySearchSerial, TArray<FMultiplayerLanHost>&& Hosts);
+	bool HasMatchingLanResult() const;
+	void FinishFindWithLanResults();
+	void CancelLanSearch();
+	// Puts matching LAN results in front of RankedSearchResults and drops online duplicates of the same host
+	void MergeLanResults(const FMultiplayerSessionSearchParams& Params);
+	// LAN 결과에 참가, 백엔드 호출 없이 바로 완료됨
+	void JoinLanHost(const FOnlineSessionSearchResult& SessionResult);
+	// Host side: answers LAN probes with the hosted session's settings
+	void AdvertiseOnLan();
+	void UpdateLanAdvertisement();
+	bool ResolveSearchResultAddress(const FOnlineSessionSearchResult& SessionResult, FString& OutConnectInfo) const;
 
 private:
-	//ý ٱ ʾƵ Ǵ private
+	//서브시스템을 바깥에서 접근하지않아도 되니 private
 	IOnlineSessionPtr SessionInterface;
+	bool bUsingSessionInterfaceOverride{ false };
+	bool bOnlineInitialized{ false };
+	// EnsureSessionInterface 가 가져온 서브시스템 이름, 못 가져왔으면 NAME_None
+	FName OnlineSubsystemName;
+	FTSTicker::FDelegateHandle DeferredOnlineInitTickerHandle;
+	// 첫 프레임 뒤 몇 초 후에 온라인 서브시스템을 미리 띄울지, 음수면 첫 세션 호출때만 띄움
+	UPROPERTY(Config)
+	float OnlineInitDelaySeconds{ 0.f };
+
+	// 이동이 끝날때까지 GC 되지 않게 잡아둠, 패키지만 잡으면 LoadMap 전 GC 가 월드를 수거함
+	UPROPERTY(Transient)
+	TObjectPtr<UWorld> PrewarmedWorld;
+	FName PrewarmingMapName;
+	FString AdvertisedMapPath;
+	FDelegateHandle PostLoadMapHandle;
+
+	FDelegateHandle GameModePreLoginHandle;
+	FDelegateHandle GameModePostLoginHandle;
+	FDelegateHandle GameModeLogoutHandle;
+	FTSTicker::FDelegateHandle SessionUpdateTickerHandle;
+	int32 ReservedSlots{ 0 };
+	int32 LastAdvertisedOpenSlots{ INDEX_NONE };
+	double LastSessionUpdateSeconds{ 0.0 };
+	bool bSessionUpdateScheduled{ false };
 
-	//CreateSession ð 
+	// 액터라 맵 이동 때 월드와 같이 사라짐
+	TWeakObjectPtr<class AOnlineBeaconHost> ReservationBeaconHost;
+	TWeakObjectPtr<AMultiplayerReservationBeaconHostObject> ReservationHostObject;
+	TWeakObjectPtr<AMultiplayerReservationBeaconClient> ReservationClient;
+	int32 BeaconListenPort{ 0 };
+	// 예약을 쓰고 들어온 플레이어, 하드 트래블로 다시 접속할때는 예약 없이 받아줌
+	TSet<FUniqueNetIdRepl> AdmittedPlayers;
+
+	//CreateSession에서 세팅값 저장
 	TSharedPtr<FOnlineSessionSettings> LastSessionSettings;
 	TSharedPtr<FOnlineSessionSearch> LastSessionSearch;
+	//검색이 끝나면 필요한 결과만 남기고 나머지는 해제, 캐시와 같은 배열을 공유하니 바꿀때는 새 배열로 교체
+	TSharedRef<const TArray<FOnlineSessionSearchResult>> RankedSearchResults{ MakeShared<const TArray<FOnlineSessionSearchResult>>() };
+	FMultiplayerSessionIndex SessionIndex;
+	FMultiplayerSessionSearchParams LastSearchParams;
+	// LastSearchParams 는 마지막으로 요청된 조건, 이건 실제로 백엔드에 나가있는 검색의 조건
+	FMultiplayerSessionSearchParams InFlightSearchParams;
 
-	//Ʈ Ʈ
+	//델리게이트 리스트
 	// We will bind our MultiplayerSessionSubsystem internal callbacks to these
 	FOnCreateSessionCompleteDelegate CreateSessionCompletedDelegate;
 	FDelegateHandle CreateSessionCompleteDelegateHandle;
@@ -77,9 +427,156 @@ private:
 	FDelegateHandle DestroySessionCompleteDelegateHandle;
 	FOnStartSessionCompleteDelegate StartSessionCompletedDelegate;
 	FDelegateHandle StartSessionCompleteDelegateHandle;
+	FOnCancelFindSessionsCompleteDelegate CancelFindSessionsCompletedDelegate;
+	FDelegateHandle CancelFindSessionsCompleteDelegateHandle;
+	FOnUpdateSessionCompleteDelegate UpdateSessionCompletedDelegate;
+	FDelegateHandle UpdateSessionCompleteDelegateHandle;
+
+	struct FQueuedSessionOp
+	{
+		EMultiplayerSessionOp Op{ EMultiplayerSessionOp::None };
+		TFunction<void()> Begin;
+		// Only used to coalesce Find requests
+		FMultiplayerSessionSearchParams SearchParams;
+		// *Async calls waiting on this op, coalesced calls add theirs
+		TArray<uint32> ContinuationIds;
+	};
+	TArray<FQueuedSessionOp> PendingSessionOps;
+	EMultiplayerSessionOp ActiveSessionOp{ EMultiplayerSessionOp::None };
+	TArray<uint32> ActiveContinuationIds;
+
+	struct FSessionOpContinuation
+	{
+		EMultiplayerSessionOp Op{ EMultiplayerSessionOp::None };
+		FMultiplayerSessionOpContinuation OnComplete;
+		FMultiplayerFindSessionsContinuation OnFindComplete;
+		FMultiplayerJoinSessionContinuation OnJoinComplete;
+	};
+	TMap<uint32, FSessionOpContinuation> SessionOpContinuations;
+	uint32 NextContinuationId{ 0 };
+	// FinishSessionOp parks the finished op's ids here until its Notify runs. A synchronous failure of the
+	// next op can finish and notify in between, so the latest entry for an op is always the one being notified.
+	// Find entries are keyed by SearchSerial instead, a search's report can come after the QoS stage
+	// when the next search is already running
+	struct FCompletedContinuations
+	{
+		EMultiplayerSessionOp Op{ EMultiplayerSessionOp::None };
+		TArray<uint32> ContinuationIds;
+		uint32 SearchSerial{ 0 };
+	};
+	TArray<FCompletedContinuations> CompletedContinuations;
+	// Removes the continuations waiting on Op's completion from the map, for Find only those of ForSearchSerial
+	void TakeCompletedContinuations(EMultiplayerSessionOp Op, TArray<FSessionOpContinuation>& OutContinuations, uint32 ForSearchSerial = 0);
+	void TakeContinuations(const TArray<uint32>& ContinuationIds, TArray<FSessionOpContinuation>& OutContinuations);
+	EMultiplayerSessionOpStatus SessionOpStatuses[static_cast<int32>(EMultiplayerSessionOp::MAX)]{};
+	bool bPumpingSessionOps{ false };
+
+	// Streaming search state
+	FTSTicker::FDelegateHandle StreamSearchTickerHandle;
+	int32 NumStreamedResults{ 0 };
+	bool bStreamingSearch{ false };
+	bool bSearchCancelled{ false };
+	// CancelFindSessions 를 보냈고 OnCancelFindSessionsComplete 를 기다리는 중
+	bool bAwaitingSearchCancel{ false };
+	bool bCancelledSearchSucceeded{ false };
+	static constexpr float StreamSearchPollInterval{ 0.05f };
+
+	// 백엔드가 멈춰도 Join 버튼이 계속 막혀있지 않게 검색 시간을 제한
+	FTSTicker::FDelegateHandle SearchDeadlineTickerHandle;
+
+	// LAN 탐색 결과, 온라인 결과와 같은 필터로 거른 뒤 병합
+	TArray<FOnlineSessionSearchResult> LanSearchResults;
+	bool bLanSearchActive{ false };
+	TSharedPtr<FThreadSafeBool, ESPMode::ThreadSafe> LanDiscoveryCancelFlag;
+	// LAN 호스트에 참가하면 백엔드 세션이 없으니 설정과 주소를 직접 들고 있음
+	bool bGameSessionOnLan{ false };
+	FString JoinedLanAddress;
+	FOnlineSessionSettings JoinedLanSettings;
+	TUniquePtr<FMultiplayerLanDiscoveryResponder> LanResponder;
+	// 호스트가 만든 세션을 LAN 에도 같이 광고 (현장 이벤트, 사내 플레이테스트용)
+	UPROPERTY(Config)
+	bool bAdvertiseOnLan{ false };
+	// Hosts bind the first free port in [LanDiscoveryPort, LanDiscoveryPort + LanDiscoveryPortRange)
+	UPROPERTY(Config)
+	int32 LanDiscoveryPort{ 7797 };
+	UPROPERTY(Config)
+	int32 LanDiscoveryPortRange{ 8 };
+	// 탐색 패킷을 다시 보내는 간격, 첫 응답 후 다른 호스트를 더 기다리는 시간, 전체 제한 시간
+	UPROPERTY(Config)
+	float LanProbeIntervalSeconds{ 0.05f };
+	UPROPERTY(Config)
+	float LanFirstResponseGraceSeconds{ 0.005f };
+	UPROPERTY(Config)
+	float LanDiscoveryTimeoutSeconds{ 1.f };
+	UPROPERTY(Config)
+	float SearchTimeoutSeconds{ 8.f };
+
+	// Upper bound on results kept per search, whatever MaxSearchResults the caller asks for. 0 disables the cap.
+	UPROPERTY(Config)
+	int32 MaxStoredSearchResults{ 200 };
+	// Oldest cached search is dropped when a new one would exceed this
+	UPROPERTY(Config)
+	int32 MaxCachedSearches{ 4 };
+
+	// Results younger than the TTL are served from memory. Up to StaleSeconds past the TTL they are
+	// still served, but a background search refreshes them. 0 disables the cache.
+	UPROPERTY(Config)
+	float SearchCacheTTLSeconds{ 10.f };
+	UPROPERTY(Config)
+	float SearchCacheStaleSeconds{ 30.f };
+
+	struct FCachedSessionSearch
+	{
+		TSharedPtr<const TArray<FOnlineSessionSearchResult>> Results;
+		double Timestamp{ 0.0 };
+	};
+	TMap<FMultiplayerSessionSearchParams, FCachedSessionSearch> SearchCache;
+	bool bBackgroundSearch{ false };
+	// 검색마다 증가, 늦게 도착한 QoS 결과가 새 검색을 덮어쓰지 않게 함
+	uint32 SearchSerial{ 0 };
+	// 검색 작업은 끝났고 핑 측정 결과를 기다리는 검색의 SearchSerial, 0 이면 없음
+	uint32 QosProbeSearchSerial{ 0 };
+	bool bQosProbeRefreshOnly{ false };
+	// 재기 전 결과, 측정이 취소되면 기다리던 호출에 이걸 보냄
+	TSharedPtr<const TArray<FOnlineSessionSearchResult>> QosProbeResults;
+	FString PendingJoinSessionId;
+
+	// QoS probe: hosts answer on QosPort, clients probe the best QosProbeCandidates results.
+	// 0 lets the OS pick a free port, -1 turns the responder off. Only the port that bound is advertised.
+	UPROPERTY(Config)
+	int32 QosPort{ 0 };
+	UPROPERTY(Config)
+	int32 QosProbeCandidates{ 4 };
+	UPROPERTY(Config)
+	int32 QosProbesPerHost{ 5 };
+	UPROPERTY(Config)
+	float QosProbeTimeoutSeconds{ 0.5f };
+
+	// 데디케이티드 서버로 실행되면 첫 맵이 뜬 뒤 세션을 자동으로 등록
+	UPROPERTY(Config)
+	bool bRegisterDedicatedSession{ true };
+	bool bDedicatedSessionRegistered{ false };
+	// 인원 변화를 백엔드에 올리는 최소 간격
+	UPROPERTY(Config)
+	float SessionUpdateIntervalSeconds{ 2.f };
+	// 이동 전에 비콘으로 자리를 예약할지, 비콘을 광고하지 않는 호스트는 예약 없이 이동
+	// 호스트: 비콘이 떠 있으면 예약 없이 들어오는 접속은 PreLogin 에서 거절
+	UPROPERTY(Config)
+	bool bReserveSlotBeforeTravel{ true };
+	// 호스트: 예약 비콘 포트, 0 이면 OS 가 고른 포트를 광고. -BeaconPort= 로 덮어씀
+	UPROPERTY(Config)
+	int32 BeaconPort{ 0 };
+	// 호스트: 예약하고 이 시간 안에 들어오지 않으면 자리를 풀어줌
+	UPROPERTY(Config)
+	float ReservationTimeoutSeconds{ 30.f };
+	// 참가: 비콘 응답을 기다리는 최대 시간
+	UPROPERTY(Config)
+	float ReservationResponseTimeoutSeconds{ 5.f };
+	UPROPERTY(Config)
+	FString DedicatedSessionMatchType{ TEXT("FreeForAll") };
+	UPROPERTY(Config)
+	int32 DedicatedSessionPublicConnections{ 100 };
 
-	bool bCreateSessionOnDestroy{ false };
-	int32 LastNumPublicConnections;
-	FString LastMatchType;
+	TUniquePtr<FMultiplayerQosResponder> QosResponder;
 
 };
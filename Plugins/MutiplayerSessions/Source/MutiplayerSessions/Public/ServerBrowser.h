@@ -0,0 +1,164 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "Blueprint/IUserObjectListEntry.h"
+#include "Interfaces/OnlineSessionInterface.h"
+#include "MultiplayerSessionsSubsystem.h"
+#include "ServerBrowser.generated.h"
+
+class UServerBrowser;
+
+UENUM(BlueprintType)
+enum class EServerBrowserSortMode : uint8
+{
+	Ping,
+	OpenSlots,
+	Players
+};
+
+/**
+ * List item handed to the UListView. Holds nothing but the row it stands for;
+ * items are pooled by row index and reused across refreshes.
+ */
+UCLASS(Transient)
+class MUTIPLAYERSESSIONS_API UServerBrowserItem : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	int32 RowIndex{ INDEX_NONE };
+	TWeakObjectPtr<UServerBrowser> Browser;
+};
+
+/**
+ * One visible row of the browser. The list view only creates as many of these as fit on screen
+ * and recycles them while scrolling; text is read from the search result when a row is assigned.
+ */
+UCLASS(Abstract)
+class MUTIPLAYERSESSIONS_API UServerBrowserEntry : public UUserWidget, public IUserObjectListEntry
+{
+	GENERATED_BODY()
+
+protected:
+	//~ Begin IUserObjectListEntry Interface
+	virtual void NativeOnListItemObjectSet(UObject* ListItemObject) override;
+	//~ End IUserObjectListEntry Interface
+
+private:
+	UPROPERTY(meta = (BindWidget))
+	class UTextBlock* ServerNameText;
+	UPROPERTY(meta = (BindWidgetOptional))
+	UTextBlock* MatchTypeText;
+	UPROPERTY(meta = (BindWidgetOptional))
+	UTextBlock* PlayersText;
+	UPROPERTY(meta = (BindWidgetOptional))
+	UTextBlock* PingText;
+};
+
+/**
+ * Session browser for large result sets.
+ * Results are turned into compact rows a few hundred per frame as they stream in, sorting and filtering
+ * only touch those rows, and the UListView keeps the number of entry widgets at what is visible.
+ */
+UCLASS()
+class MUTIPLAYERSESSIONS_API UServerBrowser : public UUserWidget
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION(BlueprintCallable)
+	void Refresh();
+
+	UFUNCTION(BlueprintCallable)
+	void SetSortMode(EServerBrowserSortMode InSortMode);
+
+	// Empty MatchType shows every match type, MaxPingMs 0 shows every ping
+	UFUNCTION(BlueprintCallable)
+	void SetFilter(const FString& InMatchType, bool bInHideFullSessions, int32 InMaxPingMs);
+
+	UFUNCTION(BlueprintCallable)
+	void JoinSelectedSession();
+
+	const FOnlineSessionSearchResult* GetRowResult(int32 RowIndex) const;
+
+protected:
+	virtual void NativeConstruct() override;
+	virtual void NativeDestruct() override;
+	virtual void NativeTick(const FGeometry& MyGeometry, float InDeltaTime) override;
+
+	// Subsystem에 요청하는 최대 개수, MaxStoredSearchResults 보다 크면 그 값으로 잘림
+	UPROPERTY(EditAnywhere, Category = "Server Browser")
+	int32 MaxSessions{ 10000 };
+	// 한 프레임에 행으로 만드는 결과 수
+	UPROPERTY(EditAnywhere, Category = "Server Browser")
+	int32 RowsPerFrame{ 500 };
+	UPROPERTY(EditAnywhere, Category = "Server Browser")
+	FString MatchTypeFilter;
+	UPROPERTY(EditAnywhere, Category = "Server Browser")
+	bool bHideFullSessions{ false };
+	UPROPERTY(EditAnywhere, Category = "Server Browser")
+	int32 MaxPingMs{ 0 };
+	UPROPERTY(EditAnywhere, Category = "Server Browser")
+	EServerBrowserSortMode SortMode{ EServerBrowserSortMode::Ping };
+
+private:
+	void OnFindSessions(const TArray<FOnlineSessionSearchResult>& SessionResults, bool bWasSuccessful, EMultiplayerFindSessionsOutcome Outcome);
+	// 검색이 끝나기 전에 들어온 결과로 행을 미리 만듬, 완료되면 서브시스템 결과로 다시 만듬
+	void OnFindSessionsBatch(TArrayView<const FOnlineSessionSearchResult> NewResults);
+	// 서브시스템 결과가 바뀌면 행의 인덱스가 다른 세션을 가리키니 처음부터 다시 만듬
+	void OnSearchResultsReplaced();
+	void OnJoinSession(EOnJoinSessionCompleteResult::Type Result);
+	// 버튼을 다시 켜고 이유를 보여줌
+	void JoinFailed(const TCHAR* Status);
+
+	UFUNCTION()
+	void RefreshButtonClicked();
+	UFUNCTION()
+	void JoinSelectedButtonClicked();
+
+	void BuildPendingRows();
+	const FOnlineSessionSearchResult* GetSourceResult(int32 ResultIndex) const;
+	bool PassesFilter(int32 RowIndex) const;
+	// Re-sorts and re-filters the rows and hands the visible items to the list in one go
+	void ApplySortAndFilter();
+	UServerBrowserItem* GetPooledItem(int32 RowIndex);
+	void UpdateStatusText();
+
+	UPROPERTY(meta = (BindWidget))
+	class UListView* SessionList;
+	UPROPERTY(meta = (BindWidgetOptional))
+	class UButton* RefreshButton;
+	UPROPERTY(meta = (BindWidgetOptional))
+	UButton* JoinSelectedButton;
+	UPROPERTY(meta = (BindWidgetOptional))
+	class UTextBlock* StatusText;
+
+	UMultiplayerSessionsSubsystem* MultiplayerSessionsSubsystem{ nullptr };
+
+	// 행마다 필요한 값만 복사, 이름 같은 문자열은 화면에 보일때만 결과에서 읽음
+	struct FRow
+	{
+		int32 ResultIndex{ INDEX_NONE };
+		int32 PingMs{ 0 };
+		int32 OpenSlots{ 0 };
+		int32 MaxSlots{ 0 };
+		uint32 MatchTypeHash{ 0 };
+	};
+	TArray<FRow> Rows;
+	int32 NumResultsToBuild{ 0 };
+	// Refresh 로 시작한 검색이 끝나기 전까지는 스트리밍으로 받은 결과 복사본을 행이 가리킴
+	TArray<FOnlineSessionSearchResult> StreamedResults;
+	bool bRowsFromStream{ false };
+	uint32 MatchTypeFilterHash{ 0 };
+
+	UPROPERTY(Transient)
+	TArray<UServerBrowserItem*> ItemPool;
+	UPROPERTY(Transient)
+	TArray<UObject*> VisibleItems;
+
+	bool bJoinRequested{ false };
+	FMultiplayerSessionOpHandle JoinSessionHandle;
+};
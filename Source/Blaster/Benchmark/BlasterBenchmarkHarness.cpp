@@ -0,0 +1,143 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Benchmark/BlasterBenchmarkHarness.h"
+#include "Blaster.h"
+#include "Engine/World.h"
+#include "Misc/App.h"
+
+#if BLASTER_WITH_BENCHMARKS
+
+TSharedPtr<FBlasterBenchmarkHarness> FBlasterBenchmarkHarness::Running;
+
+FBlasterBenchmarkHarness::FBlasterBenchmarkHarness(UWorld* InWorld, int32 InNumShooters, float InShotsPerSecond, float InSeconds, float InDrainSeconds, int32 InRandomSeed, TArray<bool>&& InPhases)
+	: World(InWorld)
+	, NumShooters(InNumShooters)
+	, ShotsPerSecond(InShotsPerSecond)
+	, Seconds(InSeconds)
+	, DrainSeconds(InDrainSeconds)
+	, RandomSeed(InRandomSeed)
+	, Phases(MoveTemp(InPhases))
+{
+}
+
+bool FBlasterBenchmarkHarness::Launch(const TSharedRef<FBlasterBenchmarkHarness>& Benchmark)
+{
+	if (Running.IsValid())
+	{
+		UE_LOG(LogBlaster, Warning, TEXT("%s is already running"), Running->GetName());
+		return false;
+	}
+	if (Benchmark->Phases.Num() == 0)
+	{
+		return false;
+	}
+	Running = Benchmark;
+	Benchmark->Start();
+	return true;
+}
+
+TArray<bool> FBlasterBenchmarkHarness::ParsePhases(const FString& Mode, const TCHAR* TrueMode, const TCHAR* FalseMode)
+{
+	TArray<bool> Phases;
+	if (Mode != FalseMode)
+	{
+		Phases.Add(true);
+	}
+	if (Mode != TrueMode)
+	{
+		Phases.Add(false);
+	}
+	return Phases;
+}
+
+void FBlasterBenchmarkHarness::Start()
+{
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateSP(this, &FBlasterBenchmarkHarness::Tick));
+
+	FRandomStream Random(RandomSeed);
+	Shooters.Reset(NumShooters);
+	for (int32 Index = 0; Index < NumShooters; ++Index)
+	{
+		const FVector2D Offset(Random.FRandRange(-5000.f, 5000.f), Random.FRandRange(-5000.f, 5000.f));
+		Shooters.Emplace(Offset.X, Offset.Y, 200.f);
+	}
+	OnStart();
+	StartPhase();
+}
+
+void FBlasterBenchmarkHarness::Stop()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+	OnStop();
+	Running.Reset();
+}
+
+void FBlasterBenchmarkHarness::StartPhase()
+{
+	Elapsed = 0.f;
+	ShotAccumulator = 0.f;
+	FrameTimes.Reset(FMath::CeilToInt(Seconds * 240.f));
+	BeginPhase(Phases[PhaseIndex]);
+}
+
+bool FBlasterBenchmarkHarness::Tick(float DeltaTime)
+{
+	if (!IsTargetValid())
+	{
+		UE_LOG(LogBlaster, Warning, TEXT("%s: world went away, stopping"), GetName());
+		Stop();
+		return false;
+	}
+
+	Elapsed += DeltaTime;
+	FrameTimes.Add(FApp::GetDeltaTime());
+	OnFrame();
+
+	if (Elapsed < Seconds)
+	{
+		ShotAccumulator += DeltaTime * ShotsPerSecond * NumShooters;
+		while (ShotAccumulator >= 1.f)
+		{
+			ShotAccumulator -= 1.f;
+			Fire(Shooters[FMath::RandHelper(Shooters.Num())]);
+		}
+		return true;
+	}
+
+	//날아가는 중인 작업이 다 돌아올때까지 기다림
+	if (Elapsed < Seconds + DrainSeconds)
+	{
+		return true;
+	}
+
+	EndPhase(Phases[PhaseIndex], SummarizeFrames());
+	++PhaseIndex;
+	if (PhaseIndex < Phases.Num())
+	{
+		StartPhase();
+		return true;
+	}
+	Stop();
+	return false;
+}
+
+FBlasterBenchmarkHarness::FFrameSummary FBlasterBenchmarkHarness::SummarizeFrames() const
+{
+	FFrameSummary Summary;
+	Summary.NumFrames = FrameTimes.Num();
+	double TotalFrameSeconds = 0.0;
+	for (const float FrameTime : FrameTimes)
+	{
+		TotalFrameSeconds += FrameTime;
+		Summary.MaxSeconds = FMath::Max<double>(Summary.MaxSeconds, FrameTime);
+	}
+	Summary.AvgSeconds = FrameTimes.Num() > 0 ? TotalFrameSeconds / FrameTimes.Num() : 0.0;
+	for (const float FrameTime : FrameTimes)
+	{
+		Summary.NumSpikes += FrameTime > Summary.AvgSeconds * 2.0 ? 1 : 0;
+	}
+	return Summary;
+}
+
+#endif
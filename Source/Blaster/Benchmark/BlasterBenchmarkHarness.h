@@ -0,0 +1,86 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+
+// 사격 벤치마크는 개발용 콘솔 명령이라 쉬핑 빌드에서는 통째로 빠짐
+#define BLASTER_WITH_BENCHMARKS (!UE_BUILD_SHIPPING)
+
+#if BLASTER_WITH_BENCHMARKS
+
+class UWorld;
+
+/**
+ * Sustained fire from N shooters scattered around the world, driven from the core ticker.
+ * Each phase fires for Seconds, waits DrainSeconds for in-flight work to come back and reports;
+ * subclasses decide what a shot is and what each phase (true/false) compares. Only one benchmark runs at a time.
+ */
+class FBlasterBenchmarkHarness : public TSharedFromThis<FBlasterBenchmarkHarness>
+{
+public:
+	virtual ~FBlasterBenchmarkHarness() = default;
+
+	/** Starts the benchmark unless another one is still running */
+	static bool Launch(const TSharedRef<FBlasterBenchmarkHarness>& Benchmark);
+	static bool IsRunning() { return Running.IsValid(); }
+
+	/** "both" runs both phases, TrueMode only the true phase, FalseMode only the false phase */
+	static TArray<bool> ParsePhases(const FString& Mode, const TCHAR* TrueMode, const TCHAR* FalseMode);
+
+protected:
+	FBlasterBenchmarkHarness(UWorld* InWorld, int32 InNumShooters, float InShotsPerSecond, float InSeconds, float InDrainSeconds, int32 InRandomSeed, TArray<bool>&& InPhases);
+
+	struct FFrameSummary
+	{
+		int32 NumFrames{ 0 };
+		double AvgSeconds{ 0.0 };
+		double MaxSeconds{ 0.0 };
+		// 평균의 2배를 넘은 프레임
+		int32 NumSpikes{ 0 };
+	};
+
+	// 벤치마크 대상 서브시스템이 아직 있는지, 없으면 월드가 사라진걸로 보고 멈춤
+	virtual bool IsTargetValid() const = 0;
+	virtual void BeginPhase(bool bPhase) = 0;
+	virtual void Fire(const FVector& Muzzle) = 0;
+	virtual void EndPhase(bool bPhase, const FFrameSummary& Frames) = 0;
+	virtual void OnStart() {}
+	virtual void OnFrame() {}
+	virtual void OnStop() {}
+	virtual const TCHAR* GetName() const = 0;
+
+	UWorld* GetWorld() const { return World.Get(); }
+	int32 GetNumShooters() const { return NumShooters; }
+	float GetShotsPerSecond() const { return ShotsPerSecond; }
+	float GetSeconds() const { return Seconds; }
+	int32 GetNumFrames() const { return FrameTimes.Num(); }
+
+private:
+	void Start();
+	void Stop();
+	bool Tick(float DeltaTime);
+	void StartPhase();
+	FFrameSummary SummarizeFrames() const;
+
+	static TSharedPtr<FBlasterBenchmarkHarness> Running;
+
+	TWeakObjectPtr<UWorld> World;
+	int32 NumShooters{ 0 };
+	float ShotsPerSecond{ 0.f };
+	float Seconds{ 0.f };
+	float DrainSeconds{ 0.f };
+	int32 RandomSeed{ 0 };
+	TArray<bool> Phases;
+	int32 PhaseIndex{ 0 };
+
+	TArray<FVector> Shooters;
+	float Elapsed{ 0.f };
+	float ShotAccumulator{ 0.f };
+	TArray<float> FrameTimes;
+
+	FTSTicker::FDelegateHandle TickerHandle;
+};
+
+#endif
@@ -0,0 +1,124 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Benchmark/BlasterBenchmarkHarness.h"
+#include "Blaster.h"
+#include "Weapon/BlasterHitscanSubsystem.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+#if BLASTER_WITH_BENCHMARKS
+
+namespace BlasterHitscanBenchmark
+{
+	/**
+	 * N 명이 자동 사격 (산탄이면 펠릿 수만큼) 하는 트레이스를 월드에서 돌림
+	 * 비동기 배치와 큐에 넣을때 바로 트레이스하는 동기 방식을 같은 사격으로 비교해서
+	 * 트레이스당 게임 스레드 비용, 프레임 시간, 결과가 오기까지 걸린 프레임 수를 출력
+	 */
+	class FBenchmark : public FBlasterBenchmarkHarness
+	{
+	public:
+		FBenchmark(UWorld* InWorld, int32 InNumShooters, float InShotsPerSecond, int32 InPellets, float InSeconds, TArray<bool>&& InPhases)
+			//남은 결과는 다음 프레임이면 오니 짧게 기다림
+			: FBlasterBenchmarkHarness(InWorld, InNumShooters, InShotsPerSecond, InSeconds, 0.5f, 1234, MoveTemp(InPhases))
+			, Pellets(InPellets)
+		{
+		}
+
+	protected:
+		virtual const TCHAR* GetName() const override { return TEXT("HitscanBench"); }
+
+		virtual bool IsTargetValid() const override
+		{
+			return GetHitscan() != nullptr;
+		}
+
+		virtual void OnStop() override
+		{
+			if (UBlasterHitscanSubsystem* Hitscan = GetHitscan())
+			{
+				Hitscan->SetAsyncEnabled(true);
+			}
+		}
+
+		virtual void BeginPhase(bool bAsync) override
+		{
+			UBlasterHitscanSubsystem* Hitscan = GetHitscan();
+			Hitscan->SetAsyncEnabled(bAsync);
+			Hitscan->ResetStats();
+
+			NumCompleted = 0;
+			LatencyFrames = 0;
+		}
+
+		virtual void Fire(const FVector& Muzzle) override
+		{
+			const FVector Direction = FMath::VRand();
+			Ends.Reset(Pellets);
+			for (int32 Pellet = 0; Pellet < Pellets; ++Pellet)
+			{
+				Ends.Add(Muzzle + FMath::VRandCone(Direction, FMath::DegreesToRadians(5.f)) * 10000.f);
+			}
+			GetHitscan()->QueueVolley(Muzzle, Ends, nullptr, UBlasterHitscanSubsystem::NoRewind,
+				FBlasterHitscanVolleyComplete::CreateSP(this, &FBenchmark::OnVolleyComplete, GFrameCounter));
+		}
+
+		virtual void EndPhase(bool bAsync, const FFrameSummary& Frames) override
+		{
+			const FBlasterHitscanStats& Stats = GetHitscan()->GetStats();
+
+			UE_LOG(LogBlaster, Display, TEXT("HitscanBench [%s] %d shooters x %.1f shots/s x %d pellets for %.1fs: %lld volleys, %lld traces, %lld hits, %lld completed"),
+				bAsync ? TEXT("async") : TEXT("sync"), GetNumShooters(), GetShotsPerSecond(), Pellets, GetSeconds(), Stats.NumVolleys, Stats.NumTraces, Stats.NumHits, NumCompleted);
+			UE_LOG(LogBlaster, Display, TEXT("  game thread %.2f us/trace (%.2f ms/frame), %d traces max per frame, results after %.2f frames avg"),
+				Stats.NumTraces > 0 ? Stats.GameThreadSeconds * 1e6 / Stats.NumTraces : 0.0,
+				Frames.NumFrames > 0 ? Stats.GameThreadSeconds * 1000.0 / Frames.NumFrames : 0.0,
+				Stats.MaxTracesPerFrame,
+				NumCompleted > 0 ? double(LatencyFrames) / NumCompleted : 0.0);
+			UE_LOG(LogBlaster, Display, TEXT("  frame %.2f ms avg / %.2f ms max"), Frames.AvgSeconds * 1000.0, Frames.MaxSeconds * 1000.0);
+		}
+
+	private:
+		UBlasterHitscanSubsystem* GetHitscan() const
+		{
+			UWorld* CurrentWorld = GetWorld();
+			return CurrentWorld ? CurrentWorld->GetSubsystem<UBlasterHitscanSubsystem>() : nullptr;
+		}
+
+		void OnVolleyComplete(TConstArrayView<FHitResult> Hits, uint64 QueuedFrame)
+		{
+			++NumCompleted;
+			LatencyFrames += GFrameCounter - QueuedFrame;
+		}
+
+		int32 Pellets{ 1 };
+		TArray<FVector> Ends;
+		int64 NumCompleted{ 0 };
+		uint64 LatencyFrames{ 0 };
+	};
+}
+
+static FAutoConsoleCommandWithWorldAndArgs BlasterHitscanBenchCommand(
+	TEXT("Blaster.HitscanBench"),
+	TEXT("Sustained hitscan fire from N shooters, batched async traces and/or a synchronous trace per shot. ")
+	TEXT("Reports game thread cost per trace and frame times. Args: [Shooters=16] [ShotsPerSecond=10] [Pellets=1] [Seconds=10] [Mode=both|async|sync]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			if (World == nullptr || World->GetSubsystem<UBlasterHitscanSubsystem>() == nullptr)
+			{
+				UE_LOG(LogBlaster, Warning, TEXT("HitscanBench needs a game world"));
+				return;
+			}
+
+			const int32 NumShooters = FMath::Max(Args.IsValidIndex(0) ? FCString::Atoi(*Args[0]) : 16, 1);
+			const float ShotsPerSecond = FMath::Max(Args.IsValidIndex(1) ? FCString::Atof(*Args[1]) : 10.f, 0.1f);
+			const int32 Pellets = FMath::Max(Args.IsValidIndex(2) ? FCString::Atoi(*Args[2]) : 1, 1);
+			const float Seconds = FMath::Max(Args.IsValidIndex(3) ? FCString::Atof(*Args[3]) : 10.f, 1.f);
+			const FString Mode = Args.IsValidIndex(4) ? Args[4] : TEXT("both");
+
+			FBlasterBenchmarkHarness::Launch(MakeShared<BlasterHitscanBenchmark::FBenchmark>(World, NumShooters, ShotsPerSecond, Pellets, Seconds,
+				FBlasterBenchmarkHarness::ParsePhases(Mode, TEXT("async"), TEXT("sync"))));
+		})
+);
+
+#endif
@@ -0,0 +1,145 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Benchmark/BlasterNetBenchmarkGameMode.h"
+#include "Benchmark/BlasterNetBenchmarkPawn.h"
+#include "Blaster.h"
+#include "ReplicationGraph/BlasterReplicationGraph.h"
+#include "Engine/Engine.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "PlayerState/BlasterPlayerState.h"
+
+ABlasterNetBenchmarkGameMode::ABlasterNetBenchmarkGameMode()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PlayerStateClass = ABlasterPlayerState::StaticClass();
+	//연결마다 ABlasterNetBenchmarkPawn 을 직접 붙임, 기본 Pawn 이 먼저 스폰되면 건너뛰게 됨
+	DefaultPawnClass = nullptr;
+}
+
+void ABlasterNetBenchmarkGameMode::BeginPlay()
+{
+	Super::BeginPlay();
+
+	UWorld* World = GetWorld();
+	if (World == nullptr || World->GetNetDriver() == nullptr)
+	{
+		UE_LOG(LogBlaster, Warning, TEXT("BlasterNetBenchmarkGameMode needs a listen or dedicated server, open the map with ?listen"));
+		return;
+	}
+
+	SpawnSimulatedConnections();
+}
+
+void ABlasterNetBenchmarkGameMode::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	if (BenchmarkPawns.Num() == 0)
+	{
+		return;
+	}
+
+	SpawnProjectiles(DeltaSeconds);
+
+	++ReportFrames;
+	ReportFrameSeconds += DeltaSeconds;
+	ReportMaxFrameSeconds = FMath::Max<double>(ReportMaxFrameSeconds, DeltaSeconds);
+	ReportAccumulator += DeltaSeconds;
+	if (ReportAccumulator >= ReportIntervalSeconds)
+	{
+		Report();
+	}
+}
+
+void ABlasterNetBenchmarkGameMode::SpawnSimulatedConnections()
+{
+	UWorld* World = GetWorld();
+	//넷 드라이버에 패킷을 받기만 하고 전부 ack 하는 연결과 그 PlayerController 를 만듦
+	if (!GEngine->Exec(World, *FString::Printf(TEXT("net.SimulateConnections %d"), NumSimulatedConnections)))
+	{
+		UE_LOG(LogBlaster, Warning, TEXT("net.SimulateConnections is not available in this build, only real clients will be measured"));
+	}
+
+	const FVector ArenaCenter = GetActorLocation();
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController* PlayerController = It->Get();
+		if (PlayerController == nullptr || PlayerController->IsLocalController() || PlayerController->GetPawn())
+		{
+			continue;
+		}
+
+		const FVector2D Offset = FMath::RandPointInCircle(ArenaRadius);
+		ABlasterNetBenchmarkPawn* BenchmarkPawn = World->SpawnActor<ABlasterNetBenchmarkPawn>(ArenaCenter + FVector(Offset.X, Offset.Y, 0.f), FRotator::ZeroRotator, SpawnParams);
+		if (BenchmarkPawn == nullptr)
+		{
+			continue;
+		}
+		PlayerController->Possess(BenchmarkPawn);
+		BenchmarkPawn->StartWandering(ArenaCenter, ArenaRadius, PawnSpeed);
+		BenchmarkPawns.Add(BenchmarkPawn);
+	}
+
+	UE_LOG(LogBlaster, Log, TEXT("Net benchmark started: %d connections, %d pawns, replication graph %s"),
+		World->GetNetDriver()->ClientConnections.Num(), BenchmarkPawns.Num(),
+		Cast<UBlasterReplicationGraph>(World->GetNetDriver()->GetReplicationDriver()) ? TEXT("on") : TEXT("off"));
+}
+
+void ABlasterNetBenchmarkGameMode::SpawnProjectiles(float DeltaSeconds)
+{
+	if (ProjectilesPerSecond <= 0.f)
+	{
+		return;
+	}
+
+	UWorld* World = GetWorld();
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	ProjectileAccumulator += DeltaSeconds * ProjectilesPerSecond;
+	while (ProjectileAccumulator >= 1.f)
+	{
+		ProjectileAccumulator -= 1.f;
+
+		ABlasterNetBenchmarkPawn* Shooter = BenchmarkPawns[FMath::RandHelper(BenchmarkPawns.Num())];
+		if (Shooter == nullptr)
+		{
+			continue;
+		}
+		const FVector Direction = FVector(FMath::RandPointInCircle(1.f), 0.f).GetSafeNormal();
+		ABlasterNetBenchmarkPawn* Projectile = World->SpawnActor<ABlasterNetBenchmarkPawn>(Shooter->GetActorLocation(), Direction.Rotation(), SpawnParams);
+		if (Projectile)
+		{
+			Projectile->StartProjectile(Direction * ProjectileSpeed, ProjectileLifeSeconds);
+			++ReportProjectiles;
+		}
+	}
+}
+
+void ABlasterNetBenchmarkGameMode::Report()
+{
+	UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	const double AvgFrameMs = ReportFrames > 0 ? ReportFrameSeconds * 1000.0 / ReportFrames : 0.0;
+
+	FString ReplicateActors = TEXT("n/a (replication graph off, use stat net)");
+	if (UBlasterReplicationGraph* ReplicationGraph = NetDriver ? Cast<UBlasterReplicationGraph>(NetDriver->GetReplicationDriver()) : nullptr)
+	{
+		double ReplicateSeconds = 0.0;
+		int32 ReplicateFrames = 0;
+		ReplicationGraph->ConsumeReplicateActorsTiming(ReplicateSeconds, ReplicateFrames);
+		ReplicateActors = FString::Printf(TEXT("%.3f ms avg over %d net ticks"), ReplicateFrames > 0 ? ReplicateSeconds * 1000.0 / ReplicateFrames : 0.0, ReplicateFrames);
+	}
+
+	UE_LOG(LogBlaster, Log, TEXT("Net benchmark: %d connections, frame %.2f ms avg / %.2f ms max, %d projectiles, ServerReplicateActors %s"),
+		NetDriver ? NetDriver->ClientConnections.Num() : 0, AvgFrameMs, ReportMaxFrameSeconds * 1000.0, ReportProjectiles, *ReplicateActors);
+
+	ReportAccumulator = 0.f;
+	ReportFrames = 0;
+	ReportFrameSeconds = 0.0;
+	ReportMaxFrameSeconds = 0.0;
+	ReportProjectiles = 0;
+}
@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/GameMode.h"
+#include "BlasterNetBenchmarkGameMode.generated.h"
+
+class ABlasterNetBenchmarkPawn;
+
+/**
+ * 100명 매치 복제 비용 벤치마크
+ * 아무 맵이나 ?listen?game=/Script/Blaster.BlasterNetBenchmarkGameMode 로 열면
+ * net.SimulateConnections 로 가짜 연결을 만들고 연결마다 돌아다니는 Pawn 을 붙이고 발사체 대역을 계속 쏨
+ * ReportIntervalSeconds 마다 프레임 시간과 ServerReplicateActors 시간을 로그로 남김
+ * Blaster.RepGraph.Enable 0 으로 같은 맵을 열면 기존 복제와 비교할 수 있음
+ */
+UCLASS(Config = Game)
+class BLASTER_API ABlasterNetBenchmarkGameMode : public AGameMode
+{
+	GENERATED_BODY()
+public:
+	ABlasterNetBenchmarkGameMode();
+
+	virtual void BeginPlay() override;
+	virtual void Tick(float DeltaSeconds) override;
+
+protected:
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Benchmark")
+	int32 NumSimulatedConnections{ 100 };
+
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Benchmark")
+	float ArenaRadius{ 20000.f };
+
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Benchmark")
+	float PawnSpeed{ 600.f };
+
+	// 초당 발사체 대역 스폰 수, 0 이면 쏘지 않음
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Benchmark")
+	float ProjectilesPerSecond{ 50.f };
+
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Benchmark")
+	float ProjectileSpeed{ 5000.f };
+
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Benchmark")
+	float ProjectileLifeSeconds{ 2.f };
+
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Benchmark")
+	float ReportIntervalSeconds{ 5.f };
+
+private:
+	void SpawnSimulatedConnections();
+	void SpawnProjectiles(float DeltaSeconds);
+	void Report();
+
+	UPROPERTY(Transient)
+	TArray<ABlasterNetBenchmarkPawn*> BenchmarkPawns;
+
+	float ProjectileAccumulator{ 0.f };
+	float ReportAccumulator{ 0.f };
+	int32 ReportFrames{ 0 };
+	double ReportFrameSeconds{ 0.0 };
+	double ReportMaxFrameSeconds{ 0.0 };
+	int32 ReportProjectiles{ 0 };
+};
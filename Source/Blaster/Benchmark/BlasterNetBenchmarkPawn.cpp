@@ -0,0 +1,56 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Benchmark/BlasterNetBenchmarkPawn.h"
+#include "Components/SceneComponent.h"
+
+ABlasterNetBenchmarkPawn::ABlasterNetBenchmarkPawn()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+	RootComponent->SetMobility(EComponentMobility::Movable);
+
+	bReplicates = true;
+	SetReplicateMovement(true);
+	NetUpdateFrequency = 30.f;
+	SetNetCullDistanceSquared(FMath::Square(15000.f));
+}
+
+void ABlasterNetBenchmarkPawn::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	if (bWandering && FVector::DistSquared2D(GetActorLocation(), WanderTarget) < FMath::Square(Speed * DeltaSeconds + 1.f))
+	{
+		PickWanderTarget();
+	}
+	SetActorLocation(GetActorLocation() + Velocity * DeltaSeconds);
+}
+
+void ABlasterNetBenchmarkPawn::StartWandering(const FVector& InArenaCenter, float InArenaRadius, float InSpeed)
+{
+	ArenaCenter = InArenaCenter;
+	ArenaRadius = InArenaRadius;
+	Speed = InSpeed;
+	bWandering = true;
+	PickWanderTarget();
+}
+
+void ABlasterNetBenchmarkPawn::StartProjectile(const FVector& InVelocity, float LifeSeconds)
+{
+	Velocity = InVelocity;
+	bWandering = false;
+	SetLifeSpan(LifeSeconds);
+}
+
+void ABlasterNetBenchmarkPawn::PickWanderTarget()
+{
+	const FVector2D Offset = FMath::RandPointInCircle(ArenaRadius);
+	WanderTarget = ArenaCenter + FVector(Offset.X, Offset.Y, 0.f);
+	Velocity = (WanderTarget - GetActorLocation()).GetSafeNormal2D() * Speed;
+}
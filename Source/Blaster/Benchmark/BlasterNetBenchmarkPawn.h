@@ -0,0 +1,34 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Pawn.h"
+#include "BlasterNetBenchmarkPawn.generated.h"
+
+/**
+ * 넷 벤치마크용 대역 액터. 서버에서만 움직이고 위치만 복제됨
+ * 캐릭터 대역은 아레나 안을 돌아다니고, 발사체 대역은 직선으로 날아가다 수명이 끝나면 사라짐
+ */
+UCLASS(NotBlueprintable)
+class BLASTER_API ABlasterNetBenchmarkPawn : public APawn
+{
+	GENERATED_BODY()
+public:
+	ABlasterNetBenchmarkPawn();
+
+	virtual void Tick(float DeltaSeconds) override;
+
+	void StartWandering(const FVector& InArenaCenter, float InArenaRadius, float InSpeed);
+	void StartProjectile(const FVector& InVelocity, float LifeSeconds);
+
+private:
+	void PickWanderTarget();
+
+	FVector ArenaCenter{ FVector::ZeroVector };
+	FVector WanderTarget{ FVector::ZeroVector };
+	FVector Velocity{ FVector::ZeroVector };
+	float ArenaRadius{ 0.f };
+	float Speed{ 0.f };
+	bool bWandering{ false };
+};
@@ -0,0 +1,156 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Benchmark/BlasterBenchmarkHarness.h"
+#include "Blaster.h"
+#include "Pool/BlasterActorPoolSubsystem.h"
+#include "Weapon/BlasterImpactEffect.h"
+#include "Weapon/BlasterProjectile.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectArray.h"
+#include "UObject/UObjectGlobals.h"
+
+#if BLASTER_WITH_BENCHMARKS
+
+namespace BlasterPoolBenchmark
+{
+	/**
+	 * N 명이 계속 자동 사격하는 상황을 월드에서 돌림
+	 * 풀링 켜고/끄고 같은 사격을 하면서 발사체를 꺼내는 비용, GC, 프레임 시간 튐을 비교
+	 */
+	class FBenchmark : public FBlasterBenchmarkHarness
+	{
+	public:
+		FBenchmark(UWorld* InWorld, int32 InNumPlayers, float InShotsPerSecond, float InSeconds, TArray<bool>&& InPhases)
+			//발사체 수명과 충돌 이펙트가 전부 돌아올때까지 6초
+			: FBlasterBenchmarkHarness(InWorld, InNumPlayers, InShotsPerSecond, InSeconds, 6.f, 4321, MoveTemp(InPhases))
+		{
+		}
+
+	protected:
+		virtual const TCHAR* GetName() const override { return TEXT("PoolBench"); }
+
+		virtual bool IsTargetValid() const override
+		{
+			return GetPool() != nullptr;
+		}
+
+		virtual void OnStart() override
+		{
+			PreGCHandle = FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddSP(this, &FBenchmark::OnPreGarbageCollect);
+			PostGCHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddSP(this, &FBenchmark::OnPostGarbageCollect);
+		}
+
+		virtual void OnStop() override
+		{
+			FCoreUObjectDelegates::GetPreGarbageCollectDelegate().Remove(PreGCHandle);
+			FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGCHandle);
+			if (UBlasterActorPoolSubsystem* Pool = GetPool())
+			{
+				Pool->SetPoolingEnabled(true);
+			}
+		}
+
+		virtual void BeginPhase(bool bPooled) override
+		{
+			UBlasterActorPoolSubsystem* Pool = GetPool();
+			Pool->SetPoolingEnabled(bPooled);
+			if (bPooled)
+			{
+				//한번에 날아다니는 수만큼 미리 채움, 채우는 비용은 재지 않음. 풀 상한을 넘는 만큼은 어차피 스폰됨
+				const int32 InFlight = FMath::Min(FMath::CeilToInt(GetNumShooters() * GetShotsPerSecond() * 3.5f) + 16, Pool->GetMaxPooledPerClass());
+				Pool->Prewarm(ABlasterProjectile::StaticClass(), InFlight);
+				Pool->Prewarm(ABlasterImpactEffect::StaticClass(), InFlight);
+			}
+			Pool->ResetStats();
+
+			NumGC = 0;
+			GCSeconds = 0.0;
+			StartObjects = GUObjectArray.GetObjectArrayNumMinusAvailable();
+			PeakObjects = StartObjects;
+		}
+
+		virtual void OnFrame() override
+		{
+			PeakObjects = FMath::Max(PeakObjects, GUObjectArray.GetObjectArrayNumMinusAvailable());
+		}
+
+		virtual void Fire(const FVector& Muzzle) override
+		{
+			const FVector Direction = FVector(FMath::RandPointInCircle(1.f), 0.f).GetSafeNormal();
+			GetPool()->AcquireActor(ABlasterProjectile::StaticClass(), Muzzle, Direction.IsNearlyZero() ? FVector::ForwardVector : Direction);
+		}
+
+		virtual void EndPhase(bool bPooled, const FFrameSummary& Frames) override
+		{
+			const FBlasterActorPoolStats& Stats = GetPool()->GetStats();
+
+			//이번 단계가 남긴 쓰레기를 치우는 비용
+			const double CleanupStart = FPlatformTime::Seconds();
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+			const double CleanupMs = (FPlatformTime::Seconds() - CleanupStart) * 1000.0;
+
+			UE_LOG(LogBlaster, Display, TEXT("PoolBench [%s] %d players x %.1f shots/s for %.1fs: %lld shots, %lld spawned, %lld destroyed"),
+				bPooled ? TEXT("pooled") : TEXT("spawn"), GetNumShooters(), GetShotsPerSecond(), GetSeconds(), Stats.NumAcquired, Stats.NumSpawned, Stats.NumDestroyed);
+			UE_LOG(LogBlaster, Display, TEXT("  acquire %.2f us avg / %.3f ms max, release %.2f us avg"),
+				Stats.NumAcquired > 0 ? Stats.AcquireSeconds * 1e6 / Stats.NumAcquired : 0.0, Stats.MaxAcquireSeconds * 1000.0,
+				Stats.NumReleased > 0 ? Stats.ReleaseSeconds * 1e6 / Stats.NumReleased : 0.0);
+			UE_LOG(LogBlaster, Display, TEXT("  GC: %d runs %.2f ms during, +%d UObjects peak, cleanup %.2f ms"),
+				NumGC, GCSeconds * 1000.0, PeakObjects - StartObjects, CleanupMs);
+			UE_LOG(LogBlaster, Display, TEXT("  frame %.2f ms avg / %.2f ms max, %d frames over 2x avg"),
+				Frames.AvgSeconds * 1000.0, Frames.MaxSeconds * 1000.0, Frames.NumSpikes);
+		}
+
+	private:
+		UBlasterActorPoolSubsystem* GetPool() const
+		{
+			UWorld* CurrentWorld = GetWorld();
+			return CurrentWorld ? CurrentWorld->GetSubsystem<UBlasterActorPoolSubsystem>() : nullptr;
+		}
+
+		void OnPreGarbageCollect()
+		{
+			GCStartTime = FPlatformTime::Seconds();
+		}
+
+		void OnPostGarbageCollect()
+		{
+			++NumGC;
+			GCSeconds += FPlatformTime::Seconds() - GCStartTime;
+		}
+
+		int32 NumGC{ 0 };
+		double GCStartTime{ 0.0 };
+		double GCSeconds{ 0.0 };
+		int32 StartObjects{ 0 };
+		int32 PeakObjects{ 0 };
+
+		FDelegateHandle PreGCHandle;
+		FDelegateHandle PostGCHandle;
+	};
+}
+
+static FAutoConsoleCommandWithWorldAndArgs BlasterPoolBenchCommand(
+	TEXT("Blaster.PoolBench"),
+	TEXT("Sustained automatic fire from N players on the server, pooled and/or with SpawnActor/Destroy. ")
+	TEXT("Reports acquire cost, GC and frame time spikes. Args: [Players=16] [ShotsPerSecond=10] [Seconds=10] [Mode=both|pooled|spawn]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			if (World == nullptr || World->GetNetMode() == NM_Client || World->GetSubsystem<UBlasterActorPoolSubsystem>() == nullptr)
+			{
+				UE_LOG(LogBlaster, Warning, TEXT("PoolBench needs a game world running as server or standalone"));
+				return;
+			}
+
+			const int32 NumPlayers = FMath::Max(Args.IsValidIndex(0) ? FCString::Atoi(*Args[0]) : 16, 1);
+			const float ShotsPerSecond = FMath::Max(Args.IsValidIndex(1) ? FCString::Atof(*Args[1]) : 10.f, 0.1f);
+			const float Seconds = FMath::Max(Args.IsValidIndex(2) ? FCString::Atof(*Args[2]) : 10.f, 1.f);
+			const FString Mode = Args.IsValidIndex(3) ? Args[3] : TEXT("both");
+
+			FBlasterBenchmarkHarness::Launch(MakeShared<BlasterPoolBenchmark::FBenchmark>(World, NumPlayers, ShotsPerSecond, Seconds,
+				FBlasterBenchmarkHarness::ParsePhases(Mode, TEXT("pooled"), TEXT("spawn"))));
+		})
+);
+
+#endif
@@ -3,4 +3,6 @@
 #include "Blaster.h"
 #include "Modules/ModuleManager.h"
 
+DEFINE_LOG_CATEGORY(LogBlaster);
+
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, Blaster, "Blaster" );
@@ -3,4 +3,8 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Stats/Stats.h"
 
+DECLARE_LOG_CATEGORY_EXTERN(LogBlaster, Log, All);
+
+DECLARE_STATS_GROUP(TEXT("BlasterNet"), STATGROUP_BlasterNet, STATCAT_Advanced);
@@ -0,0 +1,12 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GameMode/BlasterGameMode.h"
+#include "PlayerState/BlasterPlayerState.h"
+
+ABlasterGameMode::ABlasterGameMode()
+{
+	PlayerStateClass = ABlasterPlayerState::StaticClass();
+	//매치가 끝나고 로비로 돌아갈때도 재접속 없이 이동
+	bUseSeamlessTravel = true;
+}
@@ -0,0 +1,18 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/GameMode.h"
+#include "BlasterGameMode.generated.h"
+
+/**
+ * 매치 맵 게임모드. 로비와 같은 PlayerState 클래스를 써야 심리스 트래블때 로드아웃이 복사됨
+ */
+UCLASS()
+class BLASTER_API ABlasterGameMode : public AGameMode
+{
+	GENERATED_BODY()
+public:
+	ABlasterGameMode();
+};
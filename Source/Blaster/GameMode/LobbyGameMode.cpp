@@ -0,0 +1,41 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GameMode/LobbyGameMode.h"
+#include "GameFramework/GameStateBase.h"
+#include "PlayerState/BlasterPlayerState.h"
+
+ALobbyGameMode::ALobbyGameMode()
+{
+	PlayerStateClass = ABlasterPlayerState::StaticClass();
+	//연결을 끊고 다시 붙지 않고 커넥션, 컨트롤러, PlayerState 를 그대로 가져감
+	bUseSeamlessTravel = true;
+}
+
+void ALobbyGameMode::PostLogin(APlayerController* NewPlayer)
+{
+	Super::PostLogin(NewPlayer);
+
+	if (PlayersToStartMatch <= 0 || GameState == nullptr)
+	{
+		return;
+	}
+
+	const int32 NumberOfPlayers = GameState->PlayerArray.Num();
+	if (NumberOfPlayers >= PlayersToStartMatch)
+	{
+		TravelToMatch();
+	}
+}
+
+void ALobbyGameMode::TravelToMatch()
+{
+	UWorld* World = GetWorld();
+	if (World == nullptr || bTravelStarted)
+	{
+		return;
+	}
+	bTravelStarted = true;
+
+	World->ServerTravel(FString::Printf(TEXT("%s?listen"), *MatchMapPath));
+}
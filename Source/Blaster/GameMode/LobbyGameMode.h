@@ -0,0 +1,35 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/GameMode.h"
+#include "LobbyGameMode.generated.h"
+
+/**
+ * 인원이 모이면 모든 플레이어를 한번의 심리스 트래블로 매치 맵에 옮김
+ * 트랜지션 맵은 DefaultEngine.ini 의 TransitionMap 을 사용
+ */
+UCLASS(Config = Game)
+class BLASTER_API ALobbyGameMode : public AGameMode
+{
+	GENERATED_BODY()
+public:
+	ALobbyGameMode();
+
+	virtual void PostLogin(APlayerController* NewPlayer) override;
+
+	UFUNCTION(BlueprintCallable)
+	void TravelToMatch();
+
+protected:
+	UPROPERTY(Config, EditDefaultsOnly)
+	FString MatchMapPath{ TEXT("/Game/ThirdPerson/Maps/ThirdPersonMap") };
+
+	// 0 이면 자동으로 출발하지 않음 (TravelToMatch 직접 호출)
+	UPROPERTY(Config, EditDefaultsOnly)
+	int32 PlayersToStartMatch{ 2 };
+
+private:
+	bool bTravelStarted{ false };
+};
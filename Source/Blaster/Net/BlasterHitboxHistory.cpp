@@ -0,0 +1,397 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Net/BlasterHitboxHistory.h"
+#include "Blaster.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/VectorRegister.h"
+
+void FBlasterHitboxHistory::Init(int32 InMaxSlots, int32 InNumFrames)
+{
+	MaxSlots = FMath::Max(InMaxSlots, 1);
+	SlotStride = Align(MaxSlots, 4);
+	NumFrames = FMath::Max(InNumFrames, 2);
+
+	const int32 NumValues = SlotStride * NumFrames;
+	Timestamps.SetNumZeroed(NumFrames);
+	CenterX.SetNumZeroed(NumValues);
+	CenterY.SetNumZeroed(NumValues);
+	CenterZ.SetNumZeroed(NumValues);
+	HalfSegment.SetNumZeroed(NumValues);
+	Radius.SetNumZeroed(NumValues);
+
+	RewoundX.SetNumZeroed(SlotStride);
+	RewoundY.SetNumZeroed(SlotStride);
+	RewoundZ.SetNumZeroed(SlotStride);
+	RewoundHalfSegment.SetNumZeroed(SlotStride);
+	RewoundRadius.SetNumZeroed(SlotStride);
+
+	Reset();
+}
+
+void FBlasterHitboxHistory::Reset()
+{
+	Head = INDEX_NONE;
+	NumRecorded = 0;
+	ActiveLanes = 0;
+	FMemory::Memzero(Radius.GetData(), Radius.Num() * sizeof(float));
+	FMemory::Memzero(RewoundRadius.GetData(), RewoundRadius.Num() * sizeof(float));
+}
+
+double FBlasterHitboxHistory::GetOldestTimestamp() const
+{
+	return NumRecorded > 0 ? Timestamps[GetFrameIndex(0)] : 0.0;
+}
+
+double FBlasterHitboxHistory::GetNewestTimestamp() const
+{
+	return NumRecorded > 0 ? Timestamps[Head] : 0.0;
+}
+
+void FBlasterHitboxHistory::BeginFrame(double Timestamp)
+{
+	if (!IsInitialized())
+	{
+		return;
+	}
+
+	Head = (Head + 1) % NumFrames;
+	NumRecorded = FMath::Min(NumRecorded + 1, NumFrames);
+	Timestamps[Head] = Timestamp;
+	//가장 오래된 프레임을 덮어씀, 반지름을 0 으로 두면 이번에 안 쓴 슬롯은 빈 슬롯
+	FMemory::Memzero(&Radius[Head * SlotStride], SlotStride * sizeof(float));
+}
+
+void FBlasterHitboxHistory::WriteSlot(int32 Slot, const FVector& Center, float HalfHeight, float InRadius)
+{
+	if (Head == INDEX_NONE || Slot < 0 || Slot >= MaxSlots)
+	{
+		return;
+	}
+
+	const int32 Index = Head * SlotStride + Slot;
+	CenterX[Index] = Center.X;
+	CenterY[Index] = Center.Y;
+	CenterZ[Index] = Center.Z;
+	//0 이면 구가 되어 판정식이 0 으로 나누게 되므로 최소 길이를 둠
+	HalfSegment[Index] = FMath::Max(HalfHeight - InRadius, 1.f);
+	Radius[Index] = InRadius;
+	ActiveLanes = FMath::Max(ActiveLanes, Align(Slot + 1, 4));
+}
+
+void FBlasterHitboxHistory::ClearSlot(int32 Slot)
+{
+	if (Slot < 0 || Slot >= MaxSlots)
+	{
+		return;
+	}
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		Radius[Frame * SlotStride + Slot] = 0.f;
+	}
+	RewoundRadius[Slot] = 0.f;
+}
+
+bool FBlasterHitboxHistory::Rewind(double Timestamp)
+{
+	if (NumRecorded == 0)
+	{
+		return false;
+	}
+
+	//Timestamp 이상인 첫 프레임
+	int32 Low = 0;
+	int32 High = NumRecorded;
+	while (Low < High)
+	{
+		const int32 Mid = (Low + High) / 2;
+		if (Timestamps[GetFrameIndex(Mid)] < Timestamp)
+		{
+			Low = Mid + 1;
+		}
+		else
+		{
+			High = Mid;
+		}
+	}
+
+	if (Low == NumRecorded)
+	{
+		CopyFrame(Head);
+	}
+	else if (Low == 0)
+	{
+		CopyFrame(GetFrameIndex(0));
+	}
+	else
+	{
+		const int32 FrameA = GetFrameIndex(Low - 1);
+		const int32 FrameB = GetFrameIndex(Low);
+		const double Span = Timestamps[FrameB] - Timestamps[FrameA];
+		const float Alpha = Span > 0.0 ? static_cast<float>((Timestamp - Timestamps[FrameA]) / Span) : 1.f;
+		LerpFrames(FrameA, FrameB, Alpha);
+	}
+	return true;
+}
+
+void FBlasterHitboxHistory::CopyFrame(int32 Frame)
+{
+	const int32 Offset = Frame * SlotStride;
+	const SIZE_T NumBytes = ActiveLanes * sizeof(float);
+	FMemory::Memcpy(RewoundX.GetData(), &CenterX[Offset], NumBytes);
+	FMemory::Memcpy(RewoundY.GetData(), &CenterY[Offset], NumBytes);
+	FMemory::Memcpy(RewoundZ.GetData(), &CenterZ[Offset], NumBytes);
+	FMemory::Memcpy(RewoundHalfSegment.GetData(), &HalfSegment[Offset], NumBytes);
+	FMemory::Memcpy(RewoundRadius.GetData(), &Radius[Offset], NumBytes);
+}
+
+void FBlasterHitboxHistory::LerpFrames(int32 FrameA, int32 FrameB, float InAlpha)
+{
+	const VectorRegister4Float Alpha = VectorSetFloat1(InAlpha);
+	auto Lerp = [&Alpha](const float* A, const float* B)
+	{
+		const VectorRegister4Float VecA = VectorLoadAligned(A);
+		return VectorMultiplyAdd(VectorSubtract(VectorLoadAligned(B), VecA), Alpha, VecA);
+	};
+
+	const int32 OffsetA = FrameA * SlotStride;
+	const int32 OffsetB = FrameB * SlotStride;
+	for (int32 Lane = 0; Lane < ActiveLanes; Lane += 4)
+	{
+		const int32 A = OffsetA + Lane;
+		const int32 B = OffsetB + Lane;
+		VectorStoreAligned(Lerp(&CenterX[A], &CenterX[B]), &RewoundX[Lane]);
+		VectorStoreAligned(Lerp(&CenterY[A], &CenterY[B]), &RewoundY[Lane]);
+		VectorStoreAligned(Lerp(&CenterZ[A], &CenterZ[B]), &RewoundZ[Lane]);
+		VectorStoreAligned(Lerp(&HalfSegment[A], &HalfSegment[B]), &RewoundHalfSegment[Lane]);
+		//한쪽 프레임에만 있던 슬롯은 0 이 되어 판정에서 빠짐
+		VectorStoreAligned(VectorMin(VectorLoadAligned(&Radius[A]), VectorLoadAligned(&Radius[B])), &RewoundRadius[Lane]);
+	}
+}
+
+int32 FBlasterHitboxHistory::Raycast(const FVector& Start, const FVector& End, int32 IgnoreSlot, FVector& OutLocation, float& OutTime) const
+{
+	const FVector3f RayDir(End - Start);
+	const float DirDot = RayDir.SizeSquared();
+	if (ActiveLanes == 0 || DirDot < UE_KINDA_SMALL_NUMBER)
+	{
+		return INDEX_NONE;
+	}
+
+	const VectorRegister4Float Zero = VectorZeroFloat();
+	const VectorRegister4Float One = VectorOneFloat();
+	const VectorRegister4Float Epsilon = VectorSetFloat1(UE_KINDA_SMALL_NUMBER);
+	const VectorRegister4Float StartX = VectorSetFloat1(static_cast<float>(Start.X));
+	const VectorRegister4Float StartY = VectorSetFloat1(static_cast<float>(Start.Y));
+	const VectorRegister4Float StartZ = VectorSetFloat1(static_cast<float>(Start.Z));
+	const VectorRegister4Float DirX = VectorSetFloat1(RayDir.X);
+	const VectorRegister4Float DirY = VectorSetFloat1(RayDir.Y);
+	const VectorRegister4Float DirZ = VectorSetFloat1(RayDir.Z);
+	const VectorRegister4Float VecA = VectorSetFloat1(DirDot);
+
+	int32 BestSlot = INDEX_NONE;
+	float BestTime = UE_BIG_NUMBER;
+	for (int32 Lane = 0; Lane < ActiveLanes; Lane += 4)
+	{
+		//선분-선분 최근접점 (Real-Time Collision Detection 5.1.9), 캡슐 중심선은 Z 축과 평행
+		//R = Start - 캡슐 중심선 아래 끝, D2 = (0, 0, 2 * HalfSegment)
+		const VectorRegister4Float Half = VectorLoadAligned(&RewoundHalfSegment[Lane]);
+		const VectorRegister4Float Rad = VectorLoadAligned(&RewoundRadius[Lane]);
+		const VectorRegister4Float Seg = VectorAdd(Half, Half);
+		const VectorRegister4Float RX = VectorSubtract(StartX, VectorLoadAligned(&RewoundX[Lane]));
+		const VectorRegister4Float RY = VectorSubtract(StartY, VectorLoadAligned(&RewoundY[Lane]));
+		const VectorRegister4Float RZ = VectorAdd(VectorSubtract(StartZ, VectorLoadAligned(&RewoundZ[Lane])), Half);
+
+		const VectorRegister4Float E = VectorMultiply(Seg, Seg);
+		const VectorRegister4Float F = VectorMultiply(Seg, RZ);
+		const VectorRegister4Float C = VectorMultiplyAdd(DirX, RX, VectorMultiplyAdd(DirY, RY, VectorMultiply(DirZ, RZ)));
+		const VectorRegister4Float B = VectorMultiply(Seg, DirZ);
+		const VectorRegister4Float Denom = VectorSubtract(VectorMultiply(VecA, E), VectorMultiply(B, B));
+
+		//수직으로 쏜 경우(평행)는 레이 시작점에서 시작
+		const VectorRegister4Float SNum = VectorSubtract(VectorMultiply(B, F), VectorMultiply(C, E));
+		VectorRegister4Float S = VectorMin(VectorMax(VectorDivide(SNum, VectorMax(Denom, Epsilon)), Zero), One);
+		S = VectorSelect(VectorCompareGT(Denom, Epsilon), S, Zero);
+
+		const VectorRegister4Float T = VectorDivide(VectorMultiplyAdd(B, S, F), E);
+		const VectorRegister4Float TClamped = VectorMin(VectorMax(T, Zero), One);
+		const VectorRegister4Float SAlt = VectorMin(VectorMax(VectorDivide(VectorSubtract(VectorMultiply(B, TClamped), C), VecA), Zero), One);
+		S = VectorSelect(VectorCompareNE(T, TClamped), SAlt, S);
+
+		const VectorRegister4Float DX = VectorMultiplyAdd(S, DirX, RX);
+		const VectorRegister4Float DY = VectorMultiplyAdd(S, DirY, RY);
+		const VectorRegister4Float DZ = VectorSubtract(VectorMultiplyAdd(S, DirZ, RZ), VectorMultiply(TClamped, Seg));
+		const VectorRegister4Float DistSquared = VectorMultiplyAdd(DX, DX, VectorMultiplyAdd(DY, DY, VectorMultiply(DZ, DZ)));
+
+		const VectorRegister4Float HitMask = VectorBitwiseAnd(VectorCompareLE(DistSquared, VectorMultiply(Rad, Rad)), VectorCompareGT(Rad, Zero));
+		int32 HitBits = VectorMaskBits(HitMask);
+		if (HitBits == 0)
+		{
+			continue;
+		}
+
+		//맞은 캡슐만 스칼라로 표면에 들어간 점을 구함, 최근접점 순서로는 가까운 큰 캡슐보다 먼 작은 캡슐이 앞설 수 있음
+		alignas(16) float Times[4];
+		VectorStoreAligned(S, Times);
+		while (HitBits)
+		{
+			const int32 LaneOffset = FMath::CountTrailingZeros(static_cast<uint32>(HitBits));
+			HitBits &= HitBits - 1;
+			const int32 Slot = Lane + LaneOffset;
+			if (Slot == IgnoreSlot)
+			{
+				continue;
+			}
+			const float EntryTime = GetEntryTime(Slot, FVector3f(Start), RayDir, Times[LaneOffset]);
+			if (EntryTime < BestTime)
+			{
+				BestTime = EntryTime;
+				BestSlot = Slot;
+			}
+		}
+	}
+
+	if (BestSlot != INDEX_NONE)
+	{
+		OutTime = BestTime;
+		OutLocation = Start + (End - Start) * BestTime;
+	}
+	return BestSlot;
+}
+
+float FBlasterHitboxHistory::GetEntryTime(int32 Slot, const FVector3f& Start, const FVector3f& Dir, float MaxTime) const
+{
+	const FVector3f Center(RewoundX[Slot], RewoundY[Slot], RewoundZ[Slot]);
+	const float Half = RewoundHalfSegment[Slot];
+	const float Rad = RewoundRadius[Slot];
+	const float RadSquared = Rad * Rad;
+
+	//시작점이 캡슐 안
+	const FVector3f ToStart = Start - Center;
+	const FVector3f ToAxis(ToStart.X, ToStart.Y, ToStart.Z - FMath::Clamp(ToStart.Z, -Half, Half));
+	if (ToAxis.SizeSquared() <= RadSquared)
+	{
+		return 0.f;
+	}
+
+	//원기둥 옆면과 위아래 구에 들어가는 점 중 가장 앞선 것, 구의 진입점이 캡슐 안쪽이면 그보다 앞선 후보가 항상 있음
+	float Entry = MaxTime;
+	auto Consider = [&Entry](float Time)
+	{
+		if (Time >= 0.f && Time < Entry)
+		{
+			Entry = Time;
+		}
+	};
+
+	const float PlanarA = Dir.X * Dir.X + Dir.Y * Dir.Y;
+	if (PlanarA > UE_KINDA_SMALL_NUMBER)
+	{
+		const float PlanarB = ToStart.X * Dir.X + ToStart.Y * Dir.Y;
+		const float PlanarC = ToStart.X * ToStart.X + ToStart.Y * ToStart.Y - RadSquared;
+		const float Discriminant = PlanarB * PlanarB - PlanarA * PlanarC;
+		if (Discriminant >= 0.f)
+		{
+			const float Time = (-PlanarB - FMath::Sqrt(Discriminant)) / PlanarA;
+			if (FMath::Abs(ToStart.Z + Dir.Z * Time) <= Half)
+			{
+				Consider(Time);
+			}
+		}
+	}
+
+	const float DirDot = Dir.SizeSquared();
+	for (const float CapZ : { -Half, Half })
+	{
+		const FVector3f ToCap(ToStart.X, ToStart.Y, ToStart.Z - CapZ);
+		const float SphereB = ToCap | Dir;
+		const float Discriminant = SphereB * SphereB - DirDot * (ToCap.SizeSquared() - RadSquared);
+		if (Discriminant >= 0.f)
+		{
+			Consider((-SphereB - FMath::Sqrt(Discriminant)) / DirDot);
+		}
+	}
+	return Entry;
+}
+
+#if !UE_BUILD_SHIPPING
+
+// 월드 없이 캐릭터 궤적을 만들어 기록 + 되감기 + 판정 비용을 잼
+static FAutoConsoleCommand BlasterLagCompensationBenchCommand(
+	TEXT("Blaster.LagCompBench"),
+	TEXT("Records synthetic character hitboxes and confirms rewound shots against them. Args: [NumCharacters=100] [ShotsPerFrame=200] [Frames=600] [HistoryFrames=64]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			const int32 NumCharacters = FMath::Max(Args.IsValidIndex(0) ? FCString::Atoi(*Args[0]) : 100, 2);
+			const int32 ShotsPerFrame = Args.IsValidIndex(1) ? FCString::Atoi(*Args[1]) : 200;
+			const int32 NumBenchFrames = Args.IsValidIndex(2) ? FCString::Atoi(*Args[2]) : 600;
+			const int32 HistoryFrames = Args.IsValidIndex(3) ? FCString::Atoi(*Args[3]) : 64;
+			constexpr double FrameSeconds = 1.0 / 60.0;
+			constexpr float HalfHeight = 88.f;
+			constexpr float CapsuleRadius = 34.f;
+
+			FBlasterHitboxHistory History;
+			History.Init(NumCharacters, HistoryFrames);
+
+			FRandomStream Random(1234);
+			TArray<FVector4f> Orbits;
+			Orbits.Reserve(NumCharacters);
+			for (int32 Index = 0; Index < NumCharacters; ++Index)
+			{
+				Orbits.Emplace(Random.FRandRange(-10000.f, 10000.f), Random.FRandRange(-10000.f, 10000.f), Random.FRandRange(200.f, 2000.f), Random.FRandRange(0.f, UE_TWO_PI));
+			}
+			auto GetLocation = [&Orbits](int32 Index, double Time)
+			{
+				const FVector4f& Orbit = Orbits[Index];
+				const float Angle = Orbit.W + static_cast<float>(Time) * 600.f / Orbit.Z;
+				return FVector(Orbit.X + Orbit.Z * FMath::Cos(Angle), Orbit.Y + Orbit.Z * FMath::Sin(Angle), 100.f);
+			};
+
+			double RecordSeconds = 0.0;
+			double ConfirmSeconds = 0.0;
+			double MaxFrameSeconds = 0.0;
+			int64 NumShots = 0;
+			int64 NumHits = 0;
+			for (int32 Frame = 0; Frame < NumBenchFrames; ++Frame)
+			{
+				const double Now = Frame * FrameSeconds;
+				const double FrameStart = FPlatformTime::Seconds();
+				History.BeginFrame(Now);
+				for (int32 Index = 0; Index < NumCharacters; ++Index)
+				{
+					History.WriteSlot(Index, GetLocation(Index, Now), HalfHeight, CapsuleRadius);
+				}
+				const double RecordEnd = FPlatformTime::Seconds();
+				RecordSeconds += RecordEnd - FrameStart;
+
+				for (int32 Shot = 0; Shot < ShotsPerFrame; ++Shot)
+				{
+					//최대 200ms 전 시점에 보였던 위치를 조준한 샷
+					const double ShotTime = FMath::Max(Now - Random.FRandRange(0.f, 0.2f), History.GetOldestTimestamp());
+					const int32 Shooter = Random.RandHelper(NumCharacters);
+					const int32 Target = (Shooter + 1 + Random.RandHelper(NumCharacters - 1)) % NumCharacters;
+					const FVector Start = GetLocation(Shooter, ShotTime);
+					const FVector Aim = GetLocation(Target, ShotTime) + FVector(0.f, 0.f, Random.FRandRange(-60.f, 60.f));
+					const FVector End = Start + (Aim - Start).GetSafeNormal() * 50000.f;
+
+					FVector HitLocation;
+					float HitTime = 0.f;
+					History.Rewind(ShotTime);
+					NumHits += History.Raycast(Start, End, Shooter, HitLocation, HitTime) != INDEX_NONE ? 1 : 0;
+					++NumShots;
+				}
+				const double FrameEnd = FPlatformTime::Seconds();
+				ConfirmSeconds += FrameEnd - RecordEnd;
+				MaxFrameSeconds = FMath::Max(MaxFrameSeconds, FrameEnd - FrameStart);
+			}
+
+			UE_LOG(LogBlaster, Display, TEXT("LagCompBench: %d characters, %d frames of history, %lld shots"), NumCharacters, HistoryFrames, NumShots);
+			UE_LOG(LogBlaster, Display, TEXT("  record %.3f us/frame, confirm %.3f us/shot, worst frame %.3f ms, hit rate %.1f%%"),
+				NumBenchFrames > 0 ? RecordSeconds * 1e6 / NumBenchFrames : 0.0,
+				NumShots > 0 ? ConfirmSeconds * 1e6 / NumShots : 0.0,
+				MaxFrameSeconds * 1000.0,
+				NumShots > 0 ? 100.0 * NumHits / NumShots : 0.0);
+		})
+);
+
+#endif
@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * 캐릭터 히트박스(세로 캡슐) 기록을 고정 크기 링 버퍼에 SoA 로 저장
+ * 값마다 [Frame * SlotStride + Slot] 로 연속 배치해서 되감기 보간과 레이 판정을
+ * 캐릭터 4명씩 SIMD 로 처리함. Init 이후에는 메모리를 새로 잡지 않음
+ */
+class BLASTER_API FBlasterHitboxHistory
+{
+public:
+	void Init(int32 InMaxSlots, int32 InNumFrames);
+	void Reset();
+
+	bool IsInitialized() const { return NumFrames > 0; }
+	int32 GetMaxSlots() const { return MaxSlots; }
+	int32 GetNumRecordedFrames() const { return NumRecorded; }
+	double GetOldestTimestamp() const;
+	double GetNewestTimestamp() const;
+
+	// 새 프레임을 시작, 이번 프레임에 쓰지 않은 슬롯은 비어있는 것으로 기록됨
+	void BeginFrame(double Timestamp);
+	void WriteSlot(int32 Slot, const FVector& Center, float HalfHeight, float Radius);
+	// 슬롯을 다른 캐릭터가 재사용해도 예전 기록에 맞지 않도록 모든 프레임에서 지움
+	void ClearSlot(int32 Slot);
+
+	// Timestamp 시점의 히트박스를 앞뒤 프레임에서 보간해 둠, 기록 범위 밖이면 가장 가까운 프레임
+	bool Rewind(double Timestamp);
+
+	/**
+	 * 마지막 Rewind 결과에 대해 Start -> End 선분이 가장 먼저 들어가는 캡슐을 찾음
+	 * @return 맞은 슬롯, 없으면 INDEX_NONE. OutLocation 은 캡슐 표면에 들어간 점, OutTime 은 그 점의 선분 위 비율 (0..1)
+	 */
+	int32 Raycast(const FVector& Start, const FVector& End, int32 IgnoreSlot, FVector& OutLocation, float& OutTime) const;
+
+private:
+	int32 GetFrameIndex(int32 LogicalIndex) const { return (Head - (NumRecorded - 1) + LogicalIndex + NumFrames) % NumFrames; }
+	void CopyFrame(int32 Frame);
+	void LerpFrames(int32 FrameA, int32 FrameB, float Alpha);
+	// 선분이 되감은 캡슐에 처음 들어가는 비율, 시작점이 안쪽이면 0. 최근접점 비율 MaxTime 을 넘지 않음
+	float GetEntryTime(int32 Slot, const FVector3f& Start, const FVector3f& Dir, float MaxTime) const;
+
+	using FAlignedFloatArray = TArray<float, TAlignedHeapAllocator<16>>;
+
+	int32 MaxSlots{ 0 };
+	// MaxSlots 를 4 의 배수로 올린 값, 한 프레임의 길이
+	int32 SlotStride{ 0 };
+	// 지금까지 쓴 가장 큰 슬롯 + 1 을 4 의 배수로, 이 너머는 보간, 판정하지 않음
+	int32 ActiveLanes{ 0 };
+	int32 NumFrames{ 0 };
+	int32 Head{ INDEX_NONE };
+	int32 NumRecorded{ 0 };
+
+	TArray<double> Timestamps;
+	FAlignedFloatArray CenterX;
+	FAlignedFloatArray CenterY;
+	FAlignedFloatArray CenterZ;
+	// 캡슐 중심선의 절반 길이 (HalfHeight - Radius)
+	FAlignedFloatArray HalfSegment;
+	// 0 이면 그 프레임에 없던 슬롯
+	FAlignedFloatArray Radius;
+
+	FAlignedFloatArray RewoundX;
+	FAlignedFloatArray RewoundY;
+	FAlignedFloatArray RewoundZ;
+	FAlignedFloatArray RewoundHalfSegment;
+	FAlignedFloatArray RewoundRadius;
+};
@@ -0,0 +1,267 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Net/BlasterLagCompensationSubsystem.h"
+#include "Blaster.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Character.h"
+
+DECLARE_CYCLE_STAT(TEXT("LagComp Record"), STAT_BlasterLagCompRecord, STATGROUP_BlasterNet);
+DECLARE_CYCLE_STAT(TEXT("LagComp Confirm"), STAT_BlasterLagCompConfirm, STATGROUP_BlasterNet);
+DECLARE_DWORD_COUNTER_STAT(TEXT("LagComp Rays"), STAT_BlasterLagCompRays, STATGROUP_BlasterNet);
+
+void UBlasterLagCompensationSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	//클라이언트는 판정하지 않음
+	if (InWorld.GetNetMode() == NM_Client)
+	{
+		return;
+	}
+
+	//데디케이티드 서버는 NetServerMaxTickRate 가 상한, 상한이 없으면 MaxRecordRate 로 기록을 솎아냄
+	const float EngineTickRate = GEngine ? GEngine->GetMaxTickRate(0.f, false) : 0.f;
+	const float RecordRate = FMath::Max(EngineTickRate > 0.f ? FMath::Min(EngineTickRate, MaxRecordRate) : MaxRecordRate, 1.f);
+	//틱 간격이 흔들려도 건너뛰지 않도록 간격을 조금 줄이고, 보간할 앞뒤 프레임 몫으로 2 를 더함
+	MinRecordInterval = 0.9 / RecordRate;
+	const int32 HistoryFrames = FMath::CeilToInt(FMath::Max(MaxRewindSeconds, 0.f) / MinRecordInterval) + 2;
+	History.Init(MaxCharacters, HistoryFrames);
+	SlotCharacters.SetNum(History.GetMaxSlots());
+	SlotKeys.SetNumZeroed(History.GetMaxSlots());
+	CharacterSlots.Reserve(History.GetMaxSlots());
+	FreeSlots.Reset(History.GetMaxSlots());
+	//낮은 슬롯부터 써야 판정하는 레인 수가 캐릭터 수에 맞춰짐
+	for (int32 Slot = History.GetMaxSlots() - 1; Slot >= 0; --Slot)
+	{
+		FreeSlots.Add(Slot);
+	}
+	bRecording = true;
+
+	for (TActorIterator<ACharacter> It(&InWorld); It; ++It)
+	{
+		RegisterCharacter(*It);
+	}
+	ActorSpawnedHandle = InWorld.AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &UBlasterLagCompensationSubsystem::OnActorSpawned));
+}
+
+void UBlasterLagCompensationSubsystem::Deinitialize()
+{
+	if (UWorld* World = GetWorld())
+	{
+		World->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+	}
+	ActorSpawnedHandle.Reset();
+	bRecording = false;
+
+	Super::Deinitialize();
+}
+
+bool UBlasterLagCompensationSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UBlasterLagCompensationSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (!bRecording)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_BlasterLagCompRecord);
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	if (History.GetNumRecordedFrames() > 0 && Now - History.GetNewestTimestamp() < MinRecordInterval)
+	{
+		return;
+	}
+
+	//월드 틱이 끝난 뒤라 이번 프레임에 움직인 위치가 들어감
+	History.BeginFrame(Now);
+	for (int32 Slot = 0; Slot < SlotKeys.Num(); ++Slot)
+	{
+		if (SlotKeys[Slot] == nullptr)
+		{
+			continue;
+		}
+
+		const ACharacter* Character = SlotCharacters[Slot].Get();
+		if (Character == nullptr)
+		{
+			ReleaseSlot(Slot);
+			continue;
+		}
+
+		const UCapsuleComponent* Capsule = Character->GetCapsuleComponent();
+		History.WriteSlot(Slot, Capsule->GetComponentLocation(), Capsule->GetScaledCapsuleHalfHeight(), Capsule->GetScaledCapsuleRadius());
+	}
+}
+
+TStatId UBlasterLagCompensationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UBlasterLagCompensationSubsystem, STATGROUP_Tickables);
+}
+
+bool UBlasterLagCompensationSubsystem::ConfirmHitscan(const FVector& Start, const FVector& End, double ShotServerTime, const AActor* Shooter, FBlasterRewindHit& OutHit)
+{
+	SCOPE_CYCLE_COUNTER(STAT_BlasterLagCompConfirm);
+
+	if (!RewindTo(ShotServerTime))
+	{
+		return false;
+	}
+
+	//벽 뒤 캐릭터는 맞지 않게, 지금 위치의 캐릭터는 되감은 기록으로 판정하므로 빼고 지형만 봄
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(BlasterLagCompOcclusion), false, Shooter);
+	if (Shooter)
+	{
+		QueryParams.AddIgnoredActor(Shooter->GetOwner());
+		QueryParams.AddIgnoredActor(Shooter->GetInstigator());
+	}
+	AddRecordedCharactersToIgnore(QueryParams);
+	FHitResult Occlusion;
+	const bool bOccluded = GetWorld()->LineTraceSingleByChannel(Occlusion, Start, End, OcclusionChannel, QueryParams);
+	const FVector VisibleEnd = bOccluded ? Occlusion.Location : End;
+	const float VisibleFraction = bOccluded ? Occlusion.Time : 1.f;
+
+	INC_DWORD_STAT(STAT_BlasterLagCompRays);
+	FVector Location;
+	float Time = 0.f;
+	const int32 Slot = History.Raycast(Start, VisibleEnd, FindSlot(Shooter), Location, Time);
+	ACharacter* Character = Slot != INDEX_NONE ? SlotCharacters[Slot].Get() : nullptr;
+	if (Character == nullptr)
+	{
+		return false;
+	}
+
+	OutHit.Character = Character;
+	OutHit.Location = Location;
+	//Start -> End 기준 비율로
+	OutHit.Time = Time * VisibleFraction;
+	return true;
+}
+
+int32 UBlasterLagCompensationSubsystem::ConfirmHitscanBatch(const FVector& Start, TConstArrayView<FVector> Ends, double ShotServerTime, const AActor* Shooter, TArrayView<FBlasterRewindHit> OutHits)
+{
+	SCOPE_CYCLE_COUNTER(STAT_BlasterLagCompConfirm);
+
+	check(OutHits.Num() >= Ends.Num());
+	for (FBlasterRewindHit& OutHit : OutHits)
+	{
+		OutHit = FBlasterRewindHit();
+	}
+	if (!RewindTo(ShotServerTime))
+	{
+		return 0;
+	}
+
+	INC_DWORD_STAT_BY(STAT_BlasterLagCompRays, Ends.Num());
+	const int32 IgnoreSlot = FindSlot(Shooter);
+	int32 NumHits = 0;
+	for (int32 Index = 0; Index < Ends.Num(); ++Index)
+	{
+		FBlasterRewindHit& OutHit = OutHits[Index];
+		const int32 Slot = History.Raycast(Start, Ends[Index], IgnoreSlot, OutHit.Location, OutHit.Time);
+		OutHit.Character = Slot != INDEX_NONE ? SlotCharacters[Slot].Get() : nullptr;
+		NumHits += OutHit.Character ? 1 : 0;
+	}
+	return NumHits;
+}
+
+void UBlasterLagCompensationSubsystem::AddRecordedCharactersToIgnore(FCollisionQueryParams& QueryParams) const
+{
+	for (const TWeakObjectPtr<ACharacter>& Character : SlotCharacters)
+	{
+		if (const ACharacter* RecordedCharacter = Character.Get())
+		{
+			QueryParams.AddIgnoredActor(RecordedCharacter);
+		}
+	}
+}
+
+void UBlasterLagCompensationSubsystem::RegisterCharacter(ACharacter* Character)
+{
+	if (!bRecording || Character == nullptr)
+	{
+		return;
+	}
+
+	if (const int32* ExistingSlot = CharacterSlots.Find(Character))
+	{
+		if (SlotCharacters[*ExistingSlot].Get() == Character)
+		{
+			return;
+		}
+		//GC 된 캐릭터와 주소가 같은 새 캐릭터, 예전 슬롯은 기록째로 버림
+		ReleaseSlot(*ExistingSlot);
+	}
+
+	if (FreeSlots.Num() == 0)
+	{
+		if (!bWarnedFull)
+		{
+			UE_LOG(LogBlaster, Warning, TEXT("Lag compensation is full (%d characters), raise MaxCharacters"), History.GetMaxSlots());
+			bWarnedFull = true;
+		}
+		return;
+	}
+
+	const int32 Slot = FreeSlots.Pop(false);
+	SlotCharacters[Slot] = Character;
+	SlotKeys[Slot] = Character;
+	CharacterSlots.Add(Character, Slot);
+}
+
+void UBlasterLagCompensationSubsystem::UnregisterCharacter(ACharacter* Character)
+{
+	if (const int32* Slot = CharacterSlots.Find(Character))
+	{
+		ReleaseSlot(*Slot);
+	}
+}
+
+void UBlasterLagCompensationSubsystem::OnActorSpawned(AActor* Actor)
+{
+	if (ACharacter* Character = Cast<ACharacter>(Actor))
+	{
+		RegisterCharacter(Character);
+	}
+}
+
+void UBlasterLagCompensationSubsystem::ReleaseSlot(int32 Slot)
+{
+	CharacterSlots.Remove(SlotKeys[Slot]);
+	SlotKeys[Slot] = nullptr;
+	SlotCharacters[Slot].Reset();
+	History.ClearSlot(Slot);
+	FreeSlots.Add(Slot);
+	//앞쪽 슬롯이 먼저 다시 쓰이도록
+	FreeSlots.Sort(TGreater<int32>());
+}
+
+bool UBlasterLagCompensationSubsystem::RewindTo(double ShotServerTime)
+{
+	if (!bRecording)
+	{
+		return false;
+	}
+	const double Now = GetWorld()->GetTimeSeconds();
+	return History.Rewind(FMath::Clamp(ShotServerTime, Now - MaxRewindSeconds, Now));
+}
+
+int32 UBlasterLagCompensationSubsystem::FindSlot(const AActor* Actor) const
+{
+	const int32* Slot = Actor ? CharacterSlots.Find(Actor) : nullptr;
+	//무기처럼 캐릭터가 아닌 액터로 넘어오면 Instigator 로
+	if (Slot == nullptr && Actor && Actor->GetInstigator())
+	{
+		Slot = CharacterSlots.Find(Actor->GetInstigator());
+	}
+	return Slot ? *Slot : INDEX_NONE;
+}
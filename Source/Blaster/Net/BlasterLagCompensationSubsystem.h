@@ -0,0 +1,108 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineTypes.h"
+#include "Net/BlasterHitboxHistory.h"
+#include "BlasterLagCompensationSubsystem.generated.h"
+
+class ACharacter;
+struct FCollisionQueryParams;
+
+USTRUCT(BlueprintType)
+struct FBlasterRewindHit
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly)
+	ACharacter* Character{ nullptr };
+
+	UPROPERTY(BlueprintReadOnly)
+	FVector Location{ FVector::ZeroVector };
+
+	// Start -> End 선분 위의 비율
+	UPROPERTY(BlueprintReadOnly)
+	float Time{ 0.f };
+};
+
+/**
+ * 서버 되감기 히트 판정
+ * 매 틱 월드의 모든 캐릭터 캡슐을 FBlasterHitboxHistory 에 기록하고, 클라이언트가 쏜 시점
+ * (발사할때의 GameState->GetServerWorldTimeSeconds()) 으로 되돌려서 샷을 확인함
+ * 리슨/데디케이티드 서버에서만 기록하고 확인 중에는 힙 할당을 하지 않음
+ */
+UCLASS(Config = Game)
+class BLASTER_API UBlasterLagCompensationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+public:
+	//~ Begin UWorldSubsystem Interface
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	//~ End UWorldSubsystem Interface
+
+	//~ Begin FTickableGameObject Interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~ End FTickableGameObject Interface
+
+	// 쏜 사람 자신은 제외하고 선분에 가장 먼저 맞는 캐릭터, 그 앞을 월드 지형이 막으면 맞지 않음
+	UFUNCTION(BlueprintCallable)
+	bool ConfirmHitscan(const FVector& Start, const FVector& End, double ShotServerTime, const AActor* Shooter, FBlasterRewindHit& OutHit);
+
+	// 산탄처럼 한 시점의 여러 발, 한번만 되감음. OutHits 는 Ends 와 같은 길이, 맞은 수를 돌려줌
+	// 가림 판정은 하지 않으므로 Ends 는 월드 트레이스로 막힌 곳까지 줄여서 넘겨야 함 (UBlasterHitscanSubsystem)
+	int32 ConfirmHitscanBatch(const FVector& Start, TConstArrayView<FVector> Ends, double ShotServerTime, const AActor* Shooter, TArrayView<FBlasterRewindHit> OutHits);
+
+	// 월드에 스폰되는 캐릭터는 자동으로 등록됨
+	void RegisterCharacter(ACharacter* Character);
+	void UnregisterCharacter(ACharacter* Character);
+
+	bool IsRecording() const { return bRecording; }
+
+	// 되감아 판정할 캐릭터를 월드 트레이스에서 빼기 위해, 기록 중인 캐릭터를 전부 무시 목록에 넣음
+	void AddRecordedCharactersToIgnore(FCollisionQueryParams& QueryParams) const;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	// 동시에 기록하는 캐릭터 수, 넘으면 등록되지 않음
+	UPROPERTY(Config)
+	int32 MaxCharacters{ 128 };
+
+	// 이보다 오래된 샷은 이 시점으로 판정, 핑 조작으로 너무 멀리 되감지 못하게
+	UPROPERTY(Config)
+	float MaxRewindSeconds{ 0.4f };
+
+	// 초당 최대 기록 횟수, 엔진 틱레이트 상한이 없을때 (리슨 서버) 쓰고 이보다 잦은 틱은 건너뜀
+	// 기록 프레임 수는 MaxRewindSeconds x 이 값으로 정해짐
+	UPROPERTY(Config)
+	float MaxRecordRate{ 120.f };
+
+	// 가림 판정 채널 (ConfirmHitscan)
+	UPROPERTY(Config)
+	TEnumAsByte<ECollisionChannel> OcclusionChannel{ ECC_Visibility };
+
+private:
+	void OnActorSpawned(AActor* Actor);
+	void ReleaseSlot(int32 Slot);
+	bool RewindTo(double ShotServerTime);
+	int32 FindSlot(const AActor* Actor) const;
+
+	FBlasterHitboxHistory History;
+
+	TArray<TWeakObjectPtr<ACharacter>> SlotCharacters;
+	// 슬롯 해제때 맵에서 지우기 위한 키, 역참조하지 않음
+	TArray<const AActor*> SlotKeys;
+	TMap<const AActor*, int32> CharacterSlots;
+	TArray<int32> FreeSlots;
+
+	// 이보다 가까운 간격의 틱은 기록하지 않음, 기록 프레임이 MaxRewindSeconds 를 다 덮도록
+	double MinRecordInterval{ 0.0 };
+
+	FDelegateHandle ActorSpawnedHandle;
+	bool bRecording{ false };
+	bool bWarnedFull{ false };
+};
@@ -0,0 +1,78 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Net/BlasterPushModel.h"
+#include "GameFramework/Actor.h"
+#include "Net/UnrealNetwork.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+DEFINE_STAT(STAT_BlasterPropertiesCompared);
+DEFINE_STAT(STAT_BlasterPropertiesPushed);
+
+CSV_DECLARE_CATEGORY_EXTERN(BlasterNet);
+
+namespace BlasterPushModel
+{
+	struct FPropertyCounts
+	{
+		// push model 이 아니라 매번 비교되는 프로퍼티
+		int32 NumCompared{ 0 };
+		// push model 이 꺼져있을때 비교되는 프로퍼티 (COND_Never 제외 전부)
+		int32 NumLifetime{ 0 };
+	};
+
+	// 클래스마다 한번만 세어둠, 게임 스레드에서만 접근
+	// 블루프린트 재컴파일로 다시 만들어진 클래스가 예전 주소를 재사용해도 섞이지 않도록 약한 참조로 둠
+	static TMap<TWeakObjectPtr<const UClass>, FPropertyCounts> ClassPropertyCounts;
+
+	static const FPropertyCounts& GetPropertyCounts(const AActor* Actor)
+	{
+		const UClass* Class = Actor->GetClass();
+		if (const FPropertyCounts* Counts = ClassPropertyCounts.Find(Class))
+		{
+			return *Counts;
+		}
+
+		//새 클래스가 들어올때만, 사라진 클래스 항목을 정리함
+		for (auto It = ClassPropertyCounts.CreateIterator(); It; ++It)
+		{
+			if (!It.Key().IsValid())
+			{
+				It.RemoveCurrent();
+			}
+		}
+
+		TArray<FLifetimeProperty> LifetimeProps;
+		Class->GetDefaultObject<AActor>()->GetLifetimeReplicatedProps(LifetimeProps);
+		FPropertyCounts Counts;
+		for (const FLifetimeProperty& LifetimeProp : LifetimeProps)
+		{
+			if (LifetimeProp.Condition == COND_Never)
+			{
+				continue;
+			}
+			++Counts.NumLifetime;
+			Counts.NumCompared += LifetimeProp.bIsPushBased ? 0 : 1;
+		}
+		return ClassPropertyCounts.Add(Class, Counts);
+	}
+
+	void CountComparedProperties(const AActor* Actor)
+	{
+		if (Actor == nullptr)
+		{
+			return;
+		}
+		//push model 이 꺼져있으면 push 프로퍼티도 매번 비교됨
+		const FPropertyCounts& Counts = GetPropertyCounts(Actor);
+		const int32 NumCompared = IS_PUSH_MODEL_ENABLED() ? Counts.NumCompared : Counts.NumLifetime;
+		INC_DWORD_STAT_BY(STAT_BlasterPropertiesCompared, NumCompared);
+		CSV_CUSTOM_STAT(BlasterNet, PropertiesCompared, NumCompared, ECsvCustomStatOp::Accumulate);
+	}
+
+	void CountPushedProperty()
+	{
+		INC_DWORD_STAT(STAT_BlasterPropertiesPushed);
+		CSV_CUSTOM_STAT(BlasterNet, PropertiesPushed, 1, ECsvCustomStatOp::Accumulate);
+	}
+}
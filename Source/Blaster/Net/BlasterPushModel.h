@@ -0,0 +1,31 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blaster.h"
+#include "Net/Core/PushModel/PushModel.h"
+
+class AActor;
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Properties Compared"), STAT_BlasterPropertiesCompared, STATGROUP_BlasterNet, BLASTER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Properties Pushed"), STAT_BlasterPropertiesPushed, STATGROUP_BlasterNet, BLASTER_API);
+
+/**
+ * Blaster 복제 프로퍼티는 전부 push model (DOREPLIFETIME_WITH_PARAMS_FAST + bIsPushBased)
+ * 값을 바꾸는 곳에서 BLASTER_MARK_PROPERTY_DIRTY 를 불러야 다음 업데이트에 비교, 전송됨
+ * stat BlasterNet 에서 프레임당 비교 대상으로 남은 프로퍼티 수와 dirty 로 표시한 수를 볼 수 있음
+ */
+namespace BlasterPushModel
+{
+	// PreReplication 에서 호출, 이 액터가 push model 이 아니라서 매번 비교되는 프로퍼티 수를 더함
+	BLASTER_API void CountComparedProperties(const AActor* Actor);
+	BLASTER_API void CountPushedProperty();
+}
+
+#define BLASTER_MARK_PROPERTY_DIRTY(ClassName, PropertyName, Object) \
+	do \
+	{ \
+		MARK_PROPERTY_DIRTY_FROM_NAME(ClassName, PropertyName, Object); \
+		BlasterPushModel::CountPushedProperty(); \
+	} while (0)
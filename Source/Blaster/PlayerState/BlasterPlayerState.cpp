@@ -0,0 +1,44 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PlayerState/BlasterPlayerState.h"
+#include "Net/BlasterPushModel.h"
+#include "Net/UnrealNetwork.h"
+
+void ABlasterPlayerState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(ABlasterPlayerState, Loadout, Params);
+}
+
+void ABlasterPlayerState::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+
+	BlasterPushModel::CountComparedProperties(this);
+}
+
+void ABlasterPlayerState::CopyProperties(APlayerState* PlayerState)
+{
+	Super::CopyProperties(PlayerState);
+
+	ABlasterPlayerState* BlasterPlayerState = Cast<ABlasterPlayerState>(PlayerState);
+	if (BlasterPlayerState)
+	{
+		BlasterPlayerState->SetLoadout(Loadout);
+	}
+}
+
+void ABlasterPlayerState::ServerSetLoadout_Implementation(const FBlasterLoadout& NewLoadout)
+{
+	SetLoadout(NewLoadout);
+}
+
+void ABlasterPlayerState::SetLoadout(const FBlasterLoadout& NewLoadout)
+{
+	Loadout = NewLoadout;
+	BLASTER_MARK_PROPERTY_DIRTY(ABlasterPlayerState, Loadout, this);
+}
@@ -0,0 +1,50 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/PlayerState.h"
+#include "BlasterPlayerState.generated.h"
+
+USTRUCT(BlueprintType)
+struct FBlasterLoadout
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FName PrimaryWeapon;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FName SecondaryWeapon;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 CharacterSkin{ 0 };
+};
+
+/**
+ * 로비에서 고른 로드아웃을 심리스 트래블 후 매치까지 들고가는 PlayerState
+ */
+UCLASS()
+class BLASTER_API ABlasterPlayerState : public APlayerState
+{
+	GENERATED_BODY()
+public:
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
+
+	//심리스 트래블때 새 맵의 PlayerState 로 값을 옮겨줌
+	virtual void CopyProperties(APlayerState* PlayerState) override;
+
+	UFUNCTION(Server, Reliable, BlueprintCallable)
+	void ServerSetLoadout(const FBlasterLoadout& NewLoadout);
+
+	UFUNCTION(BlueprintPure)
+	const FBlasterLoadout& GetLoadout() const { return Loadout; }
+
+	//서버 전용, push model 이라 값을 바꿀때는 항상 여기로
+	void SetLoadout(const FBlasterLoadout& NewLoadout);
+
+private:
+	UPROPERTY(Replicated)
+	FBlasterLoadout Loadout;
+};
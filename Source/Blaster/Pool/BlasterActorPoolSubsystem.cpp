@@ -0,0 +1,227 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Pool/BlasterActorPoolSubsystem.h"
+#include "Pool/BlasterPooledActor.h"
+#include "Blaster.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Pool Acquire"), STAT_BlasterPoolAcquire, STATGROUP_BlasterNet);
+DECLARE_CYCLE_STAT(TEXT("Pool Release"), STAT_BlasterPoolRelease, STATGROUP_BlasterNet);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pool Spawned"), STAT_BlasterPoolSpawned, STATGROUP_BlasterNet);
+
+namespace BlasterActorPool
+{
+	static int32 Enable = 1;
+	static FAutoConsoleVariableRef CVarEnable(
+		TEXT("Blaster.Pool.Enable"),
+		Enable,
+		TEXT("1: 발사체/이펙트를 풀에서 꺼내고 돌려받음, 0: 매번 SpawnActor/Destroy"),
+		ECVF_Default);
+}
+
+void UBlasterActorPoolSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (!IsPoolingEnabled())
+	{
+		return;
+	}
+
+	for (const FBlasterActorPoolPrewarm& Entry : PrewarmPools)
+	{
+		UClass* ActorClass = Entry.ActorClass.LoadSynchronous();
+		if (ActorClass == nullptr || !CanPool(ActorClass))
+		{
+			continue;
+		}
+		//데디케이티드 서버는 보이기만 하는 로컬 이펙트를 만들지 않음
+		if (InWorld.GetNetMode() == NM_DedicatedServer && !ActorClass->GetDefaultObject<AActor>()->GetIsReplicated())
+		{
+			continue;
+		}
+		Prewarm(ActorClass, Entry.Count);
+	}
+}
+
+void UBlasterActorPoolSubsystem::Deinitialize()
+{
+	//액터는 월드와 같이 정리됨
+	Pools.Reset();
+
+	Super::Deinitialize();
+}
+
+bool UBlasterActorPoolSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+AActor* UBlasterActorPoolSubsystem::AcquireActor(TSubclassOf<AActor> ActorClass, const FVector& Location, const FVector& Direction, AActor* Owner, APawn* Instigator)
+{
+	SCOPE_CYCLE_COUNTER(STAT_BlasterPoolAcquire);
+
+	if (ActorClass == nullptr || !CanPool(ActorClass))
+	{
+		return nullptr;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	AActor* Actor = nullptr;
+	if (IsPoolingEnabled())
+	{
+		if (FBlasterActorPool* Pool = Pools.Find(ActorClass))
+		{
+			while (Actor == nullptr && Pool->FreeActors.Num() > 0)
+			{
+				AActor* Candidate = Pool->FreeActors.Pop(false);
+				Actor = IsValid(Candidate) ? Candidate : nullptr;
+			}
+		}
+	}
+	if (Actor == nullptr)
+	{
+		Actor = SpawnPooledActor(ActorClass, Location, Direction);
+		if (Actor == nullptr)
+		{
+			return nullptr;
+		}
+		++Stats.NumSpawned;
+		INC_DWORD_STAT(STAT_BlasterPoolSpawned);
+	}
+
+	ActivateActor(Actor, Location, Direction, Owner, Instigator);
+
+	const double Elapsed = FPlatformTime::Seconds() - StartTime;
+	++Stats.NumAcquired;
+	Stats.AcquireSeconds += Elapsed;
+	Stats.MaxAcquireSeconds = FMath::Max(Stats.MaxAcquireSeconds, Elapsed);
+	return Actor;
+}
+
+void UBlasterActorPoolSubsystem::ReleaseActor(AActor* Actor)
+{
+	SCOPE_CYCLE_COUNTER(STAT_BlasterPoolRelease);
+
+	if (!IsValid(Actor))
+	{
+		return;
+	}
+	//두번 돌려받으면 같은 액터가 두번 꺼내짐
+	const ABlasterPooledActor* PooledActor = Cast<ABlasterPooledActor>(Actor);
+	if (PooledActor && !PooledActor->IsPoolActive())
+	{
+		return;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	UClass* ActorClass = Actor->GetClass();
+	FBlasterActorPool* Pool = IsPoolingEnabled() && CanPool(ActorClass) ? &Pools.FindOrAdd(ActorClass) : nullptr;
+	//ABlasterPooledActor 가 아니면 상태가 없으니 풀에서 찾아봄, 풀은 MaxPooledPerClass 개까지라 짧음
+	if (Pool && PooledActor == nullptr && Pool->FreeActors.Contains(Actor))
+	{
+		return;
+	}
+	//넘쳐서 파괴할 액터도 풀로 돌아갈때와 같은 정리(타이머, 이펙트)를 먼저 거침
+	DeactivateActor(Actor);
+	if (Pool && Pool->FreeActors.Num() < MaxPooledPerClass)
+	{
+		Pool->FreeActors.Add(Actor);
+	}
+	else
+	{
+		Actor->Destroy();
+		++Stats.NumDestroyed;
+	}
+
+	++Stats.NumReleased;
+	Stats.ReleaseSeconds += FPlatformTime::Seconds() - StartTime;
+}
+
+void UBlasterActorPoolSubsystem::Prewarm(TSubclassOf<AActor> ActorClass, int32 Count)
+{
+	if (ActorClass == nullptr || !CanPool(ActorClass))
+	{
+		return;
+	}
+
+	FBlasterActorPool& Pool = Pools.FindOrAdd(ActorClass);
+	Count = FMath::Min(Count, MaxPooledPerClass);
+	Pool.FreeActors.Reserve(MaxPooledPerClass);
+	while (Pool.FreeActors.Num() < Count)
+	{
+		AActor* Actor = SpawnPooledActor(ActorClass, FVector::ZeroVector, FVector::ForwardVector);
+		if (Actor == nullptr)
+		{
+			break;
+		}
+		DeactivateActor(Actor);
+		Pool.FreeActors.Add(Actor);
+	}
+}
+
+bool UBlasterActorPoolSubsystem::IsPoolingEnabled() const
+{
+	return bPoolingEnabled && BlasterActorPool::Enable != 0;
+}
+
+int32 UBlasterActorPoolSubsystem::GetNumFree(TSubclassOf<AActor> ActorClass) const
+{
+	const FBlasterActorPool* Pool = Pools.Find(ActorClass);
+	return Pool ? Pool->FreeActors.Num() : 0;
+}
+
+bool UBlasterActorPoolSubsystem::CanPool(UClass* ActorClass) const
+{
+	//복제되는 액터는 서버 것만 쓸 수 있음
+	const AActor* ActorCDO = ActorClass->GetDefaultObject<AActor>();
+	if (ActorCDO->GetIsReplicated() && GetWorld()->GetNetMode() == NM_Client)
+	{
+		bool bAlreadyWarned = false;
+		WarnedClientClasses.Add(ActorClass->GetFName(), &bAlreadyWarned);
+		UE_CLOG(!bAlreadyWarned, LogBlaster, Warning, TEXT("%s is replicated and can only be acquired on the server"), *ActorClass->GetName());
+		return false;
+	}
+	return true;
+}
+
+AActor* UBlasterActorPoolSubsystem::SpawnPooledActor(UClass* ActorClass, const FVector& Location, const FVector& Direction)
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParams.ObjectFlags |= RF_Transient;
+	return GetWorld()->SpawnActor<AActor>(ActorClass, Location, Direction.Rotation(), SpawnParams);
+}
+
+void UBlasterActorPoolSubsystem::ActivateActor(AActor* Actor, const FVector& Location, const FVector& Direction, AActor* Owner, APawn* Instigator)
+{
+	if (ABlasterPooledActor* PooledActor = Cast<ABlasterPooledActor>(Actor))
+	{
+		PooledActor->ActivateFromPool(Location, Direction, Owner, Instigator);
+		return;
+	}
+
+	//풀링용으로 만들어지지 않은 액터는 보이기, 충돌, 틱만 되돌림
+	Actor->SetOwner(Owner);
+	Actor->SetInstigator(Instigator);
+	Actor->SetActorLocationAndRotation(Location, Direction.Rotation(), false, nullptr, ETeleportType::ResetPhysics);
+	Actor->SetActorHiddenInGame(false);
+	Actor->SetActorEnableCollision(true);
+	Actor->SetActorTickEnabled(true);
+}
+
+void UBlasterActorPoolSubsystem::DeactivateActor(AActor* Actor)
+{
+	if (ABlasterPooledActor* PooledActor = Cast<ABlasterPooledActor>(Actor))
+	{
+		PooledActor->DeactivateToPool();
+		return;
+	}
+
+	Actor->SetActorHiddenInGame(true);
+	Actor->SetActorEnableCollision(false);
+	Actor->SetActorTickEnabled(false);
+	Actor->SetOwner(nullptr);
+}
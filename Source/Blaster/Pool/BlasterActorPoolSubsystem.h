@@ -0,0 +1,104 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "BlasterActorPoolSubsystem.generated.h"
+
+USTRUCT()
+struct FBlasterActorPoolPrewarm
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Config)
+	TSoftClassPtr<AActor> ActorClass;
+
+	UPROPERTY(Config)
+	int32 Count{ 0 };
+};
+
+USTRUCT()
+struct FBlasterActorPool
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<AActor*> FreeActors;
+};
+
+struct FBlasterActorPoolStats
+{
+	int64 NumAcquired{ 0 };
+	// 풀이 비어서(또는 풀링이 꺼져서) 새로 스폰한 수
+	int64 NumSpawned{ 0 };
+	int64 NumReleased{ 0 };
+	int64 NumDestroyed{ 0 };
+	double AcquireSeconds{ 0.0 };
+	double MaxAcquireSeconds{ 0.0 };
+	double ReleaseSeconds{ 0.0 };
+};
+
+/**
+ * 클래스별 액터 풀 (발사체, 충돌 이펙트/데칼)
+ * 맵 시작때 PrewarmPools 만큼 미리 스폰해두고 AcquireActor/ReleaseActor 로 꺼내고 돌려받음
+ * 복제되는 클래스는 서버에서만, 복제되지 않는 클래스는 각자 로컬에서 풀링함
+ * Blaster.Pool.Enable 0 이면 같은 호출이 SpawnActor/Destroy 로 동작함 (비교용)
+ */
+UCLASS(Config = Game)
+class BLASTER_API UBlasterActorPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+public:
+	//~ Begin UWorldSubsystem Interface
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	//~ End UWorldSubsystem Interface
+
+	UFUNCTION(BlueprintCallable, meta = (DeterminesOutputType = "ActorClass"))
+	AActor* AcquireActor(TSubclassOf<AActor> ActorClass, const FVector& Location, const FVector& Direction, AActor* Owner = nullptr, APawn* Instigator = nullptr);
+
+	template<class T>
+	T* Acquire(TSubclassOf<T> ActorClass, const FVector& Location, const FVector& Direction, AActor* Owner = nullptr, APawn* Instigator = nullptr)
+	{
+		return Cast<T>(AcquireActor(ActorClass, Location, Direction, Owner, Instigator));
+	}
+
+	UFUNCTION(BlueprintCallable)
+	void ReleaseActor(AActor* Actor);
+
+	// 풀에 Count 개가 비활성으로 대기하도록 채움
+	void Prewarm(TSubclassOf<AActor> ActorClass, int32 Count);
+
+	bool IsPoolingEnabled() const;
+	void SetPoolingEnabled(bool bEnabled) { bPoolingEnabled = bEnabled; }
+	int32 GetNumFree(TSubclassOf<AActor> ActorClass) const;
+	int32 GetMaxPooledPerClass() const { return MaxPooledPerClass; }
+
+	const FBlasterActorPoolStats& GetStats() const { return Stats; }
+	void ResetStats() { Stats = FBlasterActorPoolStats(); }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	UPROPERTY(Config)
+	TArray<FBlasterActorPoolPrewarm> PrewarmPools;
+
+	// 클래스당 보관하는 최대 수, 넘치면 돌려받을때 파괴
+	UPROPERTY(Config)
+	int32 MaxPooledPerClass{ 512 };
+
+private:
+	bool CanPool(UClass* ActorClass) const;
+	AActor* SpawnPooledActor(UClass* ActorClass, const FVector& Location, const FVector& Direction);
+	static void ActivateActor(AActor* Actor, const FVector& Location, const FVector& Direction, AActor* Owner, APawn* Instigator);
+	static void DeactivateActor(AActor* Actor);
+
+	UPROPERTY(Transient)
+	TMap<UClass*, FBlasterActorPool> Pools;
+
+	FBlasterActorPoolStats Stats;
+	bool bPoolingEnabled{ true };
+	// 클라이언트에서 복제 클래스를 꺼내려 한 경고는 클래스마다 한번만
+	mutable TSet<FName> WarnedClientClasses;
+};
@@ -0,0 +1,145 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Pool/BlasterPooledActor.h"
+#include "Pool/BlasterActorPoolSubsystem.h"
+#include "Net/BlasterPushModel.h"
+#include "Net/UnrealNetwork.h"
+#include "TimerManager.h"
+
+ABlasterPooledActor::ABlasterPooledActor()
+{
+	//풀에 있는 동안은 복제하지 않음, 활성화할때만 깨어남
+	NetDormancy = DORM_DormantAll;
+}
+
+void ABlasterPooledActor::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(ABlasterPooledActor, PoolActivation, Params);
+}
+
+void ABlasterPooledActor::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+
+	BlasterPushModel::CountComparedProperties(this);
+}
+
+void ABlasterPooledActor::BeginPlay()
+{
+	Super::BeginPlay();
+
+	//클라이언트는 활성 상태로 처음 받았으면 이미 OnRep 에서 켜짐
+	if (!PoolActivation.bActive)
+	{
+		ApplyActiveState(false);
+	}
+}
+
+void ABlasterPooledActor::ActivateFromPool(const FVector& Location, const FVector& Direction, AActor* NewOwner, APawn* NewInstigator)
+{
+	SetOwner(NewOwner);
+	SetInstigator(NewInstigator);
+	SetActorLocationAndRotation(Location, Direction.Rotation(), false, nullptr, ETeleportType::ResetPhysics);
+
+	++PoolActivation.Serial;
+	PoolActivation.bActive = true;
+	PoolActivation.Flags = 0;
+	PoolActivation.Location = Location;
+	PoolActivation.Direction = Direction.GetSafeNormal();
+	BLASTER_MARK_PROPERTY_DIRTY(ABlasterPooledActor, PoolActivation, this);
+	if (GetIsReplicated())
+	{
+		SetNetDormancy(DORM_Awake);
+		ForceNetUpdate();
+	}
+
+	OnPoolActivated();
+
+	if (LifeSeconds > 0.f)
+	{
+		GetWorldTimerManager().SetTimer(LifeTimerHandle, this, &ABlasterPooledActor::ReturnToPool, LifeSeconds, false);
+	}
+}
+
+void ABlasterPooledActor::DeactivateToPool()
+{
+	GetWorldTimerManager().ClearTimer(LifeTimerHandle);
+
+	PoolActivation.bActive = false;
+	BLASTER_MARK_PROPERTY_DIRTY(ABlasterPooledActor, PoolActivation, this);
+
+	OnPoolDeactivated();
+
+	if (GetIsReplicated())
+	{
+		//비활성화가 한번 복제된 뒤에 휴면에 들어감
+		ForceNetUpdate();
+		SetNetDormancy(DORM_DormantAll);
+	}
+	SetOwner(nullptr);
+	SetInstigator(nullptr);
+}
+
+void ABlasterPooledActor::ReturnToPool()
+{
+	if (!HasAuthority() || !PoolActivation.bActive)
+	{
+		return;
+	}
+
+	UBlasterActorPoolSubsystem* Pool = GetWorld()->GetSubsystem<UBlasterActorPoolSubsystem>();
+	if (Pool)
+	{
+		Pool->ReleaseActor(this);
+	}
+	else
+	{
+		Destroy();
+	}
+}
+
+void ABlasterPooledActor::OnPoolActivated()
+{
+	ApplyActiveState(true);
+	ReceivePoolActivated();
+}
+
+void ABlasterPooledActor::OnPoolDeactivated()
+{
+	ApplyActiveState(false);
+	ReceivePoolDeactivated();
+}
+
+void ABlasterPooledActor::SetDeactivationPayload(uint8 Flags, const FVector& Location, const FVector& Direction)
+{
+	PoolActivation.Flags = Flags;
+	PoolActivation.Location = Location;
+	PoolActivation.Direction = Direction.GetSafeNormal();
+}
+
+void ABlasterPooledActor::OnRep_PoolActivation(const FBlasterPoolActivation& PreviousActivation)
+{
+	const bool bNewActivation = PoolActivation.Serial != PreviousActivation.Serial;
+	if (PoolActivation.bActive && bNewActivation)
+	{
+		SetActorLocationAndRotation(PoolActivation.Location, PoolActivation.Direction.Rotation(), false, nullptr, ETeleportType::ResetPhysics);
+		OnPoolActivated();
+	}
+	//업데이트 사이에 켜졌다 꺼진 경우도 비활성화 처리는 함 (충돌 이펙트)
+	else if (!PoolActivation.bActive && (PreviousActivation.bActive || bNewActivation))
+	{
+		OnPoolDeactivated();
+	}
+}
+
+void ABlasterPooledActor::ApplyActiveState(bool bActive)
+{
+	SetActorHiddenInGame(!bActive);
+	SetActorEnableCollision(bActive);
+	SetActorTickEnabled(bActive && PrimaryActorTick.bCanEverTick);
+}
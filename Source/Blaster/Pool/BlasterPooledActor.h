@@ -0,0 +1,91 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Engine/NetSerialization.h"
+#include "BlasterPooledActor.generated.h"
+
+USTRUCT()
+struct FBlasterPoolActivation
+{
+	GENERATED_BODY()
+
+	// 활성화마다 증가, 클라이언트가 비활성 -> 활성을 한번에 받아도 새 활성화로 인식
+	UPROPERTY()
+	uint8 Serial{ 0 };
+
+	UPROPERTY()
+	bool bActive{ false };
+
+	// 하위 클래스가 쓰는 값 (발사체는 충돌로 비활성화됐는지)
+	UPROPERTY()
+	uint8 Flags{ 0 };
+
+	// 활성화 위치/방향, 비활성화할때는 비활성화된 위치/방향
+	UPROPERTY()
+	FVector_NetQuantize Location;
+
+	UPROPERTY()
+	FVector_NetQuantizeNormal Direction;
+};
+
+/**
+ * UBlasterActorPoolSubsystem 이 스폰/파괴 대신 꺼내고 돌려받는 액터
+ * 복제되는 경우 스폰은 풀을 채울때 한번뿐이고 이후에는 PoolActivation 만 복제됨
+ * 풀에 있는 동안은 숨김, 충돌/틱 꺼짐, 넷 휴면 상태라 복제 비용이 없음
+ */
+UCLASS(Abstract)
+class BLASTER_API ABlasterPooledActor : public AActor
+{
+	GENERATED_BODY()
+public:
+	ABlasterPooledActor();
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
+
+	// 풀에서만 호출
+	void ActivateFromPool(const FVector& Location, const FVector& Direction, AActor* NewOwner, APawn* NewInstigator);
+	void DeactivateToPool();
+
+	// 서버(비복제 액터는 로컬)에서 풀로 돌려보냄, 풀링이 꺼져있으면 파괴
+	UFUNCTION(BlueprintCallable)
+	void ReturnToPool();
+
+	UFUNCTION(BlueprintPure)
+	bool IsPoolActive() const { return PoolActivation.bActive; }
+
+protected:
+	virtual void BeginPlay() override;
+
+	// 서버와 클라이언트 양쪽에서 불림, 보이기/숨기기 같은 로컬 상태만 바꿀 것
+	virtual void OnPoolActivated();
+	virtual void OnPoolDeactivated();
+
+	UFUNCTION(BlueprintImplementableEvent, meta = (DisplayName = "On Pool Activated"))
+	void ReceivePoolActivated();
+
+	UFUNCTION(BlueprintImplementableEvent, meta = (DisplayName = "On Pool Deactivated"))
+	void ReceivePoolDeactivated();
+
+	// 다음 DeactivateToPool 때 같이 복제될 값
+	void SetDeactivationPayload(uint8 Flags, const FVector& Location, const FVector& Direction);
+	const FBlasterPoolActivation& GetPoolActivation() const { return PoolActivation; }
+
+	// 0 보다 크면 활성화 후 이 시간이 지나면 풀로 돌아감
+	UPROPERTY(EditDefaultsOnly, Category = "Pool")
+	float LifeSeconds{ 0.f };
+
+private:
+	UFUNCTION()
+	void OnRep_PoolActivation(const FBlasterPoolActivation& PreviousActivation);
+
+	void ApplyActiveState(bool bActive);
+
+	UPROPERTY(ReplicatedUsing = OnRep_PoolActivation)
+	FBlasterPoolActivation PoolActivation;
+
+	FTimerHandle LifeTimerHandle;
+};
@@ -0,0 +1,458 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ReplicationGraph/BlasterReplicationGraph.h"
+#include "Blaster.h"
+#include "ReplicationGraphTypes.h"
+#include "Engine/LevelScriptActor.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "HAL/IConsoleManager.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "UObject/UObjectIterator.h"
+
+CSV_DEFINE_CATEGORY(BlasterNet, true);
+
+namespace BlasterRepGraph
+{
+	static int32 Enable = 1;
+	static FAutoConsoleVariableRef CVarEnable(
+		TEXT("Blaster.RepGraph.Enable"),
+		Enable,
+		TEXT("1: GameNetDriver 에 UBlasterReplicationGraph 사용, 0: 기존 액터 단위 복제. 다음 넷 드라이버 생성부터 적용"),
+		ECVF_Default);
+
+	static UReplicationDriver* ConditionalCreateReplicationDriver(UNetDriver* ForNetDriver, UWorld* World)
+	{
+		//비콘, 데모 드라이버에는 붙이지 않음
+		if (Enable == 0 || World == nullptr || ForNetDriver == nullptr || ForNetDriver->NetDriverName != NAME_GameNetDriver)
+		{
+			return nullptr;
+		}
+		UE_LOG(LogBlaster, Log, TEXT("Using UBlasterReplicationGraph for %s"), *ForNetDriver->GetName());
+		return NewObject<UBlasterReplicationGraph>(GetTransientPackage());
+	}
+}
+
+UBlasterReplicationGraph::UBlasterReplicationGraph()
+{
+	if (!UReplicationDriver::CreateReplicationDriverDelegate().IsBound())
+	{
+		UReplicationDriver::CreateReplicationDriverDelegate().BindLambda([](UNetDriver* ForNetDriver, const FURL& URL, UWorld* World) -> UReplicationDriver*
+			{
+				return BlasterRepGraph::ConditionalCreateReplicationDriver(ForNetDriver, World);
+			});
+	}
+}
+
+void UBlasterReplicationGraph::ResetGameNetState()
+{
+	Super::ResetGameNetState();
+
+	//맵이 바뀌면 액터는 RouteRemove 로 빠지지만 대기 목록은 직접 비움
+	PendingOwnerActors.Reset();
+	OwnerlessActors.Reset();
+}
+
+void UBlasterReplicationGraph::InitGlobalActorClassSettings()
+{
+	Super::InitGlobalActorClassSettings();
+
+	ExplicitClassPolicies.Reset();
+	ClassRepNodePolicies.Reset();
+
+	//PlayerController 와 그 Pawn, 뷰 타겟은 연결별 노드가 모음
+	ExplicitClassPolicies.Add(APlayerController::StaticClass(), EBlasterClassRepNodeMapping::NotRouted);
+	//PlayerState 는 FrequencyLimiter 노드가 월드에서 직접 모음
+	ExplicitClassPolicies.Add(APlayerState::StaticClass(), EBlasterClassRepNodeMapping::NotRouted);
+	ExplicitClassPolicies.Add(ALevelScriptActor::StaticClass(), EBlasterClassRepNodeMapping::NotRouted);
+	ExplicitClassPolicies.Add(AReplicationGraphDebugActor::StaticClass(), EBlasterClassRepNodeMapping::NotRouted);
+	ExplicitClassPolicies.Add(AGameStateBase::StaticClass(), EBlasterClassRepNodeMapping::RelevantAllConnections);
+	ExplicitClassPolicies.Add(ACharacter::StaticClass(), EBlasterClassRepNodeMapping::Spatialize_Dynamic);
+
+	//이미 로드된 클래스는 여기서 설정, 나중에 로드되는 블루프린트는 처음 복제될때 설정
+	for (TObjectIterator<UClass> It; It; ++It)
+	{
+		UClass* Class = *It;
+		AActor* ActorCDO = Cast<AActor>(Class->GetDefaultObject(false));
+		if (ActorCDO == nullptr || !ActorCDO->GetIsReplicated())
+		{
+			continue;
+		}
+		if (Class->GetName().StartsWith(TEXT("SKEL_")) || Class->GetName().StartsWith(TEXT("REINST_")))
+		{
+			continue;
+		}
+
+		const EBlasterClassRepNodeMapping Mapping = GetMappingPolicy(Class);
+		FClassReplicationInfo ClassInfo;
+		InitClassReplicationInfo(ClassInfo, Class, Mapping);
+		GlobalActorReplicationInfoMap.SetClassInfo(Class, ClassInfo);
+	}
+}
+
+void UBlasterReplicationGraph::InitGlobalGraphNodes()
+{
+	GridNode = CreateNewNode<UReplicationGraphNode_GridSpatialization2D>();
+	GridNode->CellSize = GridCellSize;
+	GridNode->SpatialBias = FVector2D(SpatialBiasX, SpatialBiasY);
+	if (bDisableSpatialRebuilds)
+	{
+		GridNode->AddToClassRebuildDenyList(AActor::StaticClass());
+	}
+	AddGlobalGraphNode(GridNode);
+
+	AlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_ActorList>();
+	AddGlobalGraphNode(AlwaysRelevantNode);
+
+	//100명분 PlayerState 를 매 프레임 전부 보내지 않고 나눠서 보냄
+	UReplicationGraphNode_PlayerStateFrequencyLimiter* PlayerStateNode = CreateNewNode<UReplicationGraphNode_PlayerStateFrequencyLimiter>();
+	PlayerStateNode->TargetActorsPerFrame = PlayerStatesPerFrame;
+	AddGlobalGraphNode(PlayerStateNode);
+}
+
+void UBlasterReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection)
+{
+	Super::InitConnectionGraphNodes(RepGraphConnection);
+
+	//뷰어(PlayerController, Pawn, 뷰 타겟)와 이 연결이 소유한 액터
+	UReplicationGraphNode_AlwaysRelevant_ForConnection* OwnerNode = CreateNewNode<UReplicationGraphNode_AlwaysRelevant_ForConnection>();
+	AddConnectionGraphNode(OwnerNode, RepGraphConnection);
+	OwnerNodes.Add(RepGraphConnection->NetConnection, OwnerNode);
+}
+
+void UBlasterReplicationGraph::RemoveClientConnection(UNetConnection* NetConnection)
+{
+	UReplicationGraphNode_AlwaysRelevant_ForConnection* OwnerNode = nullptr;
+	if (OwnerNodes.RemoveAndCopyValue(NetConnection, OwnerNode))
+	{
+		//연결이 끊겨도 액터는 남을 수 있음 (떨어뜨린 무기 등), 새 소유자를 기다림
+		for (auto It = OwnerRelevantActors.CreateIterator(); It; ++It)
+		{
+			if (It.Value() == OwnerNode)
+			{
+				AddOwnerlessActor(It.Key());
+				It.RemoveCurrent();
+			}
+		}
+	}
+
+	Super::RemoveClientConnection(NetConnection);
+}
+
+void UBlasterReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
+{
+	UClass* Class = ActorInfo.Class;
+	const bool bNewClass = !ClassRepNodePolicies.Contains(Class);
+	const EBlasterClassRepNodeMapping Mapping = GetMappingPolicy(Class);
+	if (bNewClass)
+	{
+		//처음 보는 클래스면 부모 클래스 설정을 받은 상태, 이 액터부터 자기 설정을 씀
+		FClassReplicationInfo ClassInfo;
+		InitClassReplicationInfo(ClassInfo, Class, Mapping);
+		GlobalActorReplicationInfoMap.SetClassInfo(Class, ClassInfo);
+		GlobalInfo.Settings = ClassInfo;
+	}
+
+	switch (Mapping)
+	{
+	case EBlasterClassRepNodeMapping::RelevantAllConnections:
+		AlwaysRelevantNode->NotifyAddNetworkActor(ActorInfo);
+		break;
+	case EBlasterClassRepNodeMapping::Spatialize_Static:
+		GridNode->AddActor_Static(ActorInfo, GlobalInfo);
+		break;
+	case EBlasterClassRepNodeMapping::Spatialize_Dynamic:
+		GridNode->AddActor_Dynamic(ActorInfo, GlobalInfo);
+		break;
+	case EBlasterClassRepNodeMapping::Spatialize_Dormancy:
+		GridNode->AddActor_Dormancy(ActorInfo, GlobalInfo);
+		break;
+	case EBlasterClassRepNodeMapping::RelevantToOwner:
+	case EBlasterClassRepNodeMapping::DependentOnOwner:
+		if (!AddOwnerRoutedActor(ActorInfo.Actor))
+		{
+			QueuePendingOwnerActor(ActorInfo.Actor);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+void UBlasterReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
+{
+	switch (GetMappingPolicy(ActorInfo.Class))
+	{
+	case EBlasterClassRepNodeMapping::RelevantAllConnections:
+		AlwaysRelevantNode->NotifyRemoveNetworkActor(ActorInfo);
+		break;
+	case EBlasterClassRepNodeMapping::Spatialize_Static:
+		GridNode->RemoveActor_Static(ActorInfo);
+		break;
+	case EBlasterClassRepNodeMapping::Spatialize_Dynamic:
+		GridNode->RemoveActor_Dynamic(ActorInfo);
+		break;
+	case EBlasterClassRepNodeMapping::Spatialize_Dormancy:
+		GridNode->RemoveActor_Dormancy(ActorInfo);
+		break;
+	case EBlasterClassRepNodeMapping::RelevantToOwner:
+	{
+		UReplicationGraphNode_AlwaysRelevant_ForConnection* OwnerNode = nullptr;
+		if (OwnerRelevantActors.RemoveAndCopyValue(ActorInfo.Actor, OwnerNode))
+		{
+			OwnerNode->NotifyRemoveNetworkActor(ActorInfo);
+		}
+		PendingOwnerActors.RemoveAllSwap([&ActorInfo](const FPendingOwnerActor& Pending) { return Pending.Actor == ActorInfo.Actor; });
+		RemoveOwnerlessActor(ActorInfo.Actor);
+		break;
+	}
+	case EBlasterClassRepNodeMapping::DependentOnOwner:
+	{
+		TWeakObjectPtr<AActor> Parent;
+		if (DependentActors.RemoveAndCopyValue(ActorInfo.Actor, Parent) && Parent.IsValid())
+		{
+			GlobalActorReplicationInfoMap.RemoveDependentActor(Parent.Get(), ActorInfo.Actor);
+		}
+		PendingOwnerActors.RemoveAllSwap([&ActorInfo](const FPendingOwnerActor& Pending) { return Pending.Actor == ActorInfo.Actor; });
+		RemoveOwnerlessActor(ActorInfo.Actor);
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+int32 UBlasterReplicationGraph::ServerReplicateActors(float DeltaSeconds)
+{
+	CSV_SCOPED_TIMING_STAT(BlasterNet, ServerReplicateActors);
+
+	RefreshOwnerRouting();
+	FlushPendingOwnerActors();
+
+	const double StartTime = FPlatformTime::Seconds();
+	const int32 NumReplicated = Super::ServerReplicateActors(DeltaSeconds);
+	ReplicateActorsSeconds += FPlatformTime::Seconds() - StartTime;
+	++ReplicateActorsFrames;
+	return NumReplicated;
+}
+
+void UBlasterReplicationGraph::ConsumeReplicateActorsTiming(double& OutSeconds, int32& OutFrames)
+{
+	OutSeconds = ReplicateActorsSeconds;
+	OutFrames = ReplicateActorsFrames;
+	ReplicateActorsSeconds = 0.0;
+	ReplicateActorsFrames = 0;
+}
+
+EBlasterClassRepNodeMapping UBlasterReplicationGraph::GetMappingPolicy(UClass* Class)
+{
+	if (const EBlasterClassRepNodeMapping* Mapping = ClassRepNodePolicies.Find(Class))
+	{
+		return *Mapping;
+	}
+	const EBlasterClassRepNodeMapping Mapping = ComputeMappingPolicy(Class);
+	ClassRepNodePolicies.Add(Class, Mapping);
+	return Mapping;
+}
+
+EBlasterClassRepNodeMapping UBlasterReplicationGraph::ComputeMappingPolicy(UClass* Class) const
+{
+	for (UClass* It = Class; It; It = It->GetSuperClass())
+	{
+		if (const EBlasterClassRepNodeMapping* Mapping = ExplicitClassPolicies.Find(It))
+		{
+			return *Mapping;
+		}
+	}
+
+	const AActor* ActorCDO = Cast<AActor>(Class->GetDefaultObject());
+	if (ActorCDO == nullptr || !ActorCDO->GetIsReplicated())
+	{
+		return EBlasterClassRepNodeMapping::NotRouted;
+	}
+	if (ActorCDO->bOnlyRelevantToOwner)
+	{
+		return EBlasterClassRepNodeMapping::RelevantToOwner;
+	}
+	if (ActorCDO->bNetUseOwnerRelevancy)
+	{
+		return EBlasterClassRepNodeMapping::DependentOnOwner;
+	}
+	if (ActorCDO->bAlwaysRelevant)
+	{
+		return EBlasterClassRepNodeMapping::RelevantAllConnections;
+	}
+
+	//블루프린트는 루트가 SCS 에 있어서 CDO 루트가 비어있을 수 있음, 그때는 움직이는 액터로 봄
+	const USceneComponent* RootComponent = ActorCDO->GetRootComponent();
+	if (RootComponent && RootComponent->Mobility == EComponentMobility::Static)
+	{
+		return EBlasterClassRepNodeMapping::Spatialize_Static;
+	}
+	if (ActorCDO->NetDormancy > DORM_Awake)
+	{
+		return EBlasterClassRepNodeMapping::Spatialize_Dormancy;
+	}
+	return EBlasterClassRepNodeMapping::Spatialize_Dynamic;
+}
+
+void UBlasterReplicationGraph::InitClassReplicationInfo(FClassReplicationInfo& ClassInfo, UClass* Class, EBlasterClassRepNodeMapping Mapping) const
+{
+	const AActor* ActorCDO = Cast<AActor>(Class->GetDefaultObject());
+	if (ActorCDO == nullptr)
+	{
+		return;
+	}
+	//DependentOnOwner 는 소유자가 없는 동안 그리드에 들어감
+	if (IsSpatialized(Mapping) || Mapping == EBlasterClassRepNodeMapping::DependentOnOwner)
+	{
+		ClassInfo.SetCullDistanceSquared(ActorCDO->GetNetCullDistanceSquared());
+	}
+	ClassInfo.ReplicationPeriodFrame = GetReplicationPeriodFrameForFrequency(ActorCDO->NetUpdateFrequency);
+}
+
+bool UBlasterReplicationGraph::AddOwnerRelevantActor(AActor* Actor)
+{
+	UNetConnection* NetConnection = Actor ? Actor->GetNetConnection() : nullptr;
+	UReplicationGraphNode_AlwaysRelevant_ForConnection** OwnerNode = NetConnection ? OwnerNodes.Find(NetConnection) : nullptr;
+	if (OwnerNode == nullptr)
+	{
+		return false;
+	}
+
+	(*OwnerNode)->NotifyAddNetworkActor(FNewReplicatedActorInfo(Actor));
+	OwnerRelevantActors.Add(Actor, *OwnerNode);
+	return true;
+}
+
+bool UBlasterReplicationGraph::AddDependentActor(AActor* Actor)
+{
+	AActor* Parent = Actor ? Actor->GetOwner() : nullptr;
+	if (Parent == nullptr)
+	{
+		return false;
+	}
+
+	GlobalActorReplicationInfoMap.AddDependentActor(Parent, Actor);
+	DependentActors.Add(Actor, Parent);
+	return true;
+}
+
+bool UBlasterReplicationGraph::AddOwnerRoutedActor(AActor* Actor)
+{
+	return GetMappingPolicy(Actor->GetClass()) == EBlasterClassRepNodeMapping::RelevantToOwner
+		? AddOwnerRelevantActor(Actor)
+		: AddDependentActor(Actor);
+}
+
+void UBlasterReplicationGraph::QueuePendingOwnerActor(AActor* Actor)
+{
+	FPendingOwnerActor& Pending = PendingOwnerActors.AddDefaulted_GetRef();
+	Pending.Actor = Actor;
+	Pending.QueuedFrame = GetReplicationGraphFrame();
+}
+
+void UBlasterReplicationGraph::FlushPendingOwnerActors()
+{
+	const uint32 Frame = GetReplicationGraphFrame();
+	for (int32 Index = PendingOwnerActors.Num() - 1; Index >= 0; --Index)
+	{
+		const FPendingOwnerActor& Pending = PendingOwnerActors[Index];
+		AActor* Actor = Pending.Actor.Get();
+		if (Actor == nullptr)
+		{
+			PendingOwnerActors.RemoveAtSwap(Index, 1, false);
+			continue;
+		}
+
+		if (AddOwnerRoutedActor(Actor))
+		{
+			PendingOwnerActors.RemoveAtSwap(Index, 1, false);
+		}
+		else if (Frame - Pending.QueuedFrame > static_cast<uint32>(FMath::Max(PendingOwnerMaxFrames, 0)))
+		{
+			UE_LOG(LogBlaster, Verbose, TEXT("%s has no owner after %d frames, waiting for an owner change"), *Actor->GetName(), PendingOwnerMaxFrames);
+			PendingOwnerActors.RemoveAtSwap(Index, 1, false);
+			AddOwnerlessActor(Actor);
+		}
+	}
+}
+
+void UBlasterReplicationGraph::AddOwnerlessActor(AActor* Actor)
+{
+	bool bAlreadyOwnerless = false;
+	OwnerlessActors.Add(Actor, &bAlreadyOwnerless);
+	//소유자 없이 bNetUseOwnerRelevancy 인 액터는 자기 위치로 판정됨, 엔진 기본 복제와 같게
+	if (!bAlreadyOwnerless && GetMappingPolicy(Actor->GetClass()) == EBlasterClassRepNodeMapping::DependentOnOwner)
+	{
+		GridNode->AddActor_Dynamic(FNewReplicatedActorInfo(Actor), GlobalActorReplicationInfoMap.Get(Actor));
+	}
+}
+
+void UBlasterReplicationGraph::RemoveOwnerlessActor(AActor* Actor)
+{
+	if (OwnerlessActors.Remove(Actor) > 0 && GetMappingPolicy(Actor->GetClass()) == EBlasterClassRepNodeMapping::DependentOnOwner)
+	{
+		GridNode->RemoveActor_Dynamic(FNewReplicatedActorInfo(Actor));
+	}
+}
+
+void UBlasterReplicationGraph::RefreshOwnerRouting()
+{
+	//소유자 기반 액터만 보므로 수가 적음, 바뀐 액터는 옛 노드에서 빼고 아래에서 다시 넣음
+	ReroutedActors.Reset();
+
+	for (auto It = OwnerRelevantActors.CreateIterator(); It; ++It)
+	{
+		AActor* Actor = It.Key();
+		UNetConnection* NetConnection = Actor->GetNetConnection();
+		UReplicationGraphNode_AlwaysRelevant_ForConnection* const* OwnerNode = NetConnection ? OwnerNodes.Find(NetConnection) : nullptr;
+		if (OwnerNode && *OwnerNode == It.Value())
+		{
+			continue;
+		}
+		It.Value()->NotifyRemoveNetworkActor(FNewReplicatedActorInfo(Actor));
+		It.RemoveCurrent();
+		ReroutedActors.Add(Actor);
+	}
+
+	for (auto It = DependentActors.CreateIterator(); It; ++It)
+	{
+		AActor* Actor = It.Key();
+		if (It.Value().Get() == Actor->GetOwner())
+		{
+			continue;
+		}
+		if (AActor* OldParent = It.Value().Get())
+		{
+			GlobalActorReplicationInfoMap.RemoveDependentActor(OldParent, Actor);
+		}
+		It.RemoveCurrent();
+		ReroutedActors.Add(Actor);
+	}
+
+	for (AActor* Actor : OwnerlessActors)
+	{
+		const bool bHasOwner = GetMappingPolicy(Actor->GetClass()) == EBlasterClassRepNodeMapping::RelevantToOwner
+			? Actor->GetNetConnection() && OwnerNodes.Contains(Actor->GetNetConnection())
+			: Actor->GetOwner() != nullptr;
+		if (bHasOwner)
+		{
+			ReroutedActors.Add(Actor);
+		}
+	}
+
+	for (AActor* Actor : ReroutedActors)
+	{
+		RemoveOwnerlessActor(Actor);
+		if (!AddOwnerRoutedActor(Actor))
+		{
+			QueuePendingOwnerActor(Actor);
+		}
+	}
+}
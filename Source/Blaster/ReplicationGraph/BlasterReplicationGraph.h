@@ -0,0 +1,131 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+#include "BlasterReplicationGraph.generated.h"
+
+class UReplicationGraphNode_GridSpatialization2D;
+class UReplicationGraphNode_ActorList;
+class UReplicationGraphNode_AlwaysRelevant_ForConnection;
+
+/** 액터 클래스를 그래프의 어느 노드로 보낼지 */
+enum class EBlasterClassRepNodeMapping : uint8
+{
+	// 그래프에 넣지 않음 (연결별 노드나 전용 노드가 직접 모음)
+	NotRouted,
+	// 모든 연결에 항상 (GameState 등)
+	RelevantAllConnections,
+	// 움직이지 않는 액터, 그리드에 한번만 넣음
+	Spatialize_Static,
+	// 캐릭터, 발사체처럼 계속 움직이는 액터
+	Spatialize_Dynamic,
+	// 휴면중에는 정적, 깨어나면 동적
+	Spatialize_Dormancy,
+	// bOnlyRelevantToOwner, 소유 연결의 노드에만
+	RelevantToOwner,
+	// bNetUseOwnerRelevancy, 소유 액터가 복제될때 같이
+	DependentOnOwner,
+};
+
+/**
+ * 100명 매치용 Replication Graph
+ * 캐릭터와 발사체는 2D 그리드로 가까운 연결에만, GameState 같은 액터는 전체 연결에,
+ * 소유자에게만 보이는 액터는 그 연결의 노드에 넣어서 매 틱 액터 x 연결 전부를 검사하지 않음
+ * GameNetDriver 에만 붙고 Blaster.RepGraph.Enable 0 이면 기존 방식으로 복제
+ */
+UCLASS(Transient, Config = Engine)
+class BLASTER_API UBlasterReplicationGraph : public UReplicationGraph
+{
+	GENERATED_BODY()
+public:
+	UBlasterReplicationGraph();
+
+	//~ Begin UReplicationGraph Interface
+	virtual void ResetGameNetState() override;
+	virtual void InitGlobalActorClassSettings() override;
+	virtual void InitGlobalGraphNodes() override;
+	virtual void InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection) override;
+	virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
+	virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+	virtual void RemoveClientConnection(UNetConnection* NetConnection) override;
+	virtual int32 ServerReplicateActors(float DeltaSeconds) override;
+	//~ End UReplicationGraph Interface
+
+	// 벤치마크용, 마지막으로 가져간 뒤 ServerReplicateActors 에 쓴 시간
+	void ConsumeReplicateActorsTiming(double& OutSeconds, int32& OutFrames);
+
+	UPROPERTY()
+	UReplicationGraphNode_GridSpatialization2D* GridNode{ nullptr };
+
+	UPROPERTY()
+	UReplicationGraphNode_ActorList* AlwaysRelevantNode{ nullptr };
+
+protected:
+	UPROPERTY(Config)
+	float GridCellSize{ 10000.f };
+
+	// 맵의 가장 작은 X, Y 보다 작게, 셀 인덱스가 음수가 되지 않도록
+	UPROPERTY(Config)
+	float SpatialBiasX{ -150000.f };
+
+	UPROPERTY(Config)
+	float SpatialBiasY{ -200000.f };
+
+	// 셀 경계를 넘을때 그리드를 다시 만들지 않음, 큰 맵에서 재구성 비용이 튀는 것을 막음
+	UPROPERTY(Config)
+	bool bDisableSpatialRebuilds{ true };
+
+	// PlayerState 는 프레임마다 이 수만큼 나눠서 보냄
+	UPROPERTY(Config)
+	int32 PlayerStatesPerFrame{ 10 };
+
+	// 소유 연결을 모르는 액터를 매 프레임 다시 시도하는 기간, 지나면 소유자가 바뀔때만 다시 넣음
+	UPROPERTY(Config)
+	int32 PendingOwnerMaxFrames{ 60 };
+
+private:
+	EBlasterClassRepNodeMapping GetMappingPolicy(UClass* Class);
+	EBlasterClassRepNodeMapping ComputeMappingPolicy(UClass* Class) const;
+	void InitClassReplicationInfo(FClassReplicationInfo& ClassInfo, UClass* Class, EBlasterClassRepNodeMapping Mapping) const;
+	static bool IsSpatialized(EBlasterClassRepNodeMapping Mapping)
+	{
+		return Mapping >= EBlasterClassRepNodeMapping::Spatialize_Static && Mapping <= EBlasterClassRepNodeMapping::Spatialize_Dormancy;
+	}
+
+	bool AddOwnerRelevantActor(AActor* Actor);
+	bool AddDependentActor(AActor* Actor);
+	bool AddOwnerRoutedActor(AActor* Actor);
+	void QueuePendingOwnerActor(AActor* Actor);
+	void FlushPendingOwnerActors();
+	void AddOwnerlessActor(AActor* Actor);
+	void RemoveOwnerlessActor(AActor* Actor);
+	// SetOwner 는 그래프에 알려주지 않아서 소유자 기반 액터의 소유자가 바뀌었는지 직접 확인함
+	void RefreshOwnerRouting();
+
+	struct FPendingOwnerActor
+	{
+		TWeakObjectPtr<AActor> Actor;
+		uint32 QueuedFrame{ 0 };
+	};
+
+	// 직접 지정한 정책, 하위 클래스도 따름
+	TMap<UClass*, EBlasterClassRepNodeMapping> ExplicitClassPolicies;
+	// 클래스별로 한번 계산한 정책
+	TMap<UClass*, EBlasterClassRepNodeMapping> ClassRepNodePolicies;
+
+	TMap<UNetConnection*, UReplicationGraphNode_AlwaysRelevant_ForConnection*> OwnerNodes;
+	// 소유자에게만 보이는 액터가 들어간 노드, 제거할때는 소유자가 이미 없을 수 있음
+	TMap<AActor*, UReplicationGraphNode_AlwaysRelevant_ForConnection*> OwnerRelevantActors;
+	TMap<AActor*, TWeakObjectPtr<AActor>> DependentActors;
+	// 스폰 직후라 소유 연결을 아직 모르는 액터, PendingOwnerMaxFrames 동안 매 틱 다시 시도
+	TArray<FPendingOwnerActor> PendingOwnerActors;
+	// 대기 기간이 지나도 소유자가 없는 액터, DependentOnOwner 는 그동안 자기 자신으로 그리드에 들어감
+	TSet<AActor*> OwnerlessActors;
+	// RefreshOwnerRouting 에서 다시 넣을 액터, 프레임마다 재사용
+	TArray<AActor*> ReroutedActors;
+
+	double ReplicateActorsSeconds{ 0.0 };
+	int32 ReplicateActorsFrames{ 0 };
+};
@@ -0,0 +1,325 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Weapon/BlasterHitscanSubsystem.h"
+#include "Blaster.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "HAL/IConsoleManager.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+DECLARE_CYCLE_STAT(TEXT("Hitscan Queue"), STAT_BlasterHitscanQueue, STATGROUP_BlasterNet);
+DECLARE_CYCLE_STAT(TEXT("Hitscan Submit"), STAT_BlasterHitscanSubmit, STATGROUP_BlasterNet);
+DECLARE_CYCLE_STAT(TEXT("Hitscan Trace Done"), STAT_BlasterHitscanTraceDone, STATGROUP_BlasterNet);
+DECLARE_CYCLE_STAT(TEXT("Hitscan Resolve"), STAT_BlasterHitscanResolve, STATGROUP_BlasterNet);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hitscan Traces"), STAT_BlasterHitscanTraces, STATGROUP_BlasterNet);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hitscan Volleys"), STAT_BlasterHitscanVolleys, STATGROUP_BlasterNet);
+
+CSV_DECLARE_CATEGORY_EXTERN(BlasterNet);
+
+namespace BlasterHitscan
+{
+	static int32 Async = 1;
+	static FAutoConsoleVariableRef CVarAsync(
+		TEXT("Blaster.Hitscan.Async"),
+		Async,
+		TEXT("1: 히트스캔 트레이스를 모아서 비동기로 처리, 0: 큐에 넣을때 바로 LineTraceSingleByChannel"),
+		ECVF_Default);
+
+	// FBlasterHitscanStats::GameThreadSeconds 에 더함
+	struct FScopedGameThreadTime
+	{
+		explicit FScopedGameThreadTime(double& InSeconds)
+			: Seconds(InSeconds)
+			, StartCycles(FPlatformTime::Cycles64())
+		{
+		}
+
+		~FScopedGameThreadTime()
+		{
+			Seconds += FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles);
+		}
+
+		double& Seconds;
+		uint64 StartCycles;
+	};
+}
+
+void UBlasterHitscanSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	TraceDoneDelegate.BindUObject(this, &UBlasterHitscanSubsystem::OnTraceDone);
+}
+
+void UBlasterHitscanSubsystem::Deinitialize()
+{
+	//아직 안 온 트레이스 결과는 맞는 배치가 없어서 버려짐
+	Batches.Reset();
+	QueuedBatch = INDEX_NONE;
+
+	Super::Deinitialize();
+}
+
+bool UBlasterHitscanSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UBlasterHitscanSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	//결과 콜백에서 다시 쏘면 여기에 쌓임, 처리하는 동안 Batches 가 늘어나서 참조가 깨지지 않게 미리 잡아둠
+	AcquireQueuedBatch();
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_BlasterHitscanResolve);
+		CSV_SCOPED_TIMING_STAT(BlasterNet, HitscanResolve);
+
+		for (FBlasterHitscanBatch& Batch : Batches)
+		{
+			if (!Batch.bSubmitted)
+			{
+				continue;
+			}
+			if (Batch.NumPending > 0 && GFrameCounter <= Batch.SubmitFrame + MaxPendingFrames)
+			{
+				continue;
+			}
+			if (Batch.NumPending > 0)
+			{
+				UE_LOG(LogBlaster, Verbose, TEXT("Hitscan batch resolved with %d traces still pending"), Batch.NumPending);
+			}
+			ResolveBatch(Batch);
+		}
+	}
+
+	SubmitQueuedBatch();
+}
+
+TStatId UBlasterHitscanSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UBlasterHitscanSubsystem, STATGROUP_Tickables);
+}
+
+void UBlasterHitscanSubsystem::QueueVolley(const FVector& Start, TConstArrayView<FVector> Ends, const AActor* Shooter, double ShotServerTime, FBlasterHitscanVolleyComplete OnComplete)
+{
+	SCOPE_CYCLE_COUNTER(STAT_BlasterHitscanQueue);
+	BlasterHitscan::FScopedGameThreadTime Timer(Stats.GameThreadSeconds);
+
+	if (Ends.Num() == 0)
+	{
+		return;
+	}
+
+	const UBlasterLagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<UBlasterLagCompensationSubsystem>();
+	FBlasterHitscanBatch& Batch = Batches[AcquireQueuedBatch()];
+
+	FBlasterHitscanVolley& Volley = Batch.Volleys.AddDefaulted_GetRef();
+	Volley.Shooter = Shooter;
+	Volley.Start = Start;
+	Volley.ShotServerTime = ShotServerTime;
+	Volley.FirstShot = Batch.Ends.Num();
+	Volley.NumShots = Ends.Num();
+	Volley.bRewind = ShotServerTime >= 0.0 && LagCompensation && LagCompensation->IsRecording();
+	Volley.OnComplete = MoveTemp(OnComplete);
+
+	Batch.Ends.Append(Ends.GetData(), Ends.Num());
+	for (const FVector& End : Ends)
+	{
+		Batch.Hits.Emplace(Start, End);
+	}
+
+	++Stats.NumVolleys;
+	INC_DWORD_STAT(STAT_BlasterHitscanVolleys);
+
+	if (!IsAsyncEnabled())
+	{
+		//무기 발사 함수에서 바로 트레이스하던 방식, 비교용
+		const FCollisionQueryParams QueryParams = MakeQueryParams(Shooter, Volley.bRewind);
+		for (int32 Shot = Volley.FirstShot; Shot < Volley.FirstShot + Volley.NumShots; ++Shot)
+		{
+			FHitResult TraceHit;
+			if (GetWorld()->LineTraceSingleByChannel(TraceHit, Start, Batch.Ends[Shot], TraceChannel, QueryParams))
+			{
+				Batch.Hits[Shot] = TraceHit;
+			}
+		}
+		Volley.bTraced = true;
+	}
+}
+
+bool UBlasterHitscanSubsystem::IsAsyncEnabled() const
+{
+	return bAsyncEnabled && BlasterHitscan::Async != 0;
+}
+
+int32 UBlasterHitscanSubsystem::GetNumQueuedTraces() const
+{
+	return QueuedBatch != INDEX_NONE ? Batches[QueuedBatch].Ends.Num() : 0;
+}
+
+int32 UBlasterHitscanSubsystem::AcquireQueuedBatch()
+{
+	if (QueuedBatch == INDEX_NONE)
+	{
+		QueuedBatch = Batches.IndexOfByPredicate([](const FBlasterHitscanBatch& Batch) { return !Batch.bSubmitted; });
+		if (QueuedBatch == INDEX_NONE)
+		{
+			QueuedBatch = Batches.AddDefaulted();
+		}
+	}
+	return QueuedBatch;
+}
+
+void UBlasterHitscanSubsystem::SubmitQueuedBatch()
+{
+	if (QueuedBatch == INDEX_NONE || Batches[QueuedBatch].Volleys.Num() == 0)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_BlasterHitscanSubmit);
+	BlasterHitscan::FScopedGameThreadTime Timer(Stats.GameThreadSeconds);
+
+	const int32 BatchIndex = QueuedBatch;
+	QueuedBatch = INDEX_NONE;
+
+	FBlasterHitscanBatch& Batch = Batches[BatchIndex];
+	Batch.bSubmitted = true;
+	Batch.SubmitFrame = GFrameCounter;
+	Batch.NumPending = 0;
+
+	const int32 NumTraces = Batch.Ends.Num();
+	Stats.NumTraces += NumTraces;
+	Stats.MaxTracesPerFrame = FMath::Max(Stats.MaxTracesPerFrame, NumTraces);
+	INC_DWORD_STAT_BY(STAT_BlasterHitscanTraces, NumTraces);
+	CSV_CUSTOM_STAT(BlasterNet, HitscanTraces, NumTraces, ECsvCustomStatOp::Set);
+
+	//AsyncLineTraceByChannel 은 요청을 버퍼에 복사만 함, 프레임 끝에 묶음 단위로 워커 스레드에서 실행되고
+	//다음 프레임 시작때 OnTraceDone 이 불림. 델리게이트는 트레이스마다 복사되므로 페이로드 없는 멤버 하나를 넘기고
+	//배치는 트레이스 버퍼 프레임 번호로, 샷은 UserData 로 찾음
+	UWorld* World = GetWorld();
+	for (const FBlasterHitscanVolley& Volley : Batch.Volleys)
+	{
+		if (Volley.bTraced)
+		{
+			continue;
+		}
+
+		const FCollisionQueryParams QueryParams = MakeQueryParams(Volley.Shooter.Get(), Volley.bRewind);
+		for (int32 Shot = Volley.FirstShot; Shot < Volley.FirstShot + Volley.NumShots; ++Shot)
+		{
+			const FTraceHandle Handle = World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Volley.Start, Batch.Ends[Shot], TraceChannel, QueryParams, FCollisionResponseParams::DefaultResponseParam, &TraceDoneDelegate, Shot);
+			Batch.TraceFrameNumber = Handle._Data.FrameNumber;
+			++Batch.NumPending;
+		}
+	}
+}
+
+void UBlasterHitscanSubsystem::OnTraceDone(const FTraceHandle& Handle, FTraceDatum& Datum)
+{
+	SCOPE_CYCLE_COUNTER(STAT_BlasterHitscanTraceDone);
+	BlasterHitscan::FScopedGameThreadTime Timer(Stats.GameThreadSeconds);
+
+	//시간 초과로 먼저 처리된 배치의 늦은 결과는 맞는 배치가 없어서 버려짐
+	FBlasterHitscanBatch* FoundBatch = Batches.FindByPredicate([&Datum](const FBlasterHitscanBatch& Batch)
+		{
+			return Batch.bSubmitted && Batch.NumPending > 0 && Batch.TraceFrameNumber == Datum.FrameNumber;
+		});
+	if (FoundBatch == nullptr || !FoundBatch->Hits.IsValidIndex(Datum.UserData))
+	{
+		return;
+	}
+
+	FBlasterHitscanBatch& Batch = *FoundBatch;
+	if (Datum.OutHits.Num() > 0)
+	{
+		Batch.Hits[Datum.UserData] = Datum.OutHits[0];
+	}
+	--Batch.NumPending;
+}
+
+void UBlasterHitscanSubsystem::ResolveBatch(FBlasterHitscanBatch& Batch)
+{
+	UBlasterLagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<UBlasterLagCompensationSubsystem>();
+
+	for (FBlasterHitscanVolley& Volley : Batch.Volleys)
+	{
+		const TArrayView<FHitResult> Hits = MakeArrayView(Batch.Hits).Slice(Volley.FirstShot, Volley.NumShots);
+		{
+			BlasterHitscan::FScopedGameThreadTime Timer(Stats.GameThreadSeconds);
+
+			if (Volley.bRewind && LagCompensation)
+			{
+				//월드에 막힌 샷은 막힌 곳까지만 되감은 캐릭터와 판정
+				const TArrayView<FVector> Ends = MakeArrayView(Batch.Ends).Slice(Volley.FirstShot, Volley.NumShots);
+				for (int32 Shot = 0; Shot < Hits.Num(); ++Shot)
+				{
+					if (Hits[Shot].bBlockingHit)
+					{
+						Ends[Shot] = Hits[Shot].Location;
+					}
+				}
+
+				RewindHits.SetNum(Hits.Num(), false);
+				if (LagCompensation->ConfirmHitscanBatch(Volley.Start, Ends, Volley.ShotServerTime, Volley.Shooter.Get(), RewindHits) > 0)
+				{
+					for (int32 Shot = 0; Shot < Hits.Num(); ++Shot)
+					{
+						ACharacter* Character = RewindHits[Shot].Character;
+						if (Character == nullptr)
+						{
+							continue;
+						}
+
+						FHitResult& Hit = Hits[Shot];
+						const FVector TraceStart = Hit.TraceStart;
+						const FVector TraceEnd = Hit.TraceEnd;
+						Hit = FHitResult(Character, Character->GetCapsuleComponent(), RewindHits[Shot].Location, (TraceStart - TraceEnd).GetSafeNormal());
+						Hit.bBlockingHit = true;
+						Hit.TraceStart = TraceStart;
+						Hit.TraceEnd = TraceEnd;
+						Hit.Distance = FVector::Dist(TraceStart, Hit.Location);
+						Hit.Time = Hit.Distance / FMath::Max(FVector::Dist(TraceStart, TraceEnd), UE_KINDA_SMALL_NUMBER);
+					}
+				}
+			}
+
+			for (const FHitResult& Hit : Hits)
+			{
+				Stats.NumHits += Hit.bBlockingHit ? 1 : 0;
+			}
+		}
+
+		Volley.OnComplete.ExecuteIfBound(Hits);
+	}
+
+	Batch.Volleys.Reset();
+	Batch.Ends.Reset();
+	Batch.Hits.Reset();
+	Batch.NumPending = 0;
+	Batch.bSubmitted = false;
+}
+
+FCollisionQueryParams UBlasterHitscanSubsystem::MakeQueryParams(const AActor* Shooter, bool bRewind) const
+{
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(BlasterHitscan), false, Shooter);
+	if (Shooter)
+	{
+		//무기로 쏘면 무기를 든 캐릭터도 제외
+		QueryParams.AddIgnoredActor(Shooter->GetOwner());
+		QueryParams.AddIgnoredActor(Shooter->GetInstigator());
+	}
+	if (bRewind)
+	{
+		//기록 중인 캐릭터만 되감은 기록으로 판정하고 지금 위치는 무시함, 기록 안 된 폰 (가득 찬 경우, 탈것 등) 은 그대로 막힘
+		if (const UBlasterLagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<UBlasterLagCompensationSubsystem>())
+		{
+			LagCompensation->AddRecordedCharactersToIgnore(QueryParams);
+		}
+	}
+	return QueryParams;
+}
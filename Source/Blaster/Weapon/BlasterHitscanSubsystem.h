@@ -0,0 +1,115 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/HitResult.h"
+#include "WorldCollision.h"
+#include "Net/BlasterLagCompensationSubsystem.h"
+#include "BlasterHitscanSubsystem.generated.h"
+
+// Hits 는 QueueVolley 에 넘긴 Ends 와 같은 순서, 안 맞은 샷은 bBlockingHit 가 false
+DECLARE_DELEGATE_OneParam(FBlasterHitscanVolleyComplete, TConstArrayView<FHitResult> /*Hits*/);
+
+// 한번 쏜 것 (산탄이면 펠릿 전부)
+struct FBlasterHitscanVolley
+{
+	TWeakObjectPtr<const AActor> Shooter;
+	FVector Start{ FVector::ZeroVector };
+	double ShotServerTime{ 0.0 };
+	int32 FirstShot{ 0 };
+	int32 NumShots{ 0 };
+	bool bRewind{ false };
+	// 동기 모드에서 큐에 넣을때 이미 트레이스함
+	bool bTraced{ false };
+	FBlasterHitscanVolleyComplete OnComplete;
+};
+
+// 한 프레임 동안 쌓인 볼리들, 통째로 제출되고 통째로 처리됨
+struct FBlasterHitscanBatch
+{
+	TArray<FBlasterHitscanVolley> Volleys;
+	TArray<FVector> Ends;
+	TArray<FHitResult> Hits;
+	// 제출한 프레임의 비동기 트레이스 버퍼 번호, 결과가 어느 배치 것인지 이걸로 찾음
+	uint32 TraceFrameNumber{ 0 };
+	int32 NumPending{ 0 };
+	uint64 SubmitFrame{ 0 };
+	bool bSubmitted{ false };
+};
+
+struct FBlasterHitscanStats
+{
+	int64 NumVolleys{ 0 };
+	int64 NumTraces{ 0 };
+	int64 NumHits{ 0 };
+	int32 MaxTracesPerFrame{ 0 };
+	// 큐잉, 제출, 트레이스 콜백, 결과 처리에 게임 스레드가 쓴 시간 (동기 모드면 트레이스 자체 포함)
+	double GameThreadSeconds{ 0.0 };
+};
+
+/**
+ * 히트스캔 무기의 라인 트레이스를 모아서 비동기로 처리
+ * 한 프레임에 쏜 샷 (여러 플레이어, 산탄 펠릿) 을 큐에 쌓았다가 틱에서 한번에 AsyncLineTraceByChannel 로 제출하고,
+ * 다음 프레임 틱에서 볼리 단위로 결과를 넘겨줌. 트레이스는 워커 스레드에서 돌아서 게임 스레드 비용은 샷 수에 거의 비례하지 않음
+ * 서버에서 ShotServerTime 을 주면 캐릭터는 UBlasterLagCompensationSubsystem 으로 되감아 판정함
+ * Blaster.Hitscan.Async 0 이면 큐에 넣을때 바로 LineTraceSingleByChannel 로 처리함 (비교용, 결과는 똑같이 다음 틱에 옴)
+ */
+UCLASS(Config = Game)
+class BLASTER_API UBlasterHitscanSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+public:
+	//~ Begin UWorldSubsystem Interface
+	virtual void Deinitialize() override;
+	//~ End UWorldSubsystem Interface
+
+	//~ Begin FTickableGameObject Interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~ End FTickableGameObject Interface
+
+	// Ends 하나당 트레이스 하나. ShotServerTime 이 0 이상이고 서버면 캐릭터는 그 시점으로 되감아 판정함
+	void QueueVolley(const FVector& Start, TConstArrayView<FVector> Ends, const AActor* Shooter, double ShotServerTime, FBlasterHitscanVolleyComplete OnComplete);
+
+	bool IsAsyncEnabled() const;
+	void SetAsyncEnabled(bool bEnabled) { bAsyncEnabled = bEnabled; }
+	int32 GetNumQueuedTraces() const;
+
+	const FBlasterHitscanStats& GetStats() const { return Stats; }
+	void ResetStats() { Stats = FBlasterHitscanStats(); }
+
+	static constexpr double NoRewind = -1.0;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	UPROPERTY(Config)
+	TEnumAsByte<ECollisionChannel> TraceChannel{ ECC_Visibility };
+
+	// 제출하고 이 프레임 수가 지나도 결과가 다 안 오면 (월드 일시정지 등) 온 것만으로 처리함
+	UPROPERTY(Config)
+	int32 MaxPendingFrames{ 4 };
+
+private:
+	int32 AcquireQueuedBatch();
+	void SubmitQueuedBatch();
+	void ResolveBatch(FBlasterHitscanBatch& Batch);
+	void OnTraceDone(const FTraceHandle& Handle, FTraceDatum& Datum);
+	FCollisionQueryParams MakeQueryParams(const AActor* Shooter, bool bRewind) const;
+
+	// 제출된 배치는 결과가 다 올때까지 남아있고, 처리가 끝나면 배열 용량째로 재사용됨
+	TArray<FBlasterHitscanBatch> Batches;
+	int32 QueuedBatch{ INDEX_NONE };
+
+	// 한번만 바인딩, 엔진이 트레이스마다 복사하므로 페이로드 없이 가볍게 둠
+	FTraceDelegate TraceDoneDelegate;
+
+	// 볼리 하나 되감기 판정용
+	TArray<FBlasterRewindHit> RewindHits;
+
+	FBlasterHitscanStats Stats;
+	bool bAsyncEnabled{ true };
+};
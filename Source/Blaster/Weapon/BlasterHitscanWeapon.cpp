@@ -0,0 +1,170 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Weapon/BlasterHitscanWeapon.h"
+#include "Weapon/BlasterHitscanSubsystem.h"
+#include "Net/BlasterPushModel.h"
+#include "Engine/World.h"
+#include "GameFramework/DamageType.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/Pawn.h"
+#include "Kismet/GameplayStatics.h"
+#include "Net/UnrealNetwork.h"
+
+ABlasterHitscanWeapon::ABlasterHitscanWeapon()
+{
+	PrimaryActorTick.bCanEverTick = false;
+	bReplicates = true;
+	DamageType = UDamageType::StaticClass();
+}
+
+void ABlasterHitscanWeapon::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	Params.Condition = COND_OwnerOnly;
+	DOREPLIFETIME_WITH_PARAMS_FAST(ABlasterHitscanWeapon, Ammo, Params);
+}
+
+void ABlasterHitscanWeapon::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+
+	BlasterPushModel::CountComparedProperties(this);
+}
+
+void ABlasterHitscanWeapon::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (HasAuthority())
+	{
+		Ammo = FMath::Max(MagazineSize, 0);
+		BLASTER_MARK_PROPERTY_DIRTY(ABlasterHitscanWeapon, Ammo, this);
+		ServerShotBudget = FMath::Max(MaxBurstShots, 1.f);
+		LastServerShotTime = GetWorld()->GetTimeSeconds();
+	}
+}
+
+void ABlasterHitscanWeapon::Fire(const FVector& Start, const FVector& Direction)
+{
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	const double ShotServerTime = GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+
+	if (HasAuthority())
+	{
+		if (ConsumeServerShot())
+		{
+			FireVolley(Start, Direction.GetSafeNormal(), ShotServerTime);
+		}
+	}
+	//빈 탄창이면 서버가 어차피 버리니 보내지 않음
+	else if (MagazineSize <= 0 || Ammo > 0)
+	{
+		ServerFire(Start, Direction.GetSafeNormal(), ShotServerTime);
+	}
+}
+
+void ABlasterHitscanWeapon::AddAmmo(int32 Amount)
+{
+	if (!HasAuthority() || MagazineSize <= 0)
+	{
+		return;
+	}
+	Ammo = FMath::Clamp(Ammo + Amount, 0, MagazineSize);
+	BLASTER_MARK_PROPERTY_DIRTY(ABlasterHitscanWeapon, Ammo, this);
+}
+
+void ABlasterHitscanWeapon::ServerFire_Implementation(const FVector_NetQuantize& Start, const FVector_NetQuantizeNormal& Direction, double ShotServerTime)
+{
+	//너무 먼 과거로 되감는 건 UBlasterLagCompensationSubsystem 이 막음
+	FVector ClampedStart = Start;
+	if (!ClampServerStart(ClampedStart) || !ConsumeServerShot())
+	{
+		return;
+	}
+	FireVolley(ClampedStart, Direction, ShotServerTime);
+}
+
+bool ABlasterHitscanWeapon::ConsumeServerShot()
+{
+	//Unreliable 이라 몰려 오는 건 봐주되 평균 속도는 FireInterval 을 넘지 못함
+	const double Now = GetWorld()->GetTimeSeconds();
+	const float MaxBudget = FMath::Max(MaxBurstShots, 1.f);
+	ServerShotBudget = FireInterval > 0.f
+		? FMath::Min(ServerShotBudget + static_cast<float>((Now - LastServerShotTime) / FireInterval), MaxBudget)
+		: MaxBudget;
+	LastServerShotTime = Now;
+	if (ServerShotBudget < 1.f)
+	{
+		return false;
+	}
+	if (MagazineSize > 0 && Ammo <= 0)
+	{
+		return false;
+	}
+
+	ServerShotBudget -= 1.f;
+	if (MagazineSize > 0)
+	{
+		--Ammo;
+		BLASTER_MARK_PROPERTY_DIRTY(ABlasterHitscanWeapon, Ammo, this);
+	}
+	return true;
+}
+
+bool ABlasterHitscanWeapon::ClampServerStart(FVector& Start) const
+{
+	const APawn* OwnerPawn = GetInstigator() ? GetInstigator() : Cast<APawn>(GetOwner());
+	if (OwnerPawn == nullptr)
+	{
+		return false;
+	}
+	//눈 위치(카메라에서 쏘는 경우)와 총 위치 중 가까운 쪽 기준
+	const FVector EyeLocation = OwnerPawn->GetPawnViewLocation();
+	const FVector MuzzleLocation = GetActorLocation();
+	const FVector Anchor = FVector::DistSquared(Start, EyeLocation) <= FVector::DistSquared(Start, MuzzleLocation) ? EyeLocation : MuzzleLocation;
+	Start = Anchor + (Start - Anchor).GetClampedToMaxSize(MaxStartOffset);
+	return true;
+}
+
+void ABlasterHitscanWeapon::FireVolley(const FVector& Start, const FVector& Direction, double ShotServerTime)
+{
+	UBlasterHitscanSubsystem* Hitscan = GetWorld()->GetSubsystem<UBlasterHitscanSubsystem>();
+	if (Hitscan == nullptr)
+	{
+		return;
+	}
+
+	const float HalfAngle = FMath::DegreesToRadians(SpreadDegrees);
+	const int32 NumPellets = FMath::Max(PelletsPerShot, 1);
+	PelletEnds.Reset(NumPellets);
+	for (int32 Pellet = 0; Pellet < NumPellets; ++Pellet)
+	{
+		const FVector PelletDirection = HalfAngle > 0.f ? FMath::VRandCone(Direction, HalfAngle) : Direction;
+		PelletEnds.Add(Start + PelletDirection * Range);
+	}
+
+	Hitscan->QueueVolley(Start, PelletEnds, this, ShotServerTime, FBlasterHitscanVolleyComplete::CreateUObject(this, &ABlasterHitscanWeapon::OnVolleyComplete));
+}
+
+void ABlasterHitscanWeapon::OnVolleyComplete(TConstArrayView<FHitResult> Hits)
+{
+	AController* InstigatorController = GetInstigatorController();
+	for (const FHitResult& Hit : Hits)
+	{
+		if (!Hit.bBlockingHit)
+		{
+			continue;
+		}
+
+		AActor* HitActor = Hit.GetActor();
+		if (HitActor && Damage > 0.f)
+		{
+			UGameplayStatics::ApplyPointDamage(HitActor, Damage, (Hit.TraceEnd - Hit.TraceStart).GetSafeNormal(), Hit, InstigatorController, this, DamageType);
+		}
+		ReceiveHitscanHit(Hit);
+	}
+}
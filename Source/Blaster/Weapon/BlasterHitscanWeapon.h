@@ -0,0 +1,101 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Engine/NetSerialization.h"
+#include "BlasterHitscanWeapon.generated.h"
+
+class UDamageType;
+
+/**
+ * 히트스캔 무기 (자동 소총, 산탄총)
+ * 발사 함수에서 트레이스하지 않고 UBlasterHitscanSubsystem 큐에 펠릿을 넣기만 함, 데미지는 다음 프레임 결과에서 줌
+ * 클라이언트는 쏜 시점의 서버 시간을 같이 보내서 서버가 캐릭터를 되감아 판정함
+ * 서버는 시작점, 연사 속도, 탄약을 직접 확인하고 맞지 않는 요청은 버림
+ */
+UCLASS()
+class BLASTER_API ABlasterHitscanWeapon : public AActor
+{
+	GENERATED_BODY()
+public:
+	ABlasterHitscanWeapon();
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
+
+	// 소유한 클라이언트나 서버에서 호출, 클라이언트면 서버로 보냄
+	UFUNCTION(BlueprintCallable)
+	void Fire(const FVector& Start, const FVector& Direction);
+
+	// 서버에서 호출 (재장전, 탄약 줍기), MagazineSize 를 넘지 않음
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly)
+	void AddAmmo(int32 Amount);
+
+	UFUNCTION(BlueprintPure)
+	int32 GetAmmo() const { return Ammo; }
+
+protected:
+	virtual void BeginPlay() override;
+
+	UFUNCTION(Server, Unreliable)
+	void ServerFire(const FVector_NetQuantize& Start, const FVector_NetQuantizeNormal& Direction, double ShotServerTime);
+
+	// 서버에서 맞은 펠릿마다, 데미지는 적용된 뒤
+	UFUNCTION(BlueprintImplementableEvent, meta = (DisplayName = "On Hitscan Hit"))
+	void ReceiveHitscanHit(const FHitResult& Hit);
+
+	// 한번 쏠때 트레이스 수, 산탄총은 1 보다 크게
+	UPROPERTY(EditDefaultsOnly, Category = "Weapon")
+	int32 PelletsPerShot{ 1 };
+
+	// 펠릿이 퍼지는 원뿔의 반각
+	UPROPERTY(EditDefaultsOnly, Category = "Weapon")
+	float SpreadDegrees{ 0.f };
+
+	UPROPERTY(EditDefaultsOnly, Category = "Weapon")
+	float Range{ 20000.f };
+
+	// 펠릿 하나당
+	UPROPERTY(EditDefaultsOnly, Category = "Weapon")
+	float Damage{ 20.f };
+
+	UPROPERTY(EditDefaultsOnly, Category = "Weapon")
+	TSubclassOf<UDamageType> DamageType;
+
+	// 발사 사이 최소 간격, 서버가 이보다 빠른 요청은 버림
+	UPROPERTY(EditDefaultsOnly, Category = "Weapon")
+	float FireInterval{ 0.1f };
+
+	// 패킷이 몰려 도착해도 버리지 않는 발 수, 평균 연사 속도는 FireInterval 을 넘지 못함
+	UPROPERTY(EditDefaultsOnly, Category = "Weapon")
+	float MaxBurstShots{ 2.f };
+
+	// 0 이하면 탄약 제한 없음
+	UPROPERTY(EditDefaultsOnly, Category = "Weapon")
+	int32 MagazineSize{ 30 };
+
+	// 클라이언트가 보낸 시작점이 소유자 눈/총 위치에서 이만큼 넘게 떨어지면 이 거리로 당김
+	UPROPERTY(EditDefaultsOnly, Category = "Weapon")
+	float MaxStartOffset{ 150.f };
+
+private:
+	// 서버에서 발사 직전, 연사 예산과 탄약을 쓰고 못 쏘면 false
+	bool ConsumeServerShot();
+	// 소유자의 눈 위치와 무기 위치 중 가까운 쪽에서 MaxStartOffset 안으로 당김, 소유자가 없으면 false
+	bool ClampServerStart(FVector& Start) const;
+	void FireVolley(const FVector& Start, const FVector& Direction, double ShotServerTime);
+	void OnVolleyComplete(TConstArrayView<FHitResult> Hits);
+
+	// 발사마다 재사용
+	TArray<FVector> PelletEnds;
+
+	// 소유자만 알면 됨 (UI, 빈 탄창일때 클라이언트에서 요청 안 보내기)
+	UPROPERTY(Replicated)
+	int32 Ammo{ 0 };
+
+	// 서버: 지금 쏠 수 있는 발 수, FireInterval 마다 하나씩 MaxBurstShots 까지 참
+	float ServerShotBudget{ 0.f };
+	double LastServerShotTime{ 0.0 };
+};
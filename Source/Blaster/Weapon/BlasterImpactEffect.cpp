@@ -0,0 +1,17 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Weapon/BlasterImpactEffect.h"
+#include "Components/DecalComponent.h"
+
+ABlasterImpactEffect::ABlasterImpactEffect()
+{
+	SetRootComponent(CreateDefaultSubobject<USceneComponent>(TEXT("Root")));
+
+	Decal = CreateDefaultSubobject<UDecalComponent>(TEXT("Decal"));
+	Decal->SetupAttachment(RootComponent);
+	Decal->DecalSize = FVector(8.f, 16.f, 16.f);
+
+	bReplicates = false;
+	LifeSeconds = 2.f;
+}
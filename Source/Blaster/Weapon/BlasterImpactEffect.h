@@ -0,0 +1,25 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Pool/BlasterPooledActor.h"
+#include "BlasterImpactEffect.generated.h"
+
+class UDecalComponent;
+
+/**
+ * 충돌 이펙트/데칼, 복제하지 않고 각 머신의 로컬 풀에서 꺼내 씀
+ * 파티클, 사운드는 블루프린트에서 On Pool Activated 때 재생
+ */
+UCLASS()
+class BLASTER_API ABlasterImpactEffect : public ABlasterPooledActor
+{
+	GENERATED_BODY()
+public:
+	ABlasterImpactEffect();
+
+protected:
+	UPROPERTY(VisibleAnywhere)
+	UDecalComponent* Decal;
+};
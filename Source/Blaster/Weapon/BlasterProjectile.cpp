@@ -0,0 +1,84 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Weapon/BlasterProjectile.h"
+#include "Weapon/BlasterImpactEffect.h"
+#include "Pool/BlasterActorPoolSubsystem.h"
+#include "Components/SphereComponent.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+
+ABlasterProjectile::ABlasterProjectile()
+{
+	CollisionSphere = CreateDefaultSubobject<USphereComponent>(TEXT("CollisionSphere"));
+	CollisionSphere->InitSphereRadius(5.f);
+	CollisionSphere->SetCollisionProfileName(TEXT("BlockAllDynamic"));
+	SetRootComponent(CollisionSphere);
+
+	ProjectileMovement = CreateDefaultSubobject<UProjectileMovementComponent>(TEXT("ProjectileMovement"));
+	ProjectileMovement->SetAutoActivate(false);
+	ProjectileMovement->InitialSpeed = 15000.f;
+	ProjectileMovement->MaxSpeed = 15000.f;
+	ProjectileMovement->ProjectileGravityScale = 0.f;
+	ProjectileMovement->bRotationFollowsVelocity = true;
+
+	bReplicates = true;
+	//위치는 복제하지 않음, 활성화때 받은 위치/방향으로 각자 시뮬레이션
+	SetReplicateMovement(false);
+	LifeSeconds = 3.f;
+	ImpactClass = ABlasterImpactEffect::StaticClass();
+}
+
+void ABlasterProjectile::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (HasAuthority())
+	{
+		CollisionSphere->OnComponentHit.AddDynamic(this, &ABlasterProjectile::OnHit);
+	}
+}
+
+void ABlasterProjectile::OnPoolActivated()
+{
+	Super::OnPoolActivated();
+
+	CollisionSphere->ClearMoveIgnoreActors();
+	if (APawn* InstigatorPawn = GetInstigator())
+	{
+		CollisionSphere->IgnoreActorWhenMoving(InstigatorPawn, true);
+	}
+	ProjectileMovement->SetUpdatedComponent(CollisionSphere);
+	ProjectileMovement->Velocity = GetActorForwardVector() * ProjectileMovement->InitialSpeed;
+	ProjectileMovement->Activate(true);
+}
+
+void ABlasterProjectile::OnPoolDeactivated()
+{
+	ProjectileMovement->StopMovementImmediately();
+	ProjectileMovement->Deactivate();
+
+	Super::OnPoolDeactivated();
+
+	const FBlasterPoolActivation& Activation = GetPoolActivation();
+	if ((Activation.Flags & ImpactFlag) == 0 || ImpactClass == nullptr || GetNetMode() == NM_DedicatedServer)
+	{
+		return;
+	}
+	if (UBlasterActorPoolSubsystem* Pool = GetWorld()->GetSubsystem<UBlasterActorPoolSubsystem>())
+	{
+		//데칼은 X 축으로 투영되므로 표면 안쪽을 보게
+		Pool->AcquireActor(ImpactClass, Activation.Location, -Activation.Direction);
+	}
+}
+
+void ABlasterProjectile::OnHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComponent, FVector NormalImpulse, const FHitResult& Hit)
+{
+	if (!IsPoolActive())
+	{
+		return;
+	}
+
+	ReceiveProjectileHit(OtherActor, Hit);
+	SetDeactivationPayload(ImpactFlag, Hit.ImpactPoint, Hit.ImpactNormal);
+	ReturnToPool();
+}
@@ -0,0 +1,48 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Pool/BlasterPooledActor.h"
+#include "BlasterProjectile.generated.h"
+
+class USphereComponent;
+class UProjectileMovementComponent;
+
+/**
+ * 풀링되는 발사체. 무기는 UBlasterActorPoolSubsystem::Acquire 로 꺼내서 쏨
+ * 서버는 충돌하면 충돌 위치를 비활성화 값에 실어 풀로 돌려보내고,
+ * 각 머신은 그 비활성화를 보고 로컬 풀에서 ImpactClass 를 꺼내 보여줌
+ */
+UCLASS()
+class BLASTER_API ABlasterProjectile : public ABlasterPooledActor
+{
+	GENERATED_BODY()
+public:
+	ABlasterProjectile();
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void OnPoolActivated() override;
+	virtual void OnPoolDeactivated() override;
+
+	// 서버에서 충돌했을때, 데미지는 여기서 처리
+	UFUNCTION(BlueprintImplementableEvent, meta = (DisplayName = "On Projectile Hit"))
+	void ReceiveProjectileHit(AActor* OtherActor, const FHitResult& Hit);
+
+	// 복제되지 않는 ABlasterPooledActor 여야 함
+	UPROPERTY(EditDefaultsOnly, Category = "Projectile")
+	TSubclassOf<ABlasterPooledActor> ImpactClass;
+
+	UPROPERTY(VisibleAnywhere)
+	USphereComponent* CollisionSphere;
+
+	UPROPERTY(VisibleAnywhere)
+	UProjectileMovementComponent* ProjectileMovement;
+
+private:
+	UFUNCTION()
+	void OnHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComponent, FVector NormalImpulse, const FHitResult& Hit);
+
+	static constexpr uint8 ImpactFlag = 1 << 0;
+};